@@ -119,19 +119,16 @@ logLocation (const Ptr<Constellation> &constellation)
 {
   NS_LOG_FUNCTION (constellation);
 
+  const auto &positions = constellation->GetPositions ();
   for (std::size_t plane = 0; plane < constellation->GetNPlanes (); plane++)
     {
       for (std::size_t index = 0; index < constellation->GetPlaneSize (); index++)
         {
-          const auto &sat = constellation->GetSatellite (plane, index);
-          const auto &mobility = sat->GetNode ()->GetObject<CircularOrbitMobilityModel> ();
+          const auto &position = positions[plane * constellation->GetPlaneSize () + index];
 
-          NS_ASSERT (mobility != nullptr);
           NS_LOG_DEBUG ("Satellite: ("
-                        << plane << ", " << index << ") is at: " << mobility->GetPosition ()
-                        << " i.e., "
-                        << CartesianToGeographicCoordinates (mobility->GetPosition (),
-                                                             GeographicPositions::WGS84));
+                        << plane << ", " << index << ") is at: " << position << " i.e., "
+                        << CartesianToGeographicCoordinates (position, GeographicPositions::WGS84));
         }
     }
 
@@ -277,15 +277,7 @@ GeoTagStrategy::getRemoteNetDevice (face::Face &face)
   auto netDevice = getNetDevice (face)->GetObject<ns3::icarus::SatNetDevice> ();
   if (netDevice != nullptr)
     {
-      auto channel = netDevice->GetChannel ();
-      if (channel->GetDevice (0) == netDevice)
-        {
-          return channel->GetDevice (1);
-        }
-      else
-        {
-          return channel->GetDevice (0);
-        }
+      return netDevice->GetRemoteDevice ();
     }
   else
     {
@@ -27,6 +27,7 @@
 #include "ns3/sat-net-device.h"
 #include "ns3/log-macros-enabled.h"
 #include "ns3/sat2sat-channel.h"
+#include "ns3/isl-fabric.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/names.h"
@@ -46,7 +47,7 @@ namespace icarus {
 
 NS_LOG_COMPONENT_DEFINE ("icarus.ISLHelper");
 
-ISLHelper::ISLHelper ()
+ISLHelper::ISLHelper () : m_useFabric (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -122,6 +123,14 @@ ISLHelper::SetChannelAttribute (const std::string &n1, const AttributeValue &v1)
   m_channelFactory.Set (n1, v1);
 }
 
+void
+ISLHelper::SetUseFabric (bool useFabric)
+{
+  NS_LOG_FUNCTION (this << useFabric);
+
+  m_useFabric = useFabric;
+}
+
 NetDeviceContainer
 ISLHelper::Install (const NodeContainer &c, ConstellationHelper &chelper)
 {
@@ -152,6 +161,25 @@ ISLHelper::Install (const NodeContainer &c, ConstellationHelper &chelper)
   const auto nPlanes = constellation->GetNPlanes ();
   const auto nNodesPerPlane = constellation->GetPlaneSize ();
 
+  Ptr<IslFabric> fabric = nullptr;
+  if (m_useFabric)
+    {
+      fabric = CreateObject<IslFabric> ();
+      fabric->SetTopology (nPlanes, nNodesPerPlane);
+      fabric->SetAttribute ("TxSuccess",
+                            PointerValue (m_successModelFactory.Create<Sat2SatSuccessModel> ()));
+      fabric->SetAttribute (
+          "PropDelayModel",
+          PointerValue (m_propDelayModelFactory.Create ()->GetObject<PropagationDelayModel> ()));
+    }
+  const auto installLink = [this, &devices, &fabric] (Ptr<Node> a, Ptr<Node> b, uint32_t plane,
+                                                      uint32_t index,
+                                                      IslFabric::Direction direction) {
+    devices.Add (fabric != nullptr
+                     ? InstallPriv (a, b, fabric, fabric->GetSlot (plane, index, direction))
+                     : Install (a, b));
+  };
+
   for (uint32_t i = 0; i < nPlanes; ++i)
     {
       for (uint32_t j = 0; j < nNodesPerPlane; ++j)
@@ -163,21 +191,21 @@ ISLHelper::Install (const NodeContainer &c, ConstellationHelper &chelper)
             {
               Ptr<Sat2GroundNetDevice> nd2 = constellation->GetSatellite (i, j + 1);
               Ptr<Node> n2 = nd2->GetNode ();
-              devices.Add (Install (n1, n2));
+              installLink (n1, n2, i, j, IslFabric::NEXT_IN_PLANE);
             }
           else if (j == nNodesPerPlane - 1 && j != 0 && j != 1) // We avoid creating one loop
             // (in case of only one node per plane) and double links (in case of only two nodes per plane)
             {
               Ptr<Sat2GroundNetDevice> nd2 = constellation->GetSatellite (i, 0);
               Ptr<Node> n2 = nd2->GetNode ();
-              devices.Add (Install (n1, n2));
+              installLink (n1, n2, i, j, IslFabric::NEXT_IN_PLANE);
             }
           // Install inter-plane links
           if (i < nPlanes - 1)
             {
               Ptr<Sat2GroundNetDevice> nd2 = constellation->GetSatellite (i + 1, j);
               Ptr<Node> n2 = nd2->GetNode ();
-              devices.Add (Install (n1, n2));
+              installLink (n1, n2, i, j, IslFabric::NEXT_PLANE);
             }
           else if (i == nPlanes - 1 && i != 0 &&
                    i != 1) // We avoid creating one loop (in case of only one plane) and
@@ -185,7 +213,7 @@ ISLHelper::Install (const NodeContainer &c, ConstellationHelper &chelper)
             {
               Ptr<Sat2GroundNetDevice> nd2 = constellation->GetSatellite (0, j);
               Ptr<Node> n2 = nd2->GetNode ();
-              devices.Add (Install (n1, n2));
+              installLink (n1, n2, i, j, IslFabric::NEXT_PLANE);
             }
         }
     }
@@ -224,11 +252,38 @@ ISLHelper::InstallPriv (Ptr<Node> node, Ptr<Sat2SatChannel> channel) const
 {
   NS_LOG_FUNCTION (this << node << channel);
 
+  Ptr<SatNetDevice> device = CreateDevice (node);
+  device->Attach (channel);
+
+  return device;
+}
+
+NetDeviceContainer
+ISLHelper::InstallPriv (Ptr<Node> a, Ptr<Node> b, Ptr<IslFabric> fabric, std::size_t slot) const
+{
+  NS_LOG_FUNCTION (this << a << b << fabric << slot);
+
+  NetDeviceContainer devices;
+
+  Ptr<SatNetDevice> deviceA = CreateDevice (a);
+  deviceA->Attach (fabric, slot);
+  devices.Add (deviceA);
+  Ptr<SatNetDevice> deviceB = CreateDevice (b);
+  deviceB->Attach (fabric, fabric->GetPeerSlot (slot));
+  devices.Add (deviceB);
+
+  return devices;
+}
+
+Ptr<SatNetDevice>
+ISLHelper::CreateDevice (Ptr<Node> node) const
+{
+  NS_LOG_FUNCTION (this << node);
+
   Ptr<SatNetDevice> device = m_satNetDeviceFactory.Create<SatNetDevice> ();
   node->AddDevice (device);
   auto queue = m_queueFactory.Create<Queue<Packet>> ();
   device->SetQueue (queue);
-  device->Attach (channel);
   // Aggregate a NetDeviceQueueInterface object
   Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
   ndqi->GetTxQueue (0)->ConnectQueueTraces (queue);
@@ -419,12 +474,8 @@ ISLHelper::SatNetDeviceCallback (Ptr<Node> node, Ptr<ndn::L3Protocol> ndn, Ptr<N
   NS_ASSERT (netDevice != nullptr);
 
   // access the other end of the link
-  Ptr<Sat2SatChannel> channel = DynamicCast<Sat2SatChannel> (netDevice->GetChannel ());
-  NS_ASSERT (channel != nullptr);
-
-  Ptr<NetDevice> remoteNetDevice = channel->GetDevice (0);
-  if (remoteNetDevice->GetNode () == node)
-    remoteNetDevice = channel->GetDevice (1);
+  Ptr<NetDevice> remoteNetDevice = netDevice->GetRemoteDevice ();
+  NS_ASSERT (remoteNetDevice != nullptr);
 
   // Create an ndnSIM-specific transport instance
   ::nfd::face::GenericLinkService::Options opts;
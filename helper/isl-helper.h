@@ -25,6 +25,7 @@
 
 #include "ns3/simple-ref-count.h"
 #include "ns3/trace-helper.h"
+#include "ns3/isl-fabric.h"
 #include "ns3/sat2sat-channel.h"
 #include "ns3/sat-net-device.h"
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
@@ -125,6 +126,16 @@ public:
    */
   void SetChannelAttribute (const std::string &n1, const AttributeValue &v1);
 
+  /**
+   * \param useFabric whether to connect the whole constellation through a single channel
+   *
+   * When set, ISLHelper::Install (const NodeContainer &, ConstellationHelper &) attaches all the
+   * devices to a single ns3::icarus::IslFabric, with one success model and one propagation delay
+   * model, instead of creating a ns3::icarus::Sat2SatChannel for every link. Channel attributes
+   * are not applied to the fabric.
+   */
+  void SetUseFabric (bool useFabric);
+
   void FixNdnStackHelper (ndn::StackHelper &sh);
 
   /**
@@ -133,7 +144,10 @@ public:
    * container: it creates an ns3::icarus::SatNetDevice (with the attributes
    * configured by ISLHelper::SetDeviceAttribute); adds the device to the node; and
    * attaches the four channels.
-   * 
+   *
+   * If ISLHelper::SetUseFabric was enabled, the devices are attached to their slots of a single
+   * ns3::icarus::IslFabric instead.
+   *
    * @param c The NodeContainer holding the nodes to be changed
    * @param chelper The constellation helper
    * @return NetDeviceContainer 
@@ -200,6 +214,15 @@ private:
    */
   Ptr<NetDevice> InstallPriv (Ptr<Node> node, Ptr<Sat2SatChannel> channel) const;
 
+  /**
+   * Create the devices at both ends of the link of a fabric that starts at slot.
+   */
+  NetDeviceContainer InstallPriv (Ptr<Node> a, Ptr<Node> b, Ptr<IslFabric> fabric,
+                                  std::size_t slot) const;
+
+  // Create and attach the device common to both kinds of channel
+  Ptr<SatNetDevice> CreateDevice (Ptr<Node> node) const;
+
   std::string constructFaceUri (Ptr<NetDevice> netDevice);
 
   std::shared_ptr<nfd::face::Face> SatNetDeviceCallback (Ptr<Node> node, Ptr<ndn::L3Protocol> ndn,
@@ -210,6 +233,7 @@ private:
   ObjectFactory m_channelFactory; //!< factory for the channel
   ObjectFactory m_successModelFactory; //!> factory for the success models
   ObjectFactory m_propDelayModelFactory; //!> factory for the propagation delay models
+  bool m_useFabric; //!> whether to install a single fabric for the whole constellation
 };
 
 } // namespace icarus
@@ -18,6 +18,7 @@
  * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
  */
 #include "circular-orbit.h"
+#include "constellation.h"
 
 #include "ns3/assert.h"
 #include "ns3/log-macros-disabled.h"
@@ -64,6 +65,9 @@ constexpr quantity<length> EARTH_RADIUS = Earth.getRadius ();
 constexpr quantity<length> EARTH_SEMIMAJOR_AXIS = 6378137 * meters;
 constexpr double EARTH_GRS80_ECCENTRICITY = 0.0818191910428158;
 constexpr double EARTH_WGS84_ECCENTRICITY = 0.0818191908426215;
+// Difference between our Earth radius and the one of GeographicPositions::SPHERE
+constexpr double SPHERE_RADIUS_OFFSET = EARTH_RADIUS.value () - 6371e3;
+
 // ndnSIM-29 version of ns-3 lacks this method. Copy it here.
 std::pair<quantity<plane_angle>, quantity<plane_angle>>
 CartesianToGeographicCoordinates (Vector pos, GeographicPositions::EarthSpheroidType sphType)
@@ -136,7 +140,8 @@ CartesianToGeographicCoordinates (Vector pos, GeographicPositions::EarthSpheroid
 }
 } // namespace
 
-CircularOrbitMobilityModel::CircularOrbitMobilityModel () : MobilityModel (), sat (nullptr)
+CircularOrbitMobilityModel::CircularOrbitMobilityModel ()
+    : MobilityModel (), sat (nullptr), m_ephemeris (nullptr), m_ephemerisSlot (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -191,17 +196,82 @@ CircularOrbitMobilityModel::DoGetPosition () const
 {
   NS_LOG_FUNCTION (this);
 
-  Vector rawPosition{getRawPosition ()};
-  const auto radius{rawPosition.GetLength ()};
-  const auto latitude{radian * asin (rawPosition.z / radius)};
-  const auto prime_meridian_ascension{0.0 * radian + second * ns3::Simulator::Now ().GetSeconds () *
-                                                         Earth.getRotationRate ()};
-  const auto sat_ascension{radian * atan2 (rawPosition.y, rawPosition.x)};
-
-  return GeographicPositions::GeographicToCartesianCoordinates (
-      quantity<degree::plane_angle> (latitude).value (),
-      quantity<degree::plane_angle> (sat_ascension - prime_meridian_ascension).value (),
-      radius - Earth.getRadius ().value (), GeographicPositions::SPHERE);
+  if (m_ephemeris != nullptr)
+    {
+      return m_ephemeris->GetCachedPosition (m_ephemerisSlot);
+    }
+
+  return computePosition ();
+}
+
+Vector
+CircularOrbitMobilityModel::computePosition () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return toEarthFixed (getRawPosition (), Simulator::Now ());
+}
+
+Vector
+CircularOrbitMobilityModel::getPositionAt (Time t) const
+{
+  NS_LOG_FUNCTION (this << t);
+  NS_ABORT_IF (sat == nullptr);
+
+  meters x, y, z;
+  std::tie (x, y, z) = sat->getCartesianPositionRightAscensionDeclination (t.GetSeconds () * seconds);
+
+  return toEarthFixed (Vector (x.value (), y.value (), z.value ()), t);
+}
+
+CircularOrbitMobilityModel::EarthRotation
+CircularOrbitMobilityModel::getEarthRotation (Time t) noexcept
+{
+  const quantity<plane_angle> prime_meridian_ascension{second * t.GetSeconds () *
+                                                       Earth.getRotationRate ()};
+
+  return {t, std::cos (prime_meridian_ascension.value ()),
+          std::sin (prime_meridian_ascension.value ())};
+}
+
+Vector
+CircularOrbitMobilityModel::toEarthFixed (const Vector &rawPosition, Time t)
+{
+  return toEarthFixed (rawPosition, getEarthRotation (t));
+}
+
+Vector
+CircularOrbitMobilityModel::toEarthFixed (const Vector &rawPosition,
+                                          const EarthRotation &rotation) noexcept
+{
+  // This is a rotation about Z of the prime meridian ascension. The original implementation went
+  // through GeographicPositions::GeographicToCartesianCoordinates on a spherical Earth, which
+  // uses a slightly smaller radius than ours, so keep the same offset in the final radius.
+  const auto radius = rawPosition.GetLength ();
+  const auto scale = radius > 0 ? (radius - SPHERE_RADIUS_OFFSET) / radius : 0.0;
+
+  return Vector (scale * (rotation.cos * rawPosition.x + rotation.sin * rawPosition.y),
+                 scale * (rotation.cos * rawPosition.y - rotation.sin * rawPosition.x),
+                 scale * rawPosition.z);
+}
+
+const CircularOrbitMobilityModelImpl &
+CircularOrbitMobilityModel::getOrbit () const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_IF (sat == nullptr);
+
+  return *sat;
+}
+
+void
+CircularOrbitMobilityModel::setEphemeris (const Constellation *constellation,
+                                          std::size_t slot) noexcept
+{
+  NS_LOG_FUNCTION (this << constellation << slot);
+
+  m_ephemeris = constellation;
+  m_ephemerisSlot = slot;
 }
 
 double
@@ -236,7 +306,14 @@ CircularOrbitMobilityModel::getSatElevation (Vector groundPosition) const noexce
 {
   NS_LOG_FUNCTION (this << groundPosition);
 
-  const Vector ground2Sat (GetPosition () - groundPosition);
+  return getSatElevation (GetPosition (), groundPosition);
+}
+
+CircularOrbitMobilityModel::radians
+CircularOrbitMobilityModel::getSatElevation (const Vector &satPosition,
+                                             const Vector &groundPosition) noexcept
+{
+  const Vector ground2Sat (satPosition - groundPosition);
 
   const auto dotProduct = groundPosition.x * ground2Sat.x + groundPosition.y * ground2Sat.y +
                           groundPosition.z * ground2Sat.z;
@@ -253,6 +330,12 @@ CircularOrbitMobilityModel::getSatElevation (Vector groundPosition) const noexce
   return elevation;
 }
 
+std::pair<CircularOrbitMobilityModel::radians, CircularOrbitMobilityModel::radians>
+CircularOrbitMobilityModel::getGeographicPosition (const Vector &position)
+{
+  return CartesianToGeographicCoordinates (position, GeographicPositions::WGS84);
+}
+
 ns3::Time
 CircularOrbitMobilityModel::getNextTimeAtDistance (meters distance, Ptr<Node> ground,
                                                    boost::optional<Time> t0) const noexcept
@@ -266,7 +349,7 @@ CircularOrbitMobilityModel::getNextTimeAtDistance (meters distance, Ptr<Node> gr
   const quantity<si::time> init_time = (t0 ? *t0 : Simulator::Now ()).GetSeconds () * si::seconds;
 
   const Vector pos (groundmodel->GetPosition ());
-  const auto angular_pos = CartesianToGeographicCoordinates (pos, GeographicPositions::WGS84);
+  const auto angular_pos = getGeographicPosition (pos);
 
   return Seconds (sat->getNextTimeAtDistance (init_time, distance, angular_pos.first,
                                               angular_pos.second,
@@ -303,7 +386,7 @@ CircularOrbitMobilityModel::tryGetNextTimeAtDistance (meters distance, Ptr<Node>
   const quantity<si::time> init_time = (t0 ? *t0 : Simulator::Now ()).GetSeconds () * si::seconds;
 
   const Vector pos (groundmodel->GetPosition ());
-  const auto angular_pos = CartesianToGeographicCoordinates (pos, GeographicPositions::WGS84);
+  const auto angular_pos = getGeographicPosition (pos);
 
   auto sol =
       sat->tryGetNextTimeAtDistance (init_time, distance, angular_pos.first, angular_pos.second,
@@ -29,6 +29,7 @@
 #include <boost/units/systems/si/plane_angle.hpp>
 #include <boost/units/systems/si/length.hpp>
 #include <memory>
+#include <utility>
 
 namespace ns3 {
 
@@ -36,6 +37,7 @@ class Node;
 namespace icarus {
 
 class CircularOrbitMobilityModelImpl;
+class Constellation;
 /**
  * \ingroup icarus
  *
@@ -46,6 +48,12 @@ class CircularOrbitMobilityModel : public MobilityModel
 public:
   typedef boost::units::quantity<boost::units::si::plane_angle> radians;
   typedef boost::units::quantity<boost::units::si::length> meters;
+  // Rotation about Z from raw to Earth fixed coordinates at a given time
+  struct EarthRotation
+  {
+    Time time;
+    double cos, sin;
+  };
   /**
    * Register this type with the TypeId system.
    * \return the object TypeId
@@ -58,10 +66,25 @@ public:
   void LaunchSat (radians inclination, radians ascending_node, meters altitude, radians phase);
   // Get the position without planet rotation correction
   Vector getRawPosition () const;
+  // Get the current position without looking at the constellation ephemeris cache
+  Vector computePosition () const;
+  // Earth fixed position at an arbitrary time t, also bypassing the ephemeris cache
+  Vector getPositionAt (Time t) const;
+  // Rotate a raw position at time t to Earth fixed coordinates
+  static Vector toEarthFixed (const Vector &rawPosition, Time t);
+  // Same, with a rotation computed by the caller, which can share it among several positions
+  static Vector toEarthFixed (const Vector &rawPosition, const EarthRotation &rotation) noexcept;
+  static EarthRotation getEarthRotation (Time t) noexcept;
+  const CircularOrbitMobilityModelImpl &getOrbit () const;
+  // Serve positions from the ephemeris cache of constellation (if not null) at slot
+  void setEphemeris (const Constellation *constellation, std::size_t slot) noexcept;
   double getRadius () const noexcept;
   double getGroundDistanceAtElevation (radians elevation, meters ground_radius) const noexcept;
   Time getOrbitalPeriod () const noexcept;
   radians getSatElevation (Vector groundPosition) const noexcept;
+  static radians getSatElevation (const Vector &satPosition, const Vector &groundPosition) noexcept;
+  // WGS84 latitude and longitude of an Earth fixed position
+  static std::pair<radians, radians> getGeographicPosition (const Vector &position);
   ns3::Time getNextTimeAtDistance (meters distance, Ptr<Node> ground,
                                    boost::optional<ns3::Time> t0 = {}) const noexcept;
   ns3::Time getNextTimeAtElevation (radians elevation, Ptr<Node> ground,
@@ -80,6 +103,9 @@ private:
   virtual Vector DoGetVelocity (void) const;
 
   std::unique_ptr<CircularOrbitMobilityModelImpl> sat;
+
+  const Constellation *m_ephemeris;
+  std::size_t m_ephemerisSlot;
 };
 } // namespace icarus
 } // namespace ns3
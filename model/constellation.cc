@@ -20,6 +20,12 @@
 
 #include "constellation.h"
 #include "circular-orbit.h"
+#include "handover-scheduler.h"
+#include "orbit/batch-propagator.h"
+#include "orbit/circular-orbit-impl.h"
+#include "orbit/satpos/planet.h"
+#include "spatial/kd-tree.h"
+#include "spatial/walker-lookup.h"
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
@@ -29,7 +35,10 @@
 #include "ns3/net-device-container.h"
 #include "ns3/sat-address.h"
 #include "ns3/sat2ground-net-device.h"
+#include "ns3/simulator.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 namespace ns3 {
@@ -54,7 +63,23 @@ Constellation::Constellation (std::size_t n_planes, std::size_t plane_size)
       m_nPlanes (n_planes),
       m_planeSize (plane_size),
       m_planes (n_planes),
-      m_size (0)
+      m_size (0),
+      m_orbits (n_planes * plane_size),
+      m_propagator (std::make_unique<BatchPropagator> (n_planes * plane_size)),
+      m_positions (n_planes * plane_size),
+      m_positionTimes (n_planes * plane_size, Time::Min ()),
+      m_snapshotTime (Time::Min ()),
+      m_rawX (n_planes * plane_size),
+      m_rawY (n_planes * plane_size),
+      m_rawZ (n_planes * plane_size),
+      m_rotation{Time::Min (), 1.0, 0.0},
+      m_index (std::make_unique<KdTree> ()),
+      m_indexTime (Time::Min ()),
+      m_indexMaxAge (Seconds (1)),
+      m_maxSpeed (0.0),
+      m_highestSlot (0),
+      m_queryMode (AUTOMATIC),
+      m_walkerChecked (false)
 {
   NS_LOG_FUNCTION (this << n_planes << plane_size);
 
@@ -64,6 +89,24 @@ Constellation::Constellation (std::size_t n_planes, std::size_t plane_size)
     }
 }
 
+Constellation::~Constellation ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (const auto &orbit : m_orbits)
+    {
+      if (orbit != nullptr)
+        {
+          orbit->setEphemeris (nullptr, 0);
+        }
+    }
+
+  if (m_handoverScheduler != nullptr)
+    {
+      m_handoverScheduler->Dispose ();
+    }
+}
+
 SatAddress
 Constellation::AddSatellite (std::size_t plane, std::size_t plane_order,
                              Ptr<Sat2GroundNetDevice> satellite)
@@ -72,8 +115,8 @@ Constellation::AddSatellite (std::size_t plane, std::size_t plane_order,
 
   NS_ABORT_MSG_IF (m_planes[plane][plane_order] != nullptr,
                    "There can be only on satellite in each orbital location");
-  NS_ABORT_MSG_UNLESS (satellite->GetNode ()->GetObject<CircularOrbitMobilityModel> () != nullptr,
-                       "A satellite must have a CircularOrbitMobilityModel");
+  const auto orbit = satellite->GetNode ()->GetObject<CircularOrbitMobilityModel> ();
+  NS_ABORT_MSG_UNLESS (orbit != nullptr, "A satellite must have a CircularOrbitMobilityModel");
 
   if (m_planes[plane][plane_order] == nullptr)
     {
@@ -82,6 +125,28 @@ Constellation::AddSatellite (std::size_t plane, std::size_t plane_order,
 
   m_planes[plane][plane_order] = satellite;
 
+  const std::size_t slot = plane * m_planeSize + plane_order;
+  m_orbits[slot] = orbit;
+  m_propagator->setOrbit (slot, orbit->getOrbit ());
+  m_positionTimes[slot] = Time::Min ();
+  m_snapshotTime = Time::Min ();
+  m_indexTime = Time::Min ();
+  m_walkerChecked = false;
+  orbit->setEphemeris (this, slot);
+
+  // Orbital speed plus the speed of the rotating frame at the orbit radius
+  const auto &impl = orbit->getOrbit ();
+  m_maxSpeed = std::max (
+      m_maxSpeed,
+      (impl.getMeanMotion ().value () +
+       ::icarus::satpos::planet::constants::Earth.getRotationRate ().value ()) *
+          impl.getRadius ().value ());
+  if (m_orbits[m_highestSlot] == nullptr ||
+      m_orbits[m_highestSlot]->getOrbit ().getRadius () < impl.getRadius ())
+    {
+      m_highestSlot = slot;
+    }
+
   return SatAddress (m_constellationId, plane, plane_order);
 }
 
@@ -90,31 +155,188 @@ Constellation::GetClosest (Vector3D cartesianCoordinates) const
 {
   NS_LOG_FUNCTION (this << cartesianCoordinates);
 
-  Ptr<Sat2GroundNetDevice> closest = nullptr;
-  auto sq_closest_distance = std::numeric_limits<double>::infinity ();
+  if (m_queryMode != INDEX)
+    {
+      const auto walker = GetWalkerLookup ();
+      NS_ABORT_MSG_IF (walker == nullptr && m_queryMode == WALKER,
+                       "The constellation does not follow a Walker delta pattern.");
+      if (walker != nullptr)
+        {
+          const auto slot = walker->closest (cartesianCoordinates, Simulator::Now ().GetSeconds ());
+          return m_planes[slot / m_planeSize][slot % m_planeSize];
+        }
+    }
+
+  const auto closest = GetClosestSlots (cartesianCoordinates, 1);
+  if (closest.empty ())
+    {
+      return nullptr;
+    }
 
-  NS_LOG_WARN ("FIXME: Replace this with a better algorithm.");
-  for (const auto &plane : m_planes)
+  return m_planes[closest.front ().second / m_planeSize][closest.front ().second % m_planeSize];
+}
+
+std::vector<Ptr<Sat2GroundNetDevice>>
+Constellation::GetKClosest (Vector3D cartesianCoordinates, std::size_t k) const
+{
+  NS_LOG_FUNCTION (this << cartesianCoordinates << k);
+
+  std::vector<Ptr<Sat2GroundNetDevice>> satellites;
+  for (const auto &candidate : GetClosestSlots (cartesianCoordinates, k))
+    {
+      satellites.push_back (
+          m_planes[candidate.second / m_planeSize][candidate.second % m_planeSize]);
+    }
+
+  return satellites;
+}
+
+std::vector<Constellation::VisibleSatellite>
+Constellation::GetVisible (Vector3D cartesianCoordinates,
+                           boost::units::quantity<boost::units::si::plane_angle> minElevation) const
+{
+  NS_LOG_FUNCTION (this << cartesianCoordinates << minElevation.value ());
+
+  std::vector<VisibleSatellite> visible;
+  if (m_size == 0)
+    {
+      return visible;
+    }
+
+  const auto &index = GetIndex ();
+  const auto drift = m_maxSpeed * (Simulator::Now () - m_indexTime).GetSeconds ();
+  // Slant range at minElevation to the highest orbit, by the law of cosines
+  const auto ground_radius = cartesianCoordinates.GetLength ();
+  const auto orbit_radius = m_orbits[m_highestSlot]->getRadius ();
+  const auto range =
+      std::sqrt (orbit_radius * orbit_radius -
+                 std::pow (ground_radius * std::cos (minElevation.value ()), 2)) -
+      ground_radius * std::sin (minElevation.value ());
+
+  std::vector<std::pair<double, std::size_t>> candidates;
+  index.withinRadius (cartesianCoordinates, range + drift, candidates);
+  std::sort (candidates.begin (), candidates.end (),
+             [] (const auto &a, const auto &b) { return a.second < b.second; });
+
+  for (const auto &candidate : candidates)
     {
-      for (const auto &sat_device : plane)
+      const auto elevation = CircularOrbitMobilityModel::getSatElevation (
+          GetCachedPosition (candidate.second), cartesianCoordinates);
+      if (elevation > minElevation)
         {
-          if (sat_device == nullptr)
-            {
-              continue;
-            }
+          visible.push_back (
+              {candidate.second / m_planeSize, candidate.second % m_planeSize, elevation});
+        }
+    }
+
+  return visible;
+}
+
+void
+Constellation::SetIndexMaxAge (Time maxAge)
+{
+  NS_LOG_FUNCTION (this << maxAge);
+
+  m_indexMaxAge = maxAge;
+}
+
+Time
+Constellation::GetIndexMaxAge () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_indexMaxAge;
+}
+
+void
+Constellation::SetQueryMode (QueryMode mode)
+{
+  NS_LOG_FUNCTION (this << mode);
+
+  m_queryMode = mode;
+}
 
-          const auto sq_distance =
-              getSqDistance (sat_device->GetNode ()->GetObject<MobilityModel> ()->GetPosition (),
-                             cartesianCoordinates);
-          if (sq_distance <= sq_closest_distance)
+Constellation::QueryMode
+Constellation::GetQueryMode () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_queryMode;
+}
+
+const WalkerLookup *
+Constellation::GetWalkerLookup () const
+{
+  if (!m_walkerChecked)
+    {
+      std::vector<const CircularOrbitMobilityModelImpl *> orbits;
+      for (const auto &orbit : m_orbits)
+        {
+          orbits.push_back (orbit != nullptr ? &orbit->getOrbit () : nullptr);
+        }
+
+      const auto walker = WalkerLookup::detect (orbits, m_nPlanes, m_planeSize);
+      m_walker = walker ? std::make_unique<WalkerLookup> (*walker) : nullptr;
+      m_walkerChecked = true;
+
+      NS_LOG_DEBUG ("Walker delta pattern " << (m_walker ? "found" : "not found"));
+    }
+
+  return m_walker.get ();
+}
+
+std::vector<std::pair<double, std::size_t>>
+Constellation::GetClosestSlots (const Vector &position, std::size_t k) const
+{
+  const auto &index = GetIndex ();
+  auto candidates = index.kNearest (position, k);
+  if (candidates.empty () || m_indexTime == Simulator::Now ())
+    {
+      return candidates;
+    }
+
+  // Satellites may have moved up to drift since the index was built. The true k-th closest
+  // satellite is at most drift farther than the indexed one, and any of the true k closest is at
+  // most drift closer in the index, so they all lie within the widened radius.
+  const auto drift = m_maxSpeed * (Simulator::Now () - m_indexTime).GetSeconds ();
+  const auto radius = std::sqrt (candidates.back ().first) + 2.0 * drift;
+
+  candidates.clear ();
+  index.withinRadius (position, radius, candidates);
+  for (auto &candidate : candidates)
+    {
+      candidate.first = getSqDistance (GetCachedPosition (candidate.second), position);
+    }
+
+  const auto n = std::min (k, candidates.size ());
+  std::partial_sort (candidates.begin (), candidates.begin () + n, candidates.end ());
+  candidates.resize (n);
+
+  return candidates;
+}
+
+const KdTree &
+Constellation::GetIndex () const
+{
+  const auto now = Simulator::Now ();
+  if (m_indexTime == Time::Min () || now < m_indexTime || now - m_indexTime > m_indexMaxAge)
+    {
+      NS_LOG_DEBUG ("Rebuilding the spatial index at " << now);
+
+      std::vector<std::size_t> slots;
+      for (std::size_t slot = 0; slot < m_orbits.size (); slot++)
+        {
+          if (m_orbits[slot] != nullptr)
             {
-              sq_closest_distance = sq_distance;
-              closest = sat_device;
+              slots.push_back (slot);
             }
         }
+
+      m_index->build (GetPositions (), slots);
+      m_indexTime = now;
     }
 
-  return closest;
+  return *m_index;
 }
 
 std::size_t
@@ -202,5 +424,85 @@ Constellation::Get (std::size_t index) const
   return m_planes[plane][plane_order];
 }
 
+const std::vector<Vector> &
+Constellation::GetPositions () const
+{
+  NS_LOG_FUNCTION (this);
+
+  const auto now = Simulator::Now ();
+  if (m_snapshotTime == now)
+    {
+      return m_positions;
+    }
+
+  m_propagator->propagate (now.GetSeconds (), m_rawX.data (), m_rawY.data (), m_rawZ.data ());
+  const auto &rotation = GetEarthRotation (now);
+  for (std::size_t slot = 0; slot < m_orbits.size (); slot++)
+    {
+      if (m_orbits[slot] != nullptr)
+        {
+          m_positions[slot] = CircularOrbitMobilityModel::toEarthFixed (
+              Vector (m_rawX[slot], m_rawY[slot], m_rawZ[slot]), rotation);
+          m_positionTimes[slot] = now;
+        }
+    }
+  m_snapshotTime = now;
+
+  return m_positions;
+}
+
+Vector
+Constellation::GetPosition (std::size_t plane, std::size_t index) const
+{
+  NS_LOG_FUNCTION (this << plane << index);
+
+  NS_ASSERT_MSG (plane < GetNPlanes (), "Plane " << plane << " is outside range");
+  NS_ASSERT_MSG (index < GetPlaneSize (), "Index " << index << " is outside range");
+  NS_ABORT_MSG_IF (m_orbits[plane * m_planeSize + index] == nullptr,
+                   "There is no satellite at (" << plane << ", " << index << ")");
+
+  return GetCachedPosition (plane * m_planeSize + index);
+}
+
+Ptr<HandoverScheduler>
+Constellation::GetHandoverScheduler () const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_handoverScheduler == nullptr)
+    {
+      m_handoverScheduler = CreateObject<HandoverScheduler> ();
+    }
+
+  return m_handoverScheduler;
+}
+
+const CircularOrbitMobilityModel::EarthRotation &
+Constellation::GetEarthRotation (Time t) const
+{
+  if (m_rotation.time != t)
+    {
+      m_rotation = CircularOrbitMobilityModel::getEarthRotation (t);
+    }
+
+  return m_rotation;
+}
+
+const Vector &
+Constellation::GetCachedPosition (std::size_t slot) const
+{
+  const auto now = Simulator::Now ();
+
+  if (m_positionTimes[slot] != now)
+    {
+      Vector raw;
+      m_propagator->propagate (slot, now.GetSeconds (), raw.x, raw.y, raw.z);
+      m_positions[slot] = CircularOrbitMobilityModel::toEarthFixed (raw, GetEarthRotation (now));
+      m_positionTimes[slot] = now;
+    }
+
+  return m_positions[slot];
+}
+
 } // namespace icarus
 } // namespace ns3
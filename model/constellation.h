@@ -20,11 +20,19 @@
 #ifndef CONSTELLATION_H
 #define CONSTELLATION_H
 
+#include "circular-orbit.h"
+
 #include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include "ns3/vector.h"
 
+#include <boost/units/quantity.hpp>
+#include <boost/units/systems/si/plane_angle.hpp>
+
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace ns3 {
@@ -32,16 +40,63 @@ namespace icarus {
 
 class SatAddress;
 class Sat2GroundNetDevice;
+class CircularOrbitMobilityModel;
+class BatchPropagator;
+class KdTree;
+class WalkerLookup;
+class HandoverScheduler;
 
 class Constellation : public SimpleRefCount<Constellation>
 {
 public:
+  struct VisibleSatellite
+  {
+    std::size_t plane, index;
+    boost::units::quantity<boost::units::si::plane_angle> elevation;
+  };
+
+  // How GetClosest finds the closest satellite
+  enum QueryMode {
+    AUTOMATIC, // WALKER if the constellation follows a Walker delta pattern, INDEX otherwise
+    INDEX, // Look up the spatial index
+    WALKER // Compute the candidates from the Walker delta geometry. Aborts for other patterns.
+  };
+
   Constellation (std::size_t n_planes, std::size_t plane_size);
   Constellation (const Constellation &) = delete;
+  ~Constellation ();
 
   SatAddress AddSatellite (std::size_t plane, std::size_t plane_order,
                            Ptr<Sat2GroundNetDevice> satellite);
   Ptr<Sat2GroundNetDevice> GetClosest (Vector3D cartesianCoordinates) const;
+  // The k satellites closest to cartesianCoordinates, closest first
+  std::vector<Ptr<Sat2GroundNetDevice>> GetKClosest (Vector3D cartesianCoordinates,
+                                                     std::size_t k) const;
+
+  /**
+   * \brief Satellites above minElevation as seen from cartesianCoordinates.
+   *
+   * Only the satellites within the footprint slant range, the distance to a satellite of the
+   * highest orbit at minElevation, are looked up in the spatial index and checked. The result is
+   * sorted by plane and index.
+   */
+  std::vector<VisibleSatellite>
+  GetVisible (Vector3D cartesianCoordinates,
+              boost::units::quantity<boost::units::si::plane_angle> minElevation) const;
+
+  /**
+   * \brief Maximum age of the spatial index used by the closest satellite queries.
+   *
+   * Rebuilding the index takes O(n log n), so it is reused while it is younger than this. Queries
+   * on an older index remain exact: they widen the search by the largest distance any satellite
+   * may have travelled since the index was built and check the candidates against their current
+   * position.
+   */
+  void SetIndexMaxAge (Time maxAge);
+  Time GetIndexMaxAge () const;
+
+  void SetQueryMode (QueryMode mode);
+  QueryMode GetQueryMode () const;
 
   std::size_t GetNPlanes () const;
   std::size_t GetPlaneSize () const;
@@ -53,7 +108,32 @@ public:
   std::size_t GetSize () const;
   Ptr<Sat2GroundNetDevice> Get (std::size_t index) const;
 
+  /**
+   * \brief Positions of all the satellites at the current simulation time.
+   *
+   * The result is indexed like Get (), i.e., plane * GetPlaneSize () + index. Empty orbital
+   * locations hold a null vector. Each satellite position is computed at most once for every
+   * simulation timestamp and shared with its mobility model. The whole snapshot is computed in a
+   * single batch pass over the orbital elements of the constellation.
+   */
+  const std::vector<Vector> &GetPositions () const;
+  Vector GetPosition (std::size_t plane, std::size_t index) const;
+
+  // Calendar of the tracking updates of the ground stations served by this constellation
+  Ptr<HandoverScheduler> GetHandoverScheduler () const;
+
 private:
+  friend class CircularOrbitMobilityModel;
+
+  // Ephemeris cache access for the satellites' own mobility models
+  const Vector &GetCachedPosition (std::size_t slot) const;
+  const CircularOrbitMobilityModel::EarthRotation &GetEarthRotation (Time t) const;
+  // Squared distances and slots of the k satellites closest to position, closest first
+  std::vector<std::pair<double, std::size_t>> GetClosestSlots (const Vector &position,
+                                                               std::size_t k) const;
+  const KdTree &GetIndex () const;
+  // The Walker delta lookup, if the constellation follows that pattern
+  const WalkerLookup *GetWalkerLookup () const;
   typedef std::vector<Ptr<Sat2GroundNetDevice>> plane;
 
   static std::size_t constellationCounter;
@@ -63,6 +143,31 @@ private:
   std::vector<plane> m_planes;
 
   std::size_t m_size;
+
+  // Ephemeris cache, flat indexed by plane * m_planeSize + index
+  std::vector<Ptr<CircularOrbitMobilityModel>> m_orbits;
+  std::unique_ptr<BatchPropagator> m_propagator;
+  mutable std::vector<Vector> m_positions;
+  mutable std::vector<Time> m_positionTimes;
+  mutable Time m_snapshotTime;
+  mutable std::vector<double> m_rawX, m_rawY, m_rawZ;
+  // The rotation to Earth fixed coordinates is shared by every satellite
+  mutable CircularOrbitMobilityModel::EarthRotation m_rotation;
+
+  // Spatial index over the positions at m_indexTime
+  std::unique_ptr<KdTree> m_index;
+  mutable Time m_indexTime;
+  Time m_indexMaxAge;
+  // Upper bound of the speed of any satellite in Earth fixed coordinates
+  double m_maxSpeed;
+  // Slot of the satellite with the highest orbit
+  std::size_t m_highestSlot;
+
+  QueryMode m_queryMode;
+  mutable std::unique_ptr<WalkerLookup> m_walker;
+  mutable bool m_walkerChecked;
+
+  mutable Ptr<HandoverScheduler> m_handoverScheduler;
 };
 } // namespace icarus
 } // namespace ns3
@@ -0,0 +1,541 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "contact-plan.h"
+
+#include "circular-orbit.h"
+#include "constellation.h"
+#include "orbit/circular-orbit-impl.h"
+#include "orbit/search/distancesolver.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/sat2ground-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <boost/units/systems/angle/degrees.hpp>
+#include <boost/units/systems/si/length.hpp>
+#include <boost/units/systems/si/plane_angle.hpp>
+#include <boost/units/systems/si/time.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.ContactPlan");
+
+NS_OBJECT_ENSURE_REGISTERED (ContactPlan);
+
+namespace {
+
+using namespace boost::units;
+
+// Bump whenever the file layout or the pass computation changes
+constexpr std::uint32_t FORMAT_VERSION = 2;
+constexpr char MAGIC[8] = {'I', 'C', 'A', 'R', 'U', 'S', 'C', 'P'};
+
+struct FileHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t reserved;
+  std::uint64_t hash;
+  std::uint64_t nPairs;
+  std::uint64_t nContacts;
+};
+
+// 64 bit FNV-1a
+class Hasher
+{
+public:
+  template <typename T>
+  Hasher &
+  operator<< (const T &value) noexcept
+  {
+    const auto bytes = reinterpret_cast<const unsigned char *> (&value);
+    for (std::size_t i = 0; i < sizeof (T); i++)
+      {
+        m_hash = (m_hash ^ bytes[i]) * 0x100000001b3ull;
+      }
+
+    return *this;
+  }
+
+  std::uint64_t
+  get () const noexcept
+  {
+    return m_hash;
+  }
+
+private:
+  std::uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+
+// First contact in [begin, end) starting after t. Contacts are stored as (aos, los) pairs.
+const double *
+FindNextContact (const double *begin, const double *end, double t) noexcept
+{
+  std::size_t low = 0, high = (end - begin) / 2;
+  while (low < high)
+    {
+      const auto middle = (low + high) / 2;
+      if (begin[2 * middle] <= t)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+
+  return begin + 2 * low;
+}
+
+struct GroundSite
+{
+  quantity<si::plane_angle> latitude, longitude;
+  quantity<si::length> radius;
+};
+
+} // namespace
+
+TypeId
+ContactPlan::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::icarus::ContactPlan")
+          .SetParent<Object> ()
+          .SetGroupName ("ICARUS")
+          .AddConstructor<ContactPlan> ()
+          .AddAttribute ("MinElevation", "The minimum elevation of a contact, in degrees",
+                         DoubleValue (25.0),
+                         MakeDoubleAccessor (&ContactPlan::SetMinElevation,
+                                             &ContactPlan::GetMinElevation),
+                         MakeDoubleChecker<double> (0.0, 90.0))
+          .AddAttribute ("Horizon", "How far in the future contacts are computed",
+                         TimeValue (Days (1)), MakeTimeAccessor (&ContactPlan::m_horizon),
+                         MakeTimeChecker (Seconds (0)))
+          .AddAttribute ("CacheDirectory",
+                         "Directory where contact plans are stored and looked up. Empty to "
+                         "disable the cache.",
+                         StringValue (""), MakeStringAccessor (&ContactPlan::m_cacheDirectory),
+                         MakeStringChecker ())
+          .AddAttribute ("Threads",
+                         "Number of threads computing the contacts. 0 to use all the cores.",
+                         UintegerValue (0), MakeUintegerAccessor (&ContactPlan::m_threads),
+                         MakeUintegerChecker<std::uint32_t> ());
+
+  return tid;
+}
+
+ContactPlan::ContactPlan ()
+    : m_begin (Seconds (0)),
+      m_end (Seconds (0)),
+      m_planeSize (0),
+      m_nSatellites (0),
+      m_offsets (nullptr),
+      m_contacts (nullptr),
+      m_mapping (nullptr),
+      m_mappingSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ContactPlan::~ContactPlan ()
+{
+  NS_LOG_FUNCTION (this);
+
+  Unmap ();
+}
+
+void
+ContactPlan::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Unmap ();
+  m_offsetStorage.clear ();
+  m_contactStorage.clear ();
+  m_groundIndex.clear ();
+  m_offsets = nullptr;
+  m_contacts = nullptr;
+
+  Object::DoDispose ();
+}
+
+void
+ContactPlan::SetMinElevation (double minElevation) noexcept
+{
+  NS_LOG_FUNCTION (this << minElevation);
+
+  m_minElevation = minElevation;
+}
+
+double
+ContactPlan::GetMinElevation () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_minElevation;
+}
+
+void
+ContactPlan::Compute (Ptr<const Constellation> constellation, const NodeContainer &groundNodes)
+{
+  NS_LOG_FUNCTION (this << constellation << groundNodes.GetN ());
+
+  m_begin = Simulator::Now ();
+  m_end = m_begin + m_horizon;
+  m_planeSize = constellation->GetPlaneSize ();
+  m_nSatellites = constellation->GetNPlanes () * m_planeSize;
+  m_groundIndex.clear ();
+
+  const quantity<si::plane_angle> elevation (m_minElevation * degree::degrees);
+
+  Hasher hasher;
+  hasher << FORMAT_VERSION << m_minElevation << m_begin.GetSeconds () << m_end.GetSeconds ()
+         << std::uint64_t (m_nSatellites) << std::uint64_t (groundNodes.GetN ());
+
+  std::vector<GroundSite> sites;
+  for (auto i = 0u; i < groundNodes.GetN (); i++)
+    {
+      const auto mmodel = groundNodes.Get (i)->GetObject<MobilityModel> ();
+      NS_ABORT_MSG_UNLESS (mmodel != nullptr, "Ground node lacks location information.");
+      const Vector pos = mmodel->GetPosition ();
+      const auto coordinates = CircularOrbitMobilityModel::getGeographicPosition (pos);
+
+      sites.push_back ({coordinates.first, coordinates.second, pos.GetLength () * si::meters});
+      m_groundIndex[groundNodes.Get (i)->GetId ()] = i;
+      hasher << pos.x << pos.y << pos.z;
+    }
+
+  // Keep copies of the orbits, so that worker threads do not touch any ns-3 object
+  std::vector<std::size_t> slots;
+  std::vector<CircularOrbitMobilityModelImpl> orbits;
+  for (auto slot = 0u; slot < m_nSatellites; slot++)
+    {
+      const auto satellite = constellation->GetSatellite (slot / m_planeSize, slot % m_planeSize);
+      if (satellite == nullptr)
+        {
+          hasher << false;
+          continue;
+        }
+
+      const auto &orbit =
+          satellite->GetNode ()->GetObject<CircularOrbitMobilityModel> ()->getOrbit ();
+      slots.push_back (slot);
+      orbits.push_back (orbit);
+      hasher << true << orbit.getInclination ().value () << orbit.getAscendingNode ().value ()
+             << orbit.getRadius ().value () << orbit.getPhase ().value ();
+    }
+
+  const std::size_t nPairs = sites.size () * m_nSatellites;
+  std::string path;
+  if (!m_cacheDirectory.empty ())
+    {
+      std::ostringstream name;
+      name << m_cacheDirectory << "/contact-plan-" << std::hex << std::setw (16)
+           << std::setfill ('0') << hasher.get () << ".bin";
+      path = name.str ();
+
+      if (Load (path, hasher.get (), nPairs))
+        {
+          NS_LOG_INFO ("Read " << GetNContacts () << " contacts from " << path);
+          return;
+        }
+    }
+
+  // Compute the passes of every (ground, satellite) pair in parallel
+  std::vector<std::vector<std::pair<double, double>>> passes (nPairs);
+  std::atomic<std::size_t> next{0};
+  const auto end = m_end.GetSeconds ();
+  const auto worker = [&] () {
+    for (auto job = next++; job < sites.size () * orbits.size (); job = next++)
+      {
+        const auto &site = sites[job / orbits.size ()];
+        const auto &orbit = orbits[job % orbits.size ()];
+        auto &result =
+            passes[(job / orbits.size ()) * m_nSatellites + slots[job % orbits.size ()]];
+
+        const auto contacts = orbit::findPasses (
+            m_begin.GetSeconds () * si::seconds, m_end.GetSeconds () * si::seconds, orbit,
+            orbit.getGroundDistanceAtElevation (elevation, site.radius), site.latitude,
+            site.longitude, site.radius);
+        for (const auto &contact : contacts)
+          {
+            // The passes are cut at the end of the horizon, where their loss of signal is unknown
+            const auto los = contact.second.value () < end
+                                 ? contact.second.value ()
+                                 : std::numeric_limits<double>::infinity ();
+            result.emplace_back (contact.first.value (), los);
+          }
+      }
+  };
+
+  const std::size_t nThreads = std::max<std::size_t> (
+      1, std::min<std::size_t> (m_threads ? m_threads : std::thread::hardware_concurrency (),
+                                sites.size () * orbits.size ()));
+  std::vector<std::thread> threads;
+  for (auto i = 1u; i < nThreads; i++)
+    {
+      threads.emplace_back (worker);
+    }
+  worker ();
+  for (auto &thread : threads)
+    {
+      thread.join ();
+    }
+
+  Unmap ();
+  m_offsetStorage.assign (1, 0);
+  m_offsetStorage.reserve (nPairs + 1);
+  m_contactStorage.clear ();
+  for (const auto &pair : passes)
+    {
+      for (const auto &contact : pair)
+        {
+          m_contactStorage.push_back (contact.first);
+          m_contactStorage.push_back (contact.second);
+        }
+      m_offsetStorage.push_back (m_contactStorage.size () / 2);
+    }
+  m_offsets = m_offsetStorage.data ();
+  m_contacts = m_contactStorage.data ();
+
+  NS_LOG_INFO ("Computed " << GetNContacts () << " contacts using " << nThreads << " threads");
+
+  if (!path.empty ())
+    {
+      Store (path, hasher.get ());
+    }
+}
+
+bool
+ContactPlan::Load (const std::string &path, std::uint64_t hash, std::size_t nPairs)
+{
+  NS_LOG_FUNCTION (this << path << hash << nPairs);
+
+  const int fd = open (path.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      return false;
+    }
+
+  struct stat info;
+  if (fstat (fd, &info) != 0 || std::size_t (info.st_size) < sizeof (FileHeader))
+    {
+      close (fd);
+      return false;
+    }
+
+  void *mapping = mmap (nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (mapping == MAP_FAILED)
+    {
+      return false;
+    }
+
+  FileHeader header;
+  std::memcpy (&header, mapping, sizeof (header));
+  const std::size_t expectedSize = sizeof (FileHeader) + (nPairs + 1) * sizeof (std::uint64_t) +
+                                   header.nContacts * 2 * sizeof (double);
+
+  if (std::memcmp (header.magic, MAGIC, sizeof (MAGIC)) != 0 ||
+      header.version != FORMAT_VERSION || header.hash != hash || header.nPairs != nPairs ||
+      std::size_t (info.st_size) != expectedSize)
+    {
+      NS_LOG_WARN ("Ignoring invalid contact plan file " << path);
+      munmap (mapping, info.st_size);
+      return false;
+    }
+
+  Unmap ();
+  m_offsetStorage.clear ();
+  m_contactStorage.clear ();
+  m_mapping = mapping;
+  m_mappingSize = info.st_size;
+  m_offsets = reinterpret_cast<const std::uint64_t *> (static_cast<const char *> (mapping) +
+                                                        sizeof (FileHeader));
+  m_contacts = reinterpret_cast<const double *> (m_offsets + nPairs + 1);
+
+  return true;
+}
+
+void
+ContactPlan::Store (const std::string &path, std::uint64_t hash) const
+{
+  NS_LOG_FUNCTION (this << path << hash);
+
+  FileHeader header{};
+  std::memcpy (header.magic, MAGIC, sizeof (MAGIC));
+  header.version = FORMAT_VERSION;
+  header.hash = hash;
+  header.nPairs = m_offsetStorage.size () - 1;
+  header.nContacts = m_contactStorage.size () / 2;
+
+  // Write to a temporary file first, so that concurrent runs never see a partial plan
+  const std::string tmpPath = path + "." + std::to_string (getpid ()) + ".tmp";
+  std::ofstream file (tmpPath, std::ios::binary | std::ios::trunc);
+  file.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  file.write (reinterpret_cast<const char *> (m_offsetStorage.data ()),
+              m_offsetStorage.size () * sizeof (std::uint64_t));
+  file.write (reinterpret_cast<const char *> (m_contactStorage.data ()),
+              m_contactStorage.size () * sizeof (double));
+  file.close ();
+
+  if (!file || std::rename (tmpPath.c_str (), path.c_str ()) != 0)
+    {
+      NS_LOG_WARN ("Could not store the contact plan in " << path);
+      std::remove (tmpPath.c_str ());
+    }
+}
+
+void
+ContactPlan::Unmap () noexcept
+{
+  if (m_mapping != nullptr)
+    {
+      munmap (m_mapping, m_mappingSize);
+      m_mapping = nullptr;
+      m_mappingSize = 0;
+      m_offsets = nullptr;
+      m_contacts = nullptr;
+    }
+}
+
+std::pair<const double *, const double *>
+ContactPlan::GetContacts (const Ptr<Node> &ground, std::size_t slot) const noexcept
+{
+  const auto row = m_groundIndex.find (ground->GetId ());
+  NS_ABORT_MSG_IF (row == m_groundIndex.end (), "Node " << ground->GetId ()
+                                                        << " is not part of the contact plan.");
+  NS_ASSERT (slot < m_nSatellites);
+
+  const auto pair = row->second * m_nSatellites + slot;
+
+  return std::make_pair (m_contacts + 2 * m_offsets[pair], m_contacts + 2 * m_offsets[pair + 1]);
+}
+
+bool
+ContactPlan::Covers (Time t) const noexcept
+{
+  NS_LOG_FUNCTION (this << t);
+
+  return m_offsets != nullptr && m_begin <= t && t < m_end;
+}
+
+const double *
+ContactPlan::FindCurrentContact (const Ptr<Node> &ground, std::size_t plane, std::size_t index,
+                                 Time t) const noexcept
+{
+  NS_ASSERT_MSG (Covers (t), "Time " << t << " is outside the contact plan.");
+
+  const auto contacts = GetContacts (ground, plane * m_planeSize + index);
+  const auto next = FindNextContact (contacts.first, contacts.second, t.GetSeconds ());
+
+  // Contacts are closed on the left, so that the loss of signal time is already out of sight
+  if (next != contacts.first && t.GetSeconds () < *(next - 1))
+    {
+      return next - 2;
+    }
+
+  return nullptr;
+}
+
+bool
+ContactPlan::IsVisible (const Ptr<Node> &ground, std::size_t plane, std::size_t index,
+                        Time t) const noexcept
+{
+  NS_LOG_FUNCTION (this << ground << plane << index << t);
+
+  return FindCurrentContact (ground, plane, index, t) != nullptr;
+}
+
+boost::optional<Time>
+ContactPlan::GetLos (const Ptr<Node> &ground, std::size_t plane, std::size_t index,
+                     Time t) const noexcept
+{
+  NS_LOG_FUNCTION (this << ground << plane << index << t);
+
+  const auto contact = FindCurrentContact (ground, plane, index, t);
+  if (contact != nullptr && std::isfinite (contact[1]))
+    {
+      return Seconds (contact[1]);
+    }
+
+  return {};
+}
+
+boost::optional<Time>
+ContactPlan::GetNextAos (const Ptr<Node> &ground, std::size_t plane, std::size_t index,
+                         Time t) const noexcept
+{
+  NS_LOG_FUNCTION (this << ground << plane << index << t);
+  NS_ASSERT_MSG (Covers (t), "Time " << t << " is outside the contact plan.");
+
+  const auto contacts = GetContacts (ground, plane * m_planeSize + index);
+  const auto next = FindNextContact (contacts.first, contacts.second, t.GetSeconds ());
+
+  if (next != contacts.second)
+    {
+      return Seconds (*next);
+    }
+
+  return {};
+}
+
+std::size_t
+ContactPlan::GetNContacts () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_offsets != nullptr ? m_offsets[m_groundIndex.size () * m_nSatellites] : 0;
+}
+
+bool
+ContactPlan::IsCached () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_mapping != nullptr;
+}
+
+} // namespace icarus
+} // namespace ns3
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef CONTACT_PLAN_H
+#define CONTACT_PLAN_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+
+#include <boost/optional/optional.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+class Constellation;
+
+/**
+ * \ingroup icarus
+ *
+ * \brief Table of the contacts between a set of ground stations and the satellites of a
+ * constellation.
+ *
+ * Compute () finds, for every (ground station, satellite) pair, the intervals during the next
+ * Horizon in which the satellite is above MinElevation, so visibility questions become a binary
+ * search instead of an orbit computation. The pairs are processed in parallel. If CacheDirectory
+ * is set, the table is stored there in a binary file named after a hash of the geometry, and later
+ * runs with the same constellation, ground stations and parameters just map that file.
+ *
+ * Ground stations must be static.
+ */
+class ContactPlan : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  ContactPlan ();
+  virtual ~ContactPlan ();
+
+  void Compute (Ptr<const Constellation> constellation, const NodeContainer &groundNodes);
+
+  // Whether t lies within the computed horizon
+  bool Covers (Time t) const noexcept;
+  bool IsVisible (const Ptr<Node> &ground, std::size_t plane, std::size_t index,
+                  Time t) const noexcept;
+  // Loss of signal of the contact in progress at t, if any. There is none for the contacts still in
+  // progress at the end of the horizon, even if the satellite is visible.
+  boost::optional<Time> GetLos (const Ptr<Node> &ground, std::size_t plane, std::size_t index,
+                                Time t) const noexcept;
+  // Acquisition of signal of the first contact starting after t, if any
+  boost::optional<Time> GetNextAos (const Ptr<Node> &ground, std::size_t plane,
+                                    std::size_t index, Time t) const noexcept;
+
+  std::size_t GetNContacts () const noexcept;
+  // Whether the table was read from the cache directory
+  bool IsCached () const noexcept;
+
+  void SetMinElevation (double minElevation) noexcept;
+  double GetMinElevation () const noexcept;
+
+private:
+  virtual void DoDispose (void) override;
+
+  // Contact intervals of a pair as (aos, los) in seconds, sorted by aos. The los of the contacts
+  // cut at the end of the horizon is infinite.
+  std::pair<const double *, const double *> GetContacts (const Ptr<Node> &ground,
+                                                         std::size_t slot) const noexcept;
+  // The (aos, los) pair of the contact in progress at t, or nullptr
+  const double *FindCurrentContact (const Ptr<Node> &ground, std::size_t plane, std::size_t index,
+                                    Time t) const noexcept;
+  bool Load (const std::string &path, std::uint64_t hash, std::size_t nPairs);
+  void Store (const std::string &path, std::uint64_t hash) const;
+  void Unmap () noexcept;
+
+  double m_minElevation;
+  Time m_horizon;
+  std::string m_cacheDirectory;
+  std::uint32_t m_threads;
+
+  Time m_begin, m_end;
+  std::size_t m_planeSize, m_nSatellites;
+  std::unordered_map<std::uint32_t, std::size_t> m_groundIndex;
+
+  // Either owned storage or a read only mapping of the cache file
+  std::vector<std::uint64_t> m_offsetStorage;
+  std::vector<double> m_contactStorage;
+  const std::uint64_t *m_offsets;
+  const double *m_contacts;
+  void *m_mapping;
+  std::size_t m_mappingSize;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif
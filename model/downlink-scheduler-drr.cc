@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "downlink-scheduler-drr.h"
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.DrrDownlinkScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (DrrDownlinkScheduler);
+
+TypeId
+DrrDownlinkScheduler::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::icarus::DrrDownlinkScheduler")
+          .SetParent<DownlinkScheduler> ()
+          .SetGroupName ("ICARUS")
+          .AddConstructor<DrrDownlinkScheduler> ()
+          .AddAttribute ("Quantum", "The credit each queue earns every turn, in bytes",
+                         UintegerValue (1500),
+                         MakeUintegerAccessor (&DrrDownlinkScheduler::m_quantum),
+                         MakeUintegerChecker<uint32_t> (1));
+
+  return tid;
+}
+
+DrrDownlinkScheduler::DrrDownlinkScheduler () : m_current (0), m_turnStarted (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DrrDownlinkScheduler::~DrrDownlinkScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+DrrDownlinkScheduler::Advance (std::size_t nQueues)
+{
+  m_current = (m_current + 1) % nQueues;
+  m_turnStarted = false;
+}
+
+std::size_t
+DrrDownlinkScheduler::Select (const std::vector<Ptr<Queue<Packet>>> &queues)
+{
+  NS_LOG_FUNCTION (this << queues.size ());
+  NS_ASSERT (!queues.empty ());
+
+  m_deficit.resize (queues.size (), 0);
+  m_current %= queues.size ();
+
+  // Every visit to a non-empty queue adds to its credit, so this ends
+  while (true)
+    {
+      const auto &queue = queues[m_current];
+      if (queue->IsEmpty ())
+        {
+          m_deficit[m_current] = 0;
+          Advance (queues.size ());
+          continue;
+        }
+
+      if (!m_turnStarted)
+        {
+          m_deficit[m_current] += m_quantum;
+          m_turnStarted = true;
+        }
+
+      const auto size = queue->Peek ()->GetSize ();
+      if (size > m_deficit[m_current])
+        {
+          Advance (queues.size ());
+          continue;
+        }
+
+      const auto selected = m_current;
+      m_deficit[selected] -= size;
+      if (queue->GetNPackets () == 1)
+        {
+          // It runs empty with this packet
+          m_deficit[selected] = 0;
+          Advance (queues.size ());
+        }
+
+      return selected;
+    }
+}
+
+} // namespace icarus
+} // namespace ns3
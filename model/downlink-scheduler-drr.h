@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef DOWNLINK_SCHEDULER_DRR_H
+#define DOWNLINK_SCHEDULER_DRR_H
+
+#include "downlink-scheduler.h"
+
+#include <cstdint>
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * \ingroup icarus
+ *
+ * \brief Deficit round robin.
+ *
+ * Every turn a queue earns Quantum bytes of credit and sends packets while its credit covers the
+ * next one, so destinations get the same share of the downlink bytes regardless of the size of
+ * their packets. Queues lose their credit when they run empty.
+ */
+class DrrDownlinkScheduler : public DownlinkScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+  DrrDownlinkScheduler ();
+  virtual ~DrrDownlinkScheduler ();
+
+  virtual std::size_t Select (const std::vector<Ptr<Queue<Packet>>> &queues) override;
+
+private:
+  void Advance (std::size_t nQueues);
+
+  uint32_t m_quantum; // In bytes
+  std::vector<uint64_t> m_deficit; // Indexed like the queues
+  std::size_t m_current;
+  bool m_turnStarted; // Whether the current queue already got its quantum
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* DOWNLINK_SCHEDULER_DRR_H */
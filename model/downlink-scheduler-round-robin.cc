@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "downlink-scheduler-round-robin.h"
+
+#include "ns3/log.h"
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.RoundRobinDownlinkScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (RoundRobinDownlinkScheduler);
+
+TypeId
+RoundRobinDownlinkScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::icarus::RoundRobinDownlinkScheduler")
+                          .SetParent<DownlinkScheduler> ()
+                          .SetGroupName ("ICARUS")
+                          .AddConstructor<RoundRobinDownlinkScheduler> ();
+
+  return tid;
+}
+
+RoundRobinDownlinkScheduler::RoundRobinDownlinkScheduler () : m_next (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+RoundRobinDownlinkScheduler::~RoundRobinDownlinkScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::size_t
+RoundRobinDownlinkScheduler::Select (const std::vector<Ptr<Queue<Packet>>> &queues)
+{
+  NS_LOG_FUNCTION (this << queues.size ());
+
+  for (std::size_t i = 0; i < queues.size (); i++)
+    {
+      const auto queue = (m_next + i) % queues.size ();
+      if (!queues[queue]->IsEmpty ())
+        {
+          m_next = (queue + 1) % queues.size ();
+          return queue;
+        }
+    }
+
+  NS_FATAL_ERROR ("Every downlink queue is empty");
+}
+
+} // namespace icarus
+} // namespace ns3
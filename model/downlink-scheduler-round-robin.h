@@ -0,0 +1,49 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef DOWNLINK_SCHEDULER_ROUND_ROBIN_H
+#define DOWNLINK_SCHEDULER_ROUND_ROBIN_H
+
+#include "downlink-scheduler.h"
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * \ingroup icarus
+ *
+ * \brief Serves one packet of every non-empty queue in turn.
+ */
+class RoundRobinDownlinkScheduler : public DownlinkScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+  RoundRobinDownlinkScheduler ();
+  virtual ~RoundRobinDownlinkScheduler ();
+
+  virtual std::size_t Select (const std::vector<Ptr<Queue<Packet>>> &queues) override;
+
+private:
+  std::size_t m_next; // First queue to look at in the next selection
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* DOWNLINK_SCHEDULER_ROUND_ROBIN_H */
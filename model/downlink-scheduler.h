@@ -0,0 +1,52 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef DOWNLINK_SCHEDULER_H
+#define DOWNLINK_SCHEDULER_H
+
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * \ingroup icarus
+ *
+ * \brief Chooses which of the per destination downlink queues of a satellite transmits next.
+ *
+ * Queues are only ever appended, so an index always identifies the same destination.
+ */
+class DownlinkScheduler : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual ~DownlinkScheduler ();
+
+  // Index of the queue whose head packet goes next. At least one of the queues is not empty.
+  virtual std::size_t Select (const std::vector<Ptr<Queue<Packet>>> &queues) = 0;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* DOWNLINK_SCHEDULER_H */
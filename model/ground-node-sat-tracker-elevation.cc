@@ -28,16 +28,20 @@
 #include "sat2ground-net-device.h"
 #include "ground-node-sat-tracker.h"
 #include "constellation.h"
+#include "contact-plan.h"
+#include "handover-scheduler.h"
 #include "ns3/mobility-model.h"
 #include "ns3/abort.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/pointer.h"
 #include "ns3/simulator.h"
 #include "ns3/node.h"
 #include "ns3/assert.h"
 #include "ns3/scheduler.h"
 #include <algorithm>
+#include <cmath>
 #include <boost/units/quantity.hpp>
 #include <boost/units/systems/angle/degrees.hpp>
 #include <boost/units/systems/si/length.hpp>
@@ -67,7 +71,13 @@ GroundNodeSatTrackerElevation::GetTypeId (void) noexcept
                          DoubleValue (25.0),
                          MakeDoubleAccessor (&GroundNodeSatTrackerElevation::setElevation,
                                              &GroundNodeSatTrackerElevation::getElevation),
-                         MakeDoubleChecker<double> ());
+                         MakeDoubleChecker<double> ())
+          .AddAttribute ("ContactPlan",
+                         "Precomputed contacts used instead of the orbits within its horizon. "
+                         "It must have the same MinElevation.",
+                         PointerValue (),
+                         MakePointerAccessor (&GroundNodeSatTrackerElevation::m_contactPlan),
+                         MakePointerChecker<ContactPlan> ());
 
   return tid;
 }
@@ -93,10 +103,16 @@ GroundNodeSatTrackerElevation::DoInitialize ()
 {
   NS_LOG_FUNCTION (this);
 
+  NS_ABORT_MSG_IF (m_contactPlan != nullptr &&
+                       std::abs (m_contactPlan->GetMinElevation () - getElevation ()) > 1e-9,
+                   "The contact plan is computed for a minimum elevation of "
+                       << m_contactPlan->GetMinElevation () << "°, but the tracker needs "
+                       << getElevation () << "°");
+
   // Chain up initialization
   GroundNodeSatTracker::DoInitialize ();
 
-  Simulator::ScheduleNow (&GroundNodeSatTrackerElevation::Update, this);
+  GetHandoverScheduler ()->Schedule (this, Simulator::Now ());
 }
 
 std::vector<std::tuple<Time, std::size_t, std::size_t>>
@@ -108,48 +124,82 @@ GroundNodeSatTrackerElevation::getVisibleSats () const noexcept
   NS_ABORT_MSG_UNLESS (mmodel != nullptr, "Source node lacks location information.");
   const Vector pos = mmodel->GetPosition ();
 
+  if (m_contactPlan != nullptr && m_contactPlan->Covers (Simulator::Now ()))
+    {
+      if (const auto satellites = getVisibleSatsFromContactPlan ())
+        {
+          return *satellites;
+        }
+    }
+
   std::vector<std::tuple<Time, std::size_t, std::size_t>> satellites;
 
-  for (auto plane = 0u; plane < GetConstellation ()->GetNPlanes (); plane++)
+  const auto constellation = GetConstellation ();
+  for (const auto &visible : constellation->GetVisible (pos, m_elevation))
     {
-      for (auto index = 0u; index < GetConstellation ()->GetPlaneSize (); index++)
+      const auto satmmodel = constellation->GetSatellite (visible.plane, visible.index)
+                                 ->GetNode ()
+                                 ->GetObject<CircularOrbitMobilityModel> ();
+
+      NS_LOG_DEBUG ("Considering ("
+                    << visible.plane << ", " << visible.index << ") at elevation "
+                    << quantity<degree::plane_angle> (visible.elevation).value () << "°");
+
+      const Time orbitalPeriod = satmmodel->getOrbitalPeriod ();
+
+      // Visible satellites may be existing the visibility cone. Check that the next time at the
+      // cone border is *soon*. Lets say less than half an orbit away.
+      if (const auto bye_time =
+              satmmodel->tryGetNextTimeAtElevation (m_elevation, GetObject<Node> ()))
+        { // Discard satellites that are leaving
+          NS_ASSERT (*bye_time - Simulator::Now () < orbitalPeriod / 2.0);
+          NS_LOG_DEBUG ("Sat: (" << visible.plane << ", " << visible.index
+                                 << ") will be visible for "
+                                 << (*bye_time - Simulator::Now ()).GetSeconds () << "s.");
+
+          satellites.push_back (
+              std::make_tuple (*bye_time - Simulator::Now (), visible.plane, visible.index));
+        }
+    }
+
+  NS_LOG_DEBUG ("Returning " << satellites.size () << " visible satellites");
+
+  return satellites;
+}
+
+boost::optional<std::vector<std::tuple<Time, std::size_t, std::size_t>>>
+GroundNodeSatTrackerElevation::getVisibleSatsFromContactPlan () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<std::tuple<Time, std::size_t, std::size_t>> satellites;
+
+  const auto node = GetObject<Node> ();
+  const auto constellation = GetConstellation ();
+  for (auto plane = 0u; plane < constellation->GetNPlanes (); plane++)
+    {
+      for (auto index = 0u; index < constellation->GetPlaneSize (); index++)
         {
-          const auto satmmodel = GetConstellation ()
-                                     ->GetSatellite (plane, index)
-                                     ->GetNode ()
-                                     ->GetObject<CircularOrbitMobilityModel> ();
-          const auto sat_elevation = satmmodel->getSatElevation (pos);
-          if (sat_elevation > m_elevation)
+          if (const auto bye_time = m_contactPlan->GetLos (node, plane, index, Simulator::Now ()))
+            {
+              satellites.push_back (std::make_tuple (*bye_time - Simulator::Now (), plane, index));
+            }
+          else if (m_contactPlan->IsVisible (node, plane, index, Simulator::Now ()))
             {
-              NS_LOG_DEBUG ("Considering ("
-                            << plane << ", " << index << ") at elevation "
-                            << quantity<degree::plane_angle> (sat_elevation).value () << "°");
-
-              const Time orbitalPeriod = satmmodel->getOrbitalPeriod ();
-
-              // Visible satellites may be existing the visibility cone. Check that the next time at the
-              // cone border is *soon*. Lets say less than half an orbit away.
-              if (const auto bye_time =
-                      satmmodel->tryGetNextTimeAtElevation (m_elevation, GetObject<Node> ()))
-                { // Discard satellites that are leaving
-                  NS_ASSERT (*bye_time - Simulator::Now () < orbitalPeriod / 2.0);
-                  NS_LOG_DEBUG ("Sat: (" << plane << ", " << index << ") will be visible for "
-                                         << (*bye_time - Simulator::Now ()).GetSeconds () << "s.");
-
-                  satellites.push_back (
-                      std::make_tuple (*bye_time - Simulator::Now (), plane, index));
-                }
+              NS_LOG_DEBUG ("The contact with (" << plane << ", " << index
+                                                 << ") lasts beyond the contact plan");
+              return {};
             }
         }
     }
 
-  NS_LOG_DEBUG ("Returning " << satellites.size () << " visible satellites");
+  NS_LOG_DEBUG ("Returning " << satellites.size () << " visible satellites from the contact plan");
 
   return satellites;
 }
 
-void
-GroundNodeSatTrackerElevation::Update () noexcept
+boost::optional<Time>
+GroundNodeSatTrackerElevation::Track ()
 {
   NS_LOG_FUNCTION (this);
 
@@ -170,15 +220,17 @@ GroundNodeSatTrackerElevation::Update () noexcept
 
       std::tie (visibility_time, plane, index) = *best;
       const Address remoteAddress (GetConstellation ()->GetSatellite (plane, index)->GetAddress ());
-      GetNetDevice ()->SetRemoteAddress (remoteAddress);
+      SetRemoteAddress (remoteAddress);
       NS_LOG_DEBUG ("Tracking satellite " << remoteAddress);
 
-      Simulator::Schedule (visibility_time, &GroundNodeSatTrackerElevation::Update, this);
+      return Simulator::Now () + visibility_time;
     }
   else
     {
       NS_ABORT_MSG ("Could not find any visible satellite.");
     }
+
+  return {};
 }
 
 } // namespace icarus
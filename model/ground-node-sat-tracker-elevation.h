@@ -28,6 +28,7 @@
 #include "ndn-cxx/util/signal/signal.hpp"
 #include "ns3/vector.h"
 #include "ns3/nstime.h"
+#include "ns3/ptr.h"
 
 #include <boost/units/quantity.hpp>
 #include <boost/units/systems/si/plane_angle.hpp>
@@ -36,6 +37,7 @@ namespace ns3 {
 namespace icarus {
 
 class Constellation;
+class ContactPlan;
 
 class GroundNodeSatTrackerElevation : public GroundNodeSatTracker
 {
@@ -47,17 +49,22 @@ public:
   void setElevation (double min_elevation) noexcept;
   double getElevation () const noexcept;
 
+  boost::optional<Time> Track () override;
+
   ::ndn::util::signal::Signal<GroundNodeSatTrackerElevation,
                               const std::vector<std::tuple<Time, std::size_t, std::size_t>> &>
       satsAvailable;
 
 private:
   boost::units::quantity<boost::units::si::plane_angle> m_elevation;
+  Ptr<ContactPlan> m_contactPlan;
 
   void DoInitialize () override;
-  void Update () noexcept;
 
   std::vector<std::tuple<Time, std::size_t, std::size_t>> getVisibleSats () const noexcept;
+  // None if the loss of signal of a visible satellite lies beyond the contact plan
+  boost::optional<std::vector<std::tuple<Time, std::size_t, std::size_t>>>
+  getVisibleSatsFromContactPlan () const noexcept;
 };
 
 } // namespace icarus
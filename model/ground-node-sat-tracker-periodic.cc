@@ -21,13 +21,22 @@
  */
 
 #include "ground-node-sat-tracker-periodic.h"
+#include "orbit/ground-geometry.h"
 
+#include "ns3/boolean.h"
+#include "ns3/circular-orbit.h"
 #include "ns3/constellation.h"
 #include "ns3/ground-sta-net-device.h"
+#include "ns3/handover-scheduler.h"
 #include "ns3/mobility-model.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/sat2ground-net-device.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace ns3 {
 namespace icarus {
@@ -49,7 +58,20 @@ GroundNodeSatTrackerPeriodic::GetTypeId (void) noexcept
                          "disables tracking)",
                          TimeValue (Seconds (0)),
                          MakeTimeAccessor (&GroundNodeSatTrackerPeriodic::m_interval),
-                         MakeTimeChecker ());
+                         MakeTimeChecker ())
+          .AddAttribute ("PredictHandovers",
+                         "Instead of polling every TrackingInterval, compute when the closest "
+                         "satellite will change and update the antenna just then. "
+                         "TrackingInterval is the longest time between two updates.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&GroundNodeSatTrackerPeriodic::m_predict),
+                         MakeBooleanChecker ())
+          .AddAttribute ("PredictionCandidates",
+                         "Number of satellites, besides the tracked one, that may replace it "
+                         "as the closest in a prediction",
+                         UintegerValue (8),
+                         MakeUintegerAccessor (&GroundNodeSatTrackerPeriodic::m_nCandidates),
+                         MakeUintegerChecker<uint32_t> (1));
 
   return tid;
 }
@@ -69,22 +91,29 @@ GroundNodeSatTrackerPeriodic::DoInitialize ()
       return;
     }
 
+  // Use a random point in the interval for the first periodic update
   Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
-  ns3::Simulator::ScheduleNow (&GroundNodeSatTrackerPeriodic::UpdateOnce, this);
+  m_nextDelay = Seconds (x->GetValue (0.0, m_interval.GetSeconds ()));
 
-  // Use a random point in the interval for the first update
-  ns3::Simulator::Schedule (Seconds (x->GetValue (0.0, m_interval.GetSeconds ())),
-                            &GroundNodeSatTrackerPeriodic::PeriodicUpdate, this);
+  GetHandoverScheduler ()->Schedule (this, ns3::Simulator::Now ());
 }
 
-void
-GroundNodeSatTrackerPeriodic::PeriodicUpdate () const noexcept
+boost::optional<Time>
+GroundNodeSatTrackerPeriodic::Track ()
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_predict)
+    {
+      return PredictHandover ();
+    }
+
   UpdateOnce ();
 
-  ns3::Simulator::Schedule (m_interval, &GroundNodeSatTrackerPeriodic::PeriodicUpdate, this);
+  const auto delay = m_nextDelay;
+  m_nextDelay = m_interval;
+
+  return ns3::Simulator::Now () + delay;
 }
 
 Vector3D
@@ -109,9 +138,66 @@ GroundNodeSatTrackerPeriodic::UpdateOnce () const noexcept
 
   auto constellation = GetConstellation ();
   const auto remoteAddress = constellation->GetClosest (pos)->GetAddress ();
-  GetNetDevice ()->SetRemoteAddress (remoteAddress);
+  SetRemoteAddress (remoteAddress);
+
+  NS_LOG_DEBUG ("Tracking satellite " << remoteAddress);
+}
+
+Time
+GroundNodeSatTrackerPeriodic::PredictHandover () const
+{
+  NS_LOG_FUNCTION (this);
 
+  const auto pos = GetPosition ();
+  const auto now = Simulator::Now ();
+  const auto constellation = GetConstellation ();
+
+  // The tracked satellite can only be overtaken by one of its neighbours. Within less than the
+  // time between two consecutive satellites of a plane these are the next closest ones now.
+  const auto closest = constellation->GetKClosest (pos, m_nCandidates + 1);
+  std::vector<Ptr<CircularOrbitMobilityModel>> satellites;
+  for (const auto &device : closest)
+    {
+      satellites.push_back (device->GetNode ()->GetObject<CircularOrbitMobilityModel> ());
+    }
+
+  const auto remoteAddress = closest.front ()->GetAddress ();
+  SetRemoteAddress (remoteAddress);
   NS_LOG_DEBUG ("Tracking satellite " << remoteAddress);
+
+  if (satellites.size () < 2)
+    {
+      return now + m_interval;
+    }
+
+  const auto &tracked = satellites.front ();
+  const auto spacing =
+      tracked->getOrbitalPeriod () / static_cast<double> (constellation->GetPlaneSize ());
+  const auto horizon = std::min (m_interval, spacing);
+
+  // The distances are sums of sinusoids, so the next time any of the neighbours gets closer than
+  // the tracked satellite can be bracketed safely without sampling
+  const auto geometry = [&pos, &now] (const Ptr<CircularOrbitMobilityModel> &satellite) {
+    return GroundGeometry (satellite->getOrbit (), satellite->getPositionAt (now).GetLength (),
+                           pos);
+  };
+  const auto trackedGeometry = geometry (tracked);
+  const auto resolution = MicroSeconds (1);
+  auto next = (now + horizon).GetSeconds ();
+  for (auto it = satellites.cbegin () + 1; it != satellites.cend (); ++it)
+    {
+      const auto crossing = trackedGeometry.getNextOvertaking (geometry (*it), now.GetSeconds (),
+                                                               next, resolution.GetSeconds ());
+      if (crossing)
+        {
+          next = *crossing;
+        }
+    }
+
+  NS_LOG_DEBUG ("Next handover in " << next - now.GetSeconds () << "s.");
+
+  // Never at the current instant, as the tracked satellite would not change
+  return std::max (Seconds (next), now + resolution);
 }
 
 } // namespace icarus
@@ -40,8 +40,14 @@ public:
   static TypeId GetTypeId (void) noexcept;
   virtual ~GroundNodeSatTrackerPeriodic () noexcept = default;
 
+  boost::optional<Time> Track () override;
+
 private:
   Time m_interval;
+  // Time until the next update after the current one
+  Time m_nextDelay;
+  bool m_predict;
+  uint32_t m_nCandidates;
 
   // Cache these pointers
   mutable Ptr<MobilityModel> m_mobilityModel = nullptr;
@@ -50,8 +56,9 @@ private:
 
   Vector3D GetPosition () const noexcept;
 
-  void PeriodicUpdate () const noexcept;
   void UpdateOnce () const noexcept;
+  // Track the closest satellite and return when another one becomes closer
+  Time PredictHandover () const;
 };
 
 } // namespace icarus
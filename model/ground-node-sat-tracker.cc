@@ -23,9 +23,11 @@
 #include "ground-node-sat-tracker.h"
 
 #include "constellation.h"
+#include "handover-scheduler.h"
 
 #include <ns3/log.h>
 #include <ns3/node.h>
+#include <ns3/simulator.h>
 #include <ns3/ground-sat-channel.h>
 #include <ns3/ground-sta-net-device.h>
 #include <ns3/sat2ground-net-device.h>
@@ -51,6 +53,22 @@ GroundNodeSatTracker::GroundNodeSatTracker () noexcept
 {
 }
 
+void
+GroundNodeSatTracker::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_handoverScheduler != nullptr)
+    {
+      m_handoverScheduler->Cancel (this);
+      m_handoverScheduler = nullptr;
+    }
+  m_constellation = nullptr;
+  m_netDevice = nullptr;
+
+  Object::DoDispose ();
+}
+
 const Constellation *
 GroundNodeSatTracker::GetConstellation () const noexcept
 {
@@ -89,5 +107,50 @@ GroundNodeSatTracker::GetNetDevice () const noexcept
   return m_netDevice;
 }
 
+HandoverScheduler *
+GroundNodeSatTracker::GetHandoverScheduler () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_handoverScheduler == nullptr)
+    {
+      m_handoverScheduler = GetConstellation ()->GetHandoverScheduler ();
+    }
+
+  return PeekPointer (m_handoverScheduler);
+}
+
+void
+GroundNodeSatTracker::SetRemoteAddress (const Address &address) const
+{
+  NS_LOG_FUNCTION (this << address);
+
+  if (GetNetDevice ()->GetRemoteAddress () == address)
+    {
+      return;
+    }
+
+  // The device and whoever follows its handovers schedule events of their own
+  Simulator::ScheduleWithContext (GetObject<Node> ()->GetId (), Seconds (0),
+                                  &GroundNodeSatTracker::Handover,
+                                  Ptr<const GroundNodeSatTracker> (this), address);
+}
+
+void
+GroundNodeSatTracker::Handover (const Address &address) const
+{
+  NS_LOG_FUNCTION (this << address);
+
+  const auto device = GetNetDevice ();
+  const auto oldAddress = device->GetRemoteAddress ();
+
+  device->SetRemoteAddress (address);
+
+  if (oldAddress != address)
+    {
+      GetHandoverScheduler ()->NotifyHandover (GetObject<Node> (), oldAddress, address);
+    }
+}
+
 } // namespace icarus
 } // namespace ns3
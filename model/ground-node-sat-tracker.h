@@ -23,14 +23,21 @@
 #ifndef GROUND_NODE_SAT_TRACKER_H
 #define GROUND_NODE_SAT_TRACKER_H
 
+#include <ns3/nstime.h>
 #include <ns3/object.h>
+#include <ns3/ptr.h>
+
+#include <boost/optional.hpp>
 
 namespace ns3 {
 
+class Address;
+
 namespace icarus {
 
 class Constellation;
 class GroundStaNetDevice;
+class HandoverScheduler;
 class GroundNodeSatTracker : public Object
 {
 public:
@@ -39,14 +46,29 @@ public:
   GroundNodeSatTracker () noexcept;
   virtual ~GroundNodeSatTracker () noexcept = default;
 
+  // Called by the handover scheduler. Updates the tracked satellite and returns the (absolute)
+  // time of the next update, if any.
+  virtual boost::optional<Time> Track () = 0;
+
 protected:
+  void DoDispose () override;
+
   const Constellation *GetConstellation () const noexcept;
   GroundStaNetDevice *GetNetDevice () const noexcept;
+  HandoverScheduler *GetHandoverScheduler () const noexcept;
+
+  // Point the antenna to a new satellite and report the handover, if any. Updates do not run in
+  // the node context, so a handover is scheduled right away in the context of the node.
+  void SetRemoteAddress (const Address &address) const;
 
 private:
+  void Handover (const Address &address) const;
+
   // Cache these pointers
   mutable Constellation *m_constellation;
   mutable GroundStaNetDevice *m_netDevice;
+  // Keep the scheduler alive to cancel our pending update on disposal
+  mutable Ptr<HandoverScheduler> m_handoverScheduler;
 };
 
 } // namespace icarus
@@ -22,8 +22,14 @@
 
 #include "ground-sat-channel.h"
 
+#include "spatial/footprint-grid.h"
+
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/constellation.h"
+#include "ns3/double.h"
+#include "ns3/event-impl.h"
+#include "ns3/global-value.h"
 #include "ns3/ground-sat-success-model.h"
 #include "ns3/ground-sta-net-device.h"
 #include "ns3/ipv6-address.h"
@@ -34,6 +40,13 @@
 #include "ns3/sat2ground-net-device.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/string.h"
+
+#include <boost/units/systems/angle/degrees.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -42,6 +55,90 @@ NS_LOG_COMPONENT_DEFINE ("icarus.GroundSatChannel");
 
 NS_OBJECT_ENSURE_REGISTERED (GroundSatChannel);
 
+using namespace boost::units;
+
+namespace {
+// Cell size of the footprint grid, in radians. About 2º, i.e., some 220 km at the equator.
+constexpr double FOOTPRINT_CELL_SIZE = 0.035;
+} // namespace
+
+/**
+ * Reception of a downlink frame at a list of ground stations.
+ *
+ * The channel keeps a pool of these events and reuses them once the simulator has run them, so
+ * scheduling a reception does not allocate. Every recipient is run in the context of the node the
+ * event was scheduled with, i.e., that of the first one.
+ */
+class DownlinkDelivery : public EventImpl
+{
+public:
+  explicit DownlinkDelivery (std::vector<DownlinkDelivery *> *pool) : m_pool (pool)
+  {
+  }
+
+  // Called by the channel when it is disposed of before the event runs
+  void
+  ReleasePool ()
+  {
+    m_pool = nullptr;
+  }
+
+  void
+  SetFrame (const Ptr<Packet> &packet, DataRate bps, const Address &src, uint16_t protocolNumber,
+            bool cutThrough)
+  {
+    m_packet = packet;
+    m_bps = bps;
+    m_src = src;
+    m_protocolNumber = protocolNumber;
+    m_cutThrough = cutThrough;
+  }
+
+  void
+  AddRecipient (const Ptr<GroundStaNetDevice> &device, double rxPower)
+  {
+    m_recipients.emplace_back (device, rxPower);
+  }
+
+protected:
+  virtual void
+  Notify (void) override
+  {
+    for (const auto &recipient : m_recipients)
+      {
+        if (m_cutThrough)
+          {
+            recipient.first->ReceiveFromSatCutThrough (m_packet, m_bps, m_src, m_protocolNumber,
+                                                       recipient.second);
+          }
+        else
+          {
+            recipient.first->ReceiveFromSat (m_packet, m_bps, m_src, m_protocolNumber,
+                                             recipient.second);
+          }
+      }
+
+    // Do not hold the packet or the devices while idle
+    m_recipients.clear ();
+    m_packet = nullptr;
+    if (m_pool != nullptr)
+      {
+        m_pool->push_back (this);
+      }
+  }
+
+private:
+  std::vector<DownlinkDelivery *> *m_pool;
+
+  Ptr<Packet> m_packet;
+  DataRate m_bps;
+  Address m_src;
+  uint16_t m_protocolNumber;
+  // Deliver at the end of the reception instead of at its start
+  bool m_cutThrough;
+  std::vector<std::pair<Ptr<GroundStaNetDevice>, double>> m_recipients;
+};
+
 TypeId
 GroundSatChannel::GetTypeId (void)
 {
@@ -56,11 +153,67 @@ GroundSatChannel::GetTypeId (void)
                          PointerValue (), MakePointerAccessor (&GroundSatChannel::m_txSuccessModel),
                          MakePointerChecker<GroundSatSuccessModel> ())
           .AddAttribute ("PropDelayModel", "Object used to calculate the propagation delay",
-                         PointerValue (), MakePointerAccessor (&GroundSatChannel::m_propDelayModel),
+                         PointerValue (),
+                         MakePointerAccessor (&GroundSatChannel::SetPropDelayModel,
+                                              &GroundSatChannel::GetPropDelayModel),
                          MakePointerChecker<PropagationDelayModel> ())
           .AddAttribute ("PropLossModel", "Object used to model the propagation loss",
                          PointerValue (), MakePointerAccessor (&GroundSatChannel::m_propLossModel),
                          MakePointerChecker<PropagationLossModel> ())
+          .AddAttribute ("TrackingFilter",
+                         "Only deliver satellite transmissions to the ground stations tracking "
+                         "the satellite, and to those with a promiscuous downlink. Receivers are "
+                         "chosen when the frame is sent, so a station that starts listening to "
+                         "the satellite while the frame propagates misses it, unlike without "
+                         "the filter.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&GroundSatChannel::m_trackingFilter),
+                         MakeBooleanChecker ())
+          .AddAttribute ("FootprintFilter",
+                         "Only deliver satellite transmissions to the ground stations within the "
+                         "footprint of the satellite. Stations must not move.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&GroundSatChannel::m_footprintFilter),
+                         MakeBooleanChecker ())
+          .AddAttribute ("FootprintElevation",
+                         "Minimum elevation, in degrees, of a satellite over a ground station "
+                         "within its footprint",
+                         DoubleValue (0.0),
+                         MakeDoubleAccessor (&GroundSatChannel::SetFootprintElevation,
+                                             &GroundSatChannel::GetFootprintElevation),
+                         MakeDoubleChecker<double> (-90.0, 90.0))
+          .AddAttribute ("CutThrough",
+                         "Deliver every satellite transmission in a single event at the end of "
+                         "its reception, instead of one at its start and another one at its end. "
+                         "The PhyRxBegin and PhyRxEnd traces of the ground stations are fired back "
+                         "to back. Whether they listen to the satellite is still decided at the "
+                         "start of the reception.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&GroundSatChannel::m_cutThrough),
+                         MakeBooleanChecker ())
+          .AddAttribute ("BatchedDelivery",
+                         "Deliver a satellite transmission to all the ground stations with the "
+                         "same propagation delay, rounded to DelayQuantum, in a single event. It "
+                         "runs in the context of the first of them, as do the events the others "
+                         "schedule from it, so it cannot be used with distributed simulators.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&GroundSatChannel::SetBatchedDelivery,
+                                              &GroundSatChannel::IsBatchedDelivery),
+                         MakeBooleanChecker ())
+          .AddAttribute ("DelayQuantum",
+                         "Resolution of the propagation delay of batched deliveries (0 keeps it "
+                         "exact)",
+                         TimeValue (MicroSeconds (1)),
+                         MakeTimeAccessor (&GroundSatChannel::m_delayQuantum),
+                         MakeTimeChecker (Seconds (0)))
+          .AddAttribute ("LinkStateCache",
+                         "Reuse the transmission success, delay, received power and geometry of "
+                         "a link between a ground station and a satellite for every "
+                         "transmission at the same time. Assumes a deterministic propagation "
+                         "loss model, and a success model that does not depend on the packet.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&GroundSatChannel::m_linkStateCache),
+                         MakeBooleanChecker ())
           .AddTraceSource ("PhyTxDrop",
                            "Trace source indicating a packet has been "
                            "dropped by the channel",
@@ -77,11 +230,78 @@ GroundSatChannel::AddGroundDevice (const Ptr<GroundStaNetDevice> &device)
   NS_ABORT_MSG_UNLESS (device->GetNode ()->GetObject<MobilityModel> () != 0,
                        "Ground stations need a mobility model");
 
+  const auto station = m_ground.size ();
   m_ground.push_back (device);
+  m_footprint = nullptr;
+
+  // Stations follow their tracked satellite even while promiscuous, as they may stop being so
+  UpdateTracking (station, SatAddress (), SatAddress::ConvertFrom (device->GetRemoteAddress ()));
+  m_trackingConnections.emplace_back (device->remoteAddressChange.connect (
+      [this, station] (const SatAddress &oldAddress, const SatAddress &newAddress) {
+        UpdateTracking (station, oldAddress, newAddress);
+      }));
+  UpdatePromiscuous (station, device->IsPromiscuousDownlink ());
+  m_trackingConnections.emplace_back (device->promiscuousDownlinkChange.connect (
+      [this, station] (bool promiscuous) { UpdatePromiscuous (station, promiscuous); }));
+}
+
+uint64_t
+GroundSatChannel::GetTrackingKey (const SatAddress &address) noexcept
+{
+  return (uint64_t (address.getConstellationId ()) << 32) |
+         (uint64_t (address.getOrbitalPlane ()) << 16) | address.getPlaneIndex ();
+}
+
+void
+GroundSatChannel::UpdateTracking (std::size_t station, const SatAddress &oldAddress,
+                                  const SatAddress &newAddress)
+{
+  NS_LOG_FUNCTION (this << station << oldAddress << newAddress);
+
+  const auto old = m_tracking.find (GetTrackingKey (oldAddress));
+  if (old != m_tracking.end ())
+    {
+      auto &stations = old->second;
+      const auto position = std::lower_bound (stations.begin (), stations.end (), station);
+      if (position != stations.end () && *position == station)
+        {
+          stations.erase (position);
+        }
+    }
+
+  auto &stations = m_tracking[GetTrackingKey (newAddress)];
+  stations.insert (std::lower_bound (stations.begin (), stations.end (), station), station);
+}
+
+void
+GroundSatChannel::UpdatePromiscuous (std::size_t station, bool promiscuous)
+{
+  NS_LOG_FUNCTION (this << station << promiscuous);
+
+  const auto position = std::lower_bound (m_promiscuous.begin (), m_promiscuous.end (), station);
+  const auto found = position != m_promiscuous.end () && *position == station;
+  if (promiscuous && !found)
+    {
+      m_promiscuous.insert (position, station);
+    }
+  else if (!promiscuous && found)
+    {
+      m_promiscuous.erase (position);
+    }
 }
 
 GroundSatChannel::GroundSatChannel ()
-    : Channel (), m_txSuccessModel (nullptr), m_constellation (nullptr)
+    : Channel (),
+      m_txSuccessModel (nullptr),
+      m_propSpeed (0.0),
+      m_constellation (nullptr),
+      m_footprintFilter (false),
+      m_minGroundRadius (0.0),
+      m_trackingFilter (false),
+      m_cutThrough (false),
+      m_batchedDelivery (false),
+      m_linkStateCache (false),
+      m_linkStateTime (Time::Min ())
 {
   NS_LOG_FUNCTION (this);
 }
@@ -91,6 +311,69 @@ GroundSatChannel::~GroundSatChannel ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+void
+GroundSatChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Deliveries still scheduled outlive the pool
+  for (const auto &delivery : m_deliveries)
+    {
+      delivery->ReleasePool ();
+    }
+  m_deliveries.clear ();
+  m_freeDeliveries.clear ();
+  m_trackingConnections.clear ();
+
+  Channel::DoDispose ();
+}
+
+void
+GroundSatChannel::SetBatchedDelivery (bool batched)
+{
+  NS_LOG_FUNCTION (this << batched);
+
+  if (batched)
+    {
+      // Distributed simulators partition the events by their context
+      StringValue implementation;
+      GlobalValue::GetValueByName ("SimulatorImplementationType", implementation);
+      NS_ABORT_MSG_IF (implementation.Get () == "ns3::DistributedSimulatorImpl" ||
+                           implementation.Get () == "ns3::NullMessageSimulatorImpl",
+                       "Batched downlink deliveries run in the context of a single station");
+    }
+
+  m_batchedDelivery = batched;
+}
+
+bool
+GroundSatChannel::IsBatchedDelivery () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_batchedDelivery;
+}
+
+void
+GroundSatChannel::SetPropDelayModel (Ptr<PropagationDelayModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+
+  m_propDelayModel = model;
+
+  // This is what the constant speed model computes, without looking up the positions again
+  const auto constantSpeed = DynamicCast<ConstantSpeedPropagationDelayModel> (model);
+  m_propSpeed = constantSpeed != nullptr ? constantSpeed->GetSpeed () : 0.0;
+}
+
+Ptr<PropagationDelayModel>
+GroundSatChannel::GetPropDelayModel () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_propDelayModel;
+}
+
 Time
 GroundSatChannel::Transmit2Sat (const Ptr<Packet> &packet, DataRate bps,
                                 const Ptr<GroundStaNetDevice> &src, const SatAddress &dst,
@@ -113,24 +396,21 @@ GroundSatChannel::Transmit2Sat (const Ptr<Packet> &packet, DataRate bps,
     {
       NS_LOG_DEBUG ("Dropping packet as destination address is not in orbit " << dst);
       m_phyTxDropTrace (packet);
-    }
 
-  const auto posGround = src->GetNode ()->GetObject<MobilityModel> ();
-  const auto posSat = sat_device->GetNode ()->GetObject<MobilityModel> ();
+      return endTx;
+    }
 
-  const Time delay = m_propDelayModel->GetDelay (posGround, posSat);
-  const double rxPower = m_propLossModel->CalcRxPower (txPower, posGround, posSat);
+  const auto &link = GetLinkState (src->GetNode (), sat_device->GetNode (), packet, txPower);
 
-  if (m_txSuccessModel != nullptr &&
-      m_txSuccessModel->TramsmitSuccess (src->GetNode (), sat_device->GetNode (), packet) != true)
+  if (!link.success)
     {
       m_phyTxDropTrace (packet);
     }
   else
     {
-      Simulator::ScheduleWithContext (sat_device->GetNode ()->GetId (), delay,
+      Simulator::ScheduleWithContext (sat_device->GetNode ()->GetId (), link.delay,
                                       &Sat2GroundNetDevice::ReceiveFromGround, sat_device, packet,
-                                      bps, src->GetAddress (), protocolNumber, rxPower);
+                                      bps, src->GetAddress (), protocolNumber, link.rxPower);
     }
 
   return endTx;
@@ -143,28 +423,247 @@ GroundSatChannel::Transmit2Ground (const Ptr<Packet> &packet, DataRate bps,
 {
   NS_LOG_FUNCTION (this << packet << bps << &src << protocolNumber);
 
-  for (const auto &ground_device : m_ground)
+  const auto posSat = src->GetNode ()->GetObject<MobilityModel> ();
+  // In cut-through mode the reception is delivered when it ends
+  const auto rxOffset = m_cutThrough ? bps.CalculateBytesTxTime (packet->GetSize ()) : Time ();
+
+  const auto transmit = [&] (const Ptr<GroundStaNetDevice> &ground_device) {
+    const auto &link = GetLinkState (ground_device->GetNode (), src->GetNode (), packet, txPower);
+    const auto delay = link.delay + rxOffset;
+    const auto rxPower = link.rxPower;
+
+    if (!link.success)
+      {
+        NS_LOG_DEBUG ("Dropped packet " << packet);
+        m_phyTxDropTrace (packet);
+      }
+    else if (m_batchedDelivery)
+      {
+        m_pendingDeliveries.push_back ({delay, ground_device, rxPower});
+      }
+    else
+      {
+        const auto delivery = AcquireDelivery (packet, bps, src->GetAddress (), protocolNumber);
+        delivery->AddRecipient (ground_device, rxPower);
+        Simulator::ScheduleWithContext (ground_device->GetNode ()->GetId (), delay,
+                                        static_cast<EventImpl *> (delivery));
+      }
+  };
+
+  m_pendingDeliveries.clear ();
+
+  if (m_trackingFilter)
     {
-      const auto posGround = ground_device->GetNode ()->GetObject<MobilityModel> ();
-      const auto posSat = src->GetNode ()->GetObject<MobilityModel> ();
+      for (const auto i : GetReceivers (src))
+        {
+          transmit (m_ground[i]);
+        }
+    }
+  else if (m_footprintFilter)
+    {
+      for (const auto i : GetStationsInFootprint (posSat->GetPosition ()))
+        {
+          transmit (m_ground[i]);
+        }
+    }
+  else
+    {
+      for (const auto &ground_device : m_ground)
+        {
+          transmit (ground_device);
+        }
+    }
 
-      const Time delay = m_propDelayModel->GetDelay (posGround, posSat);
-      const double rxPower = m_propLossModel->CalcRxPower (txPower, posGround, posSat);
+  if (m_pendingDeliveries.empty ())
+    {
+      return;
+    }
+
+  const auto quantum = m_delayQuantum.GetTimeStep ();
+  if (quantum > 0)
+    {
+      for (auto &pending : m_pendingDeliveries)
+        {
+          const auto steps = pending.delay.GetTimeStep ();
+          pending.delay = TimeStep ((steps + quantum / 2) / quantum * quantum);
+        }
+    }
+  std::stable_sort (m_pendingDeliveries.begin (), m_pendingDeliveries.end (),
+                    [] (const auto &a, const auto &b) { return a.delay < b.delay; });
+
+  for (auto first = m_pendingDeliveries.cbegin (); first != m_pendingDeliveries.cend ();)
+    {
+      const auto delivery = AcquireDelivery (packet, bps, src->GetAddress (), protocolNumber);
+
+      auto last = first;
+      for (; last != m_pendingDeliveries.cend () && last->delay == first->delay; last++)
+        {
+          delivery->AddRecipient (last->device, last->rxPower);
+        }
+
+      Simulator::ScheduleWithContext (first->device->GetNode ()->GetId (), first->delay,
+                                      static_cast<EventImpl *> (delivery));
+      first = last;
+    }
+
+  m_pendingDeliveries.clear ();
+}
+
+const GroundSatChannel::LinkState &
+GroundSatChannel::GetLinkState (const Ptr<Node> &ground, const Ptr<Node> &satellite,
+                                const Ptr<Packet> &packet, double txPower) const
+{
+  NS_LOG_FUNCTION (this << ground << satellite << packet << txPower);
+
+  auto *state = &m_linkState;
+  bool known = false;
+  if (m_linkStateCache)
+    {
+      const auto now = Simulator::Now ();
+      if (now != m_linkStateTime)
+        {
+          m_linkStates.clear ();
+          m_linkStateTime = now;
+        }
+
+      const auto key = (uint64_t (ground->GetId ()) << 32) | satellite->GetId ();
+      const auto inserted = m_linkStates.emplace (key, LinkState ());
+      state = &inserted.first->second;
+      known = !inserted.second;
+    }
+
+  if (known && state->txPower == txPower)
+    {
+      return *state;
+    }
+
+  const auto posGround = ground->GetObject<MobilityModel> ();
+  const auto posSat = satellite->GetObject<MobilityModel> ();
+
+  if (!known)
+    {
+      auto &geometry = state->geometry;
+      geometry.ground = ground;
+      geometry.satellite = satellite;
+      geometry.groundPosition = posGround->GetPosition ();
+      geometry.satPosition = posSat->GetPosition ();
+      geometry.distance = CalculateDistance (geometry.groundPosition, geometry.satPosition);
+
+      state->success = m_txSuccessModel == nullptr ||
+                       m_txSuccessModel->TramsmitSuccess (geometry, packet);
+      state->delay = m_propSpeed > 0.0 ? Seconds (geometry.distance / m_propSpeed)
+                                       : m_propDelayModel->GetDelay (posGround, posSat);
+    }
+
+  state->txPower = txPower;
+  state->rxPower = m_propLossModel->CalcRxPower (txPower, posGround, posSat);
+
+  return *state;
+}
+
+DownlinkDelivery *
+GroundSatChannel::AcquireDelivery (const Ptr<Packet> &packet, DataRate bps, const Address &src,
+                                   uint16_t protocolNumber) const
+{
+  NS_LOG_FUNCTION (this << packet << bps << src << protocolNumber);
+
+  if (m_freeDeliveries.empty ())
+    {
+      m_deliveries.push_back (Create<DownlinkDelivery> (&m_freeDeliveries));
+      m_freeDeliveries.push_back (PeekPointer (m_deliveries.back ()));
+    }
 
-      if (m_txSuccessModel != nullptr &&
-          m_txSuccessModel->TramsmitSuccess (ground_device->GetNode (), src->GetNode (), packet) !=
-              true)
+  const auto delivery = m_freeDeliveries.back ();
+  m_freeDeliveries.pop_back ();
+  delivery->SetFrame (packet, bps, src, protocolNumber, m_cutThrough);
+
+  // The simulator releases this reference after running the event
+  delivery->Ref ();
+
+  return delivery;
+}
+
+const std::vector<std::size_t> &
+GroundSatChannel::GetReceivers (const Ptr<Sat2GroundNetDevice> &satellite) const
+{
+  NS_LOG_FUNCTION (this << satellite);
+
+  static const std::vector<std::size_t> none;
+  const auto tracking =
+      m_tracking.find (GetTrackingKey (SatAddress::ConvertFrom (satellite->GetAddress ())));
+  const auto &tracked = tracking != m_tracking.end () ? tracking->second : none;
+
+  if (m_promiscuous.empty ())
+    {
+      return tracked;
+    }
+
+  m_receivers.clear ();
+  if (m_footprintFilter)
+    {
+      const auto position = satellite->GetNode ()->GetObject<MobilityModel> ()->GetPosition ();
+      for (const auto i : GetStationsInFootprint (position))
         {
-          NS_LOG_DEBUG ("Dropped packet " << packet);
-          m_phyTxDropTrace (packet);
+          if (m_ground[i]->IsPromiscuousDownlink ())
+            {
+              m_receivers.push_back (i);
+            }
         }
-      else
+    }
+  else
+    {
+      m_receivers.assign (m_promiscuous.cbegin (), m_promiscuous.cend ());
+    }
+
+  // Keep the order of m_ground. Promiscuous stations may also track the satellite.
+  const auto nPromiscuous = m_receivers.size ();
+  m_receivers.insert (m_receivers.end (), tracked.cbegin (), tracked.cend ());
+  std::inplace_merge (m_receivers.begin (), m_receivers.begin () + nPromiscuous,
+                      m_receivers.end ());
+  m_receivers.erase (std::unique (m_receivers.begin (), m_receivers.end ()), m_receivers.end ());
+
+  return m_receivers;
+}
+
+const std::vector<std::size_t> &
+GroundSatChannel::GetStationsInFootprint (const Vector &satPosition) const
+{
+  NS_LOG_FUNCTION (this << satPosition);
+
+  if (m_footprint == nullptr)
+    {
+      std::vector<Vector> positions;
+      positions.reserve (m_ground.size ());
+      m_minGroundRadius = std::numeric_limits<double>::infinity ();
+      for (const auto &ground_device : m_ground)
         {
-          Simulator::ScheduleWithContext (ground_device->GetNode ()->GetId (), delay,
-                                          &GroundStaNetDevice::ReceiveFromSat, ground_device,
-                                          packet, bps, src->GetAddress (), protocolNumber, rxPower);
+          const auto mobility = ground_device->GetNode ()->GetObject<MobilityModel> ();
+          positions.push_back (mobility->GetPosition ());
+          m_minGroundRadius = std::min (m_minGroundRadius, positions.back ().GetLength ());
         }
+
+      m_footprint = std::make_unique<FootprintGrid> (FOOTPRINT_CELL_SIZE);
+      m_footprint->build (positions);
+    }
+
+  m_inFootprint.clear ();
+
+  // Earth central angle between the satellite and the border of its footprint. Stations farther
+  // from the centre of the Earth than the lowest one have a narrower footprint.
+  const auto radius = satPosition.GetLength ();
+  const auto elevation = m_footprintElevation.value ();
+  if (radius > 0.0 && m_minGroundRadius < radius)
+    {
+      const auto angle =
+          std::acos (std::min (1.0, m_minGroundRadius * std::cos (elevation) / radius)) -
+          elevation;
+      m_footprint->withinAngle (satPosition, angle, m_inFootprint);
     }
+
+  NS_LOG_DEBUG (m_inFootprint.size () << " of " << m_ground.size ()
+                                      << " ground stations in the footprint");
+
+  return m_inFootprint;
 }
 
 std::size_t
@@ -206,5 +705,21 @@ GroundSatChannel::GetConstellation () const
   return m_constellation;
 }
 
+void
+GroundSatChannel::SetFootprintElevation (double elevation) noexcept
+{
+  NS_LOG_FUNCTION (this << elevation);
+
+  m_footprintElevation = quantity<si::plane_angle> (elevation * degree::degrees);
+}
+
+double
+GroundSatChannel::GetFootprintElevation () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  return quantity<degree::plane_angle> (m_footprintElevation).value ();
+}
+
 } // namespace icarus
 } // namespace ns3
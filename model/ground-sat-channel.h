@@ -23,13 +23,24 @@
 #ifndef GROUND_SAT_CHANNEL_H
 #define GROUND_SAT_CHANNEL_H
 
+#include "ndn-cxx/util/signal/scoped-connection.hpp"
 #include "ns3/channel.h"
 #include "ns3/data-rate.h"
+#include "ns3/ground-sat-success-model.h"
 #include "ns3/net-device-container.h"
 #include "ns3/net-device.h"
+#include "ns3/nstime.h"
 #include "ns3/sat-address.h"
 #include "ns3/traced-callback.h"
 
+#include <boost/units/quantity.hpp>
+#include <boost/units/systems/si/plane_angle.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 namespace ns3 {
 
 class Packet;
@@ -42,6 +53,8 @@ class GroundStaNetDevice;
 class Sat2GroundNetDevice;
 class GroundSatSuccessModel;
 class Constellation;
+class FootprintGrid;
+class DownlinkDelivery;
 
 class GroundSatChannel : public Channel
 {
@@ -69,13 +82,91 @@ public:
   void SetConstellation (const Ptr<Constellation> &constellation);
   Ptr<Constellation> GetConstellation () const;
 
+  void SetFootprintElevation (double elevation) noexcept;
+  double GetFootprintElevation () const noexcept;
+
+  void SetBatchedDelivery (bool batched);
+  bool IsBatchedDelivery () const;
+
+  void SetPropDelayModel (Ptr<PropagationDelayModel> model);
+  Ptr<PropagationDelayModel> GetPropDelayModel () const;
+
+protected:
+  virtual void DoDispose (void) override;
+
 private:
+  // Indices in m_ground of the stations that may see a satellite at satPosition
+  const std::vector<std::size_t> &GetStationsInFootprint (const Vector &satPosition) const;
+  // Indices in m_ground of the stations that accept the transmissions of satellite
+  const std::vector<std::size_t> &GetReceivers (const Ptr<Sat2GroundNetDevice> &satellite) const;
+  void UpdateTracking (std::size_t station, const SatAddress &oldAddress,
+                       const SatAddress &newAddress);
+  void UpdatePromiscuous (std::size_t station, bool promiscuous);
+  static uint64_t GetTrackingKey (const SatAddress &address) noexcept;
+  struct LinkState
+  {
+    LinkGeometry geometry;
+    bool success;
+    Time delay;
+    double txPower;
+    double rxPower;
+  };
+  // Success, delay, received power and geometry of the link at the current time
+  const LinkState &GetLinkState (const Ptr<Node> &ground, const Ptr<Node> &satellite,
+                                 const Ptr<Packet> &packet, double txPower) const;
+
+  DownlinkDelivery *AcquireDelivery (const Ptr<Packet> &packet, DataRate bps, const Address &src,
+                                     uint16_t protocolNumber) const;
+
   std::vector<Ptr<GroundStaNetDevice>> m_ground;
   Ptr<GroundSatSuccessModel> m_txSuccessModel;
   Ptr<PropagationDelayModel> m_propDelayModel;
   Ptr<PropagationLossModel> m_propLossModel;
+  // Speed of the constant speed delay model, to compute the delay from the link geometry. 0 for
+  // other delay models.
+  double m_propSpeed;
   Ptr<Constellation> m_constellation;
 
+  // Downlink fan-out limited to the stations in the footprint of the satellite
+  bool m_footprintFilter;
+  boost::units::quantity<boost::units::si::plane_angle> m_footprintElevation;
+  // Built on first use, as stations may be placed after being added
+  mutable std::unique_ptr<FootprintGrid> m_footprint;
+  mutable double m_minGroundRadius;
+  mutable std::vector<std::size_t> m_inFootprint;
+
+  // Downlink fan-out limited to the stations tracking the satellite when the frame is sent
+  bool m_trackingFilter;
+  // Sorted indices in m_ground of the stations tracking every satellite
+  std::unordered_map<uint64_t, std::vector<std::size_t>> m_tracking;
+  // Sorted indices in m_ground of the stations listening to every satellite
+  std::vector<std::size_t> m_promiscuous;
+  // Connections to the remote address and promiscuous downlink changes of every station
+  std::vector<::ndn::util::signal::ScopedConnection> m_trackingConnections;
+  mutable std::vector<std::size_t> m_receivers;
+
+  // Downlink frames are delivered in a single event at the end of their reception
+  bool m_cutThrough;
+  // Receptions of a downlink frame with the same (quantized) delay share a single event
+  bool m_batchedDelivery;
+  Time m_delayQuantum;
+  struct PendingDelivery
+  {
+    Time delay;
+    Ptr<GroundStaNetDevice> device;
+    double rxPower;
+  };
+  mutable std::vector<PendingDelivery> m_pendingDeliveries;
+  // Delivery events, reused once the simulator is done with them
+  mutable std::vector<Ptr<DownlinkDelivery>> m_deliveries;
+  mutable std::vector<DownlinkDelivery *> m_freeDeliveries;
+
+  // Link states of the current timestamp, keyed by ground and satellite node ids
+  bool m_linkStateCache;
+  mutable Time m_linkStateTime;
+  mutable std::unordered_map<uint64_t, LinkState> m_linkStates;
+  mutable LinkState m_linkState;
+
   TracedCallback<Ptr<const Packet>> m_phyTxDropTrace;
 };
 } // namespace icarus
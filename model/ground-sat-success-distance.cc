@@ -75,5 +75,13 @@ GroundSatSuccessDistance::TramsmitSuccess (const Ptr<Node> &src, const Ptr<Node>
   return CalculateDistance (posSrc, posDst) <= m_maxDistance;
 }
 
+bool
+GroundSatSuccessDistance::TramsmitSuccess (const LinkGeometry &link, const Ptr<Packet> &) const
+{
+  NS_LOG_FUNCTION (this << link.ground << link.satellite);
+
+  return link.distance <= m_maxDistance;
+}
+
 } // namespace icarus
 } // namespace ns3
@@ -36,6 +36,8 @@ public:
 
   virtual bool TramsmitSuccess (const Ptr<Node> &srcNode, const Ptr<Node> &dstNode,
                                 const Ptr<Packet> &packet) const override;
+  virtual bool TramsmitSuccess (const LinkGeometry &link,
+                                const Ptr<Packet> &packet) const override;
 
 private:
   static const double DEFAULT_MAX_DISTANCE;
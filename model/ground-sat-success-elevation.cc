@@ -107,5 +107,15 @@ GroundSatSuccessElevation::TramsmitSuccess (const Ptr<Node> &src, const Ptr<Node
 
   return elevation >= m_minimumElevation;
 }
+
+bool
+GroundSatSuccessElevation::TramsmitSuccess (const LinkGeometry &link,
+                                            const Ptr<Packet> &) const noexcept
+{
+  NS_LOG_FUNCTION (this << link.ground << link.satellite);
+
+  return CircularOrbitMobilityModel::getSatElevation (link.satPosition, link.groundPosition) >=
+         m_minimumElevation;
+}
 } // namespace icarus
 } // namespace ns3
\ No newline at end of file
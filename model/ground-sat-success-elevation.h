@@ -39,6 +39,8 @@ public:
 
   virtual bool TramsmitSuccess (const Ptr<Node> &srcNode, const Ptr<Node> &dstNode,
                                 const Ptr<Packet> &packet) const noexcept override;
+  virtual bool TramsmitSuccess (const LinkGeometry &link,
+                                const Ptr<Packet> &packet) const noexcept override;
 
   void SetMinimumElevationDegrees (double minElevation) noexcept;
   double GetMinimumElevationDegrees () const noexcept;
@@ -44,5 +44,13 @@ GroundSatSuccessModel::~GroundSatSuccessModel ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+GroundSatSuccessModel::TramsmitSuccess (const LinkGeometry &link, const Ptr<Packet> &packet) const
+{
+  NS_LOG_FUNCTION (this << link.ground << link.satellite << packet);
+
+  return TramsmitSuccess (link.ground, link.satellite, packet);
+}
+
 } // namespace icarus
 } // namespace ns3
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include "ns3/ptr.h"
 #include "ns3/type-id.h"
 #include "ns3/object.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -34,6 +35,16 @@ class Packet;
 
 namespace icarus {
 
+// Geometry of the link between a ground station and a satellite at the current time
+struct LinkGeometry
+{
+  Ptr<Node> ground;
+  Ptr<Node> satellite;
+  Vector groundPosition;
+  Vector satPosition;
+  double distance; // In meters
+};
+
 class GroundSatSuccessModel : public Object
 {
 public:
@@ -42,6 +53,9 @@ public:
 
   virtual bool TramsmitSuccess (const Ptr<Node> &srcNode, const Ptr<Node> &dstNode,
                                 const Ptr<Packet> &packet) const = 0;
+  // Same for a link whose geometry is already known. Models that only depend on the geometry
+  // should override it to avoid looking up the positions of the nodes again.
+  virtual bool TramsmitSuccess (const LinkGeometry &link, const Ptr<Packet> &packet) const;
 };
 
 } // namespace icarus
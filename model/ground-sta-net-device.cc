@@ -23,6 +23,7 @@
 #include "ground-sta-net-device.h"
 #include "ns3/log.h"
 #include "ns3/address.h"
+#include "ns3/boolean.h"
 #include "ns3/icarus-net-device.h"
 #include "ns3/log-macros-enabled.h"
 #include "ns3/mac48-address.h"
@@ -39,138 +40,6 @@ NS_LOG_COMPONENT_DEFINE ("icarus.GroundStaNetDevice");
 
 NS_OBJECT_ENSURE_REGISTERED (GroundStaNetDevice);
 
-namespace {
-/**
- * \brief Tag to store source, destination and protocol of each packet.
- */
-class GroundSatTag : public Tag
-{
-public:
-  /**
-   * \brief Get the type ID.
-   * \return the object TypeId
-   */
-  static TypeId GetTypeId (void);
-  virtual TypeId GetInstanceTypeId (void) const override;
-
-  virtual uint32_t GetSerializedSize (void) const override;
-  virtual void Serialize (TagBuffer i) const override;
-  virtual void Deserialize (TagBuffer i) override;
-
-  /**
-   * Set the destination address
-   * \param dst destination address
-   */
-  void
-  SetDst (const SatAddress &dst)
-  {
-    m_dst = dst;
-  }
-  /**
-   * Get the destination address
-   * \return the destination address
-   */
-  const SatAddress &
-  GetDst (void) const
-  {
-    return m_dst;
-  }
-
-  /**
-   * Set the protocol number
-   * \param proto protocol number
-   */
-  void
-  SetProto (uint16_t proto)
-  {
-    m_protocolNumber = proto;
-  }
-  /**
-   * Get the protocol number
-   * \return the protocol number
-   */
-  uint16_t
-  GetProto (void) const
-  {
-    return m_protocolNumber;
-  }
-
-  /**
-   * Set the packet power
-   * \param power packet power
-   */
-  void
-  SetPower (double power)
-  {
-    m_power = power;
-  }
-  /**
-   * Get the packet power
-   * \return the packet power
-   */
-  double
-  GetPower (void) const
-  {
-    return m_power;
-  }
-
-  void Print (std::ostream &os) const override;
-
-private:
-  SatAddress m_dst; //!< destination address
-  uint16_t m_protocolNumber; //!< protocol number
-  double m_power; //!< packet power
-};
-
-NS_OBJECT_ENSURE_REGISTERED (GroundSatTag);
-
-TypeId
-GroundSatTag::GetTypeId (void)
-{
-  static TypeId tid = TypeId ("ns3::GroundSatTag")
-                          .SetParent<Tag> ()
-                          .SetGroupName ("ICARUS")
-                          .AddConstructor<GroundSatTag> ();
-  return tid;
-}
-TypeId
-GroundSatTag::GetInstanceTypeId (void) const
-{
-  return GetTypeId ();
-}
-
-uint32_t
-GroundSatTag::GetSerializedSize (void) const
-{
-  return 8 + 8 + 2 + 8;
-}
-void
-GroundSatTag::Serialize (TagBuffer i) const
-{
-  uint8_t mac[6];
-  m_dst.CopyTo (mac);
-  i.Write (mac, 6);
-  i.WriteU16 (m_protocolNumber);
-  i.WriteDouble (m_power);
-}
-void
-GroundSatTag::Deserialize (TagBuffer i)
-{
-  uint8_t mac[6];
-
-  i.Read (mac, 6);
-  m_dst.CopyFrom (mac);
-  m_protocolNumber = i.ReadU16 ();
-  m_power = i.ReadDouble ();
-}
-
-void
-GroundSatTag::Print (std::ostream &os) const
-{
-  os << " dst=" << m_dst << " proto=" << m_protocolNumber << " power=" << m_power;
-}
-} // namespace
-
 TypeId
 GroundStaNetDevice::GetTypeId (void)
 {
@@ -185,8 +54,18 @@ GroundStaNetDevice::GetTypeId (void)
                          MakeMac48AddressChecker ())
           .AddAttribute ("RemoteAddress", "The link-layer address of the remote satellite",
                          SatAddressValue (SatAddress (0, 0, 0)),
-                         MakeSatAddressAccessor (&GroundStaNetDevice::m_remoteAddress),
+                         MakeSatAddressAccessor (
+                             static_cast<void (GroundStaNetDevice::*) (const SatAddress &)> (
+                                 &GroundStaNetDevice::SetRemoteAddress),
+                             &GroundStaNetDevice::GetRemoteSatAddress),
                          MakeSatAddressChecker ())
+          .AddAttribute ("PromiscuousDownlink",
+                         "Receive the transmissions of every satellite, not only those of the "
+                         "tracked one",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&GroundStaNetDevice::SetPromiscuousDownlink,
+                                              &GroundStaNetDevice::IsPromiscuousDownlink),
+                         MakeBooleanChecker ())
           .AddAttribute ("MacModelTx", "The MAC protocol for transmitted frames", PointerValue (),
                          MakePointerAccessor (&GroundStaNetDevice::m_macModel),
                          MakePointerChecker<MacModel> ())
@@ -203,6 +82,20 @@ GroundStaNetDevice::~GroundStaNetDevice ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+void
+GroundStaNetDevice::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Let the MAC model check its configuration before the first frame
+  if (m_macModel != nullptr)
+    {
+      m_macModel->Initialize ();
+    }
+
+  IcarusNetDevice::DoInitialize ();
+}
+
 bool
 GroundStaNetDevice::Attach (const Ptr<GroundSatChannel> &channel)
 {
@@ -221,9 +114,8 @@ GroundStaNetDevice::ReceiveFromSat (const Ptr<Packet> &packet, DataRate bps, con
 {
   NS_LOG_FUNCTION (this << packet << bps << src << protocolNumber << rxPower);
 
-  if (SatAddress::ConvertFrom (src) != m_remoteAddress)
+  if (!IsListening (src, Simulator::Now ()))
     {
-      NS_LOG_LOGIC ("Ignoring packet from non-tracked satellite:" << src);
       return;
     }
 
@@ -233,6 +125,56 @@ GroundStaNetDevice::ReceiveFromSat (const Ptr<Packet> &packet, DataRate bps, con
                        protocolNumber);
 }
 
+void
+GroundStaNetDevice::ReceiveFromSatCutThrough (const Ptr<Packet> &packet, DataRate bps,
+                                              const Address &src, uint16_t protocolNumber,
+                                              double rxPower)
+{
+  NS_LOG_FUNCTION (this << packet << bps << src << protocolNumber << rxPower);
+
+  // Decide as ReceiveFromSat would have done when the reception started
+  if (!IsListening (src, Simulator::Now () - bps.CalculateBytesTxTime (packet->GetSize ())))
+    {
+      return;
+    }
+
+  m_phyRxBeginTrace (packet);
+  ReceiveFromSatFinish (packet, src, protocolNumber);
+}
+
+void
+GroundStaNetDevice::SaveListeningState ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // Several changes at once only move away from the state before the first one
+  if (m_listeningChange != Simulator::Now ())
+    {
+      m_listeningChange = Simulator::Now ();
+      m_previousRemoteAddress = m_remoteAddress;
+      m_previousPromiscuousDownlink = m_promiscuousDownlink;
+    }
+}
+
+bool
+GroundStaNetDevice::IsListening (const Address &src, Time start) const
+{
+  NS_LOG_FUNCTION (this << src << start);
+
+  // Only the last change is remembered. Frames that started before an earlier one are checked
+  // against the state in between.
+  const auto before = start < m_listeningChange;
+  const auto promiscuous = before ? m_previousPromiscuousDownlink : m_promiscuousDownlink;
+  const auto &remoteAddress = before ? m_previousRemoteAddress : m_remoteAddress;
+  if (!promiscuous && SatAddress::ConvertFrom (src) != remoteAddress)
+    {
+      NS_LOG_LOGIC ("Ignoring packet from non-tracked satellite:" << src);
+      return false;
+    }
+
+  return true;
+}
+
 void
 GroundStaNetDevice::ReceiveFromSatFinish (const Ptr<Packet> &packet, const Address &src,
                                           uint16_t protocolNumber)
@@ -305,11 +247,41 @@ GroundStaNetDevice::SetRemoteAddress (const SatAddress &address)
 
   if (m_remoteAddress != address)
     {
+      SaveListeningState ();
       remoteAddressChange (m_remoteAddress, address);
     }
   m_remoteAddress = address;
 }
 
+SatAddress
+GroundStaNetDevice::GetRemoteSatAddress () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_remoteAddress;
+}
+
+bool
+GroundStaNetDevice::IsPromiscuousDownlink () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_promiscuousDownlink;
+}
+
+void
+GroundStaNetDevice::SetPromiscuousDownlink (bool promiscuous)
+{
+  NS_LOG_FUNCTION (this << promiscuous);
+
+  if (m_promiscuousDownlink != promiscuous)
+    {
+      SaveListeningState ();
+      m_promiscuousDownlink = promiscuous;
+      promiscuousDownlinkChange (promiscuous);
+    }
+}
+
 Address
 GroundStaNetDevice::GetBroadcast (void) const
 {
@@ -364,18 +336,13 @@ GroundStaNetDevice::Send (Ptr<Packet> packet, const Address &, uint16_t protocol
   NS_LOG_FUNCTION (this << packet << protocolNumber);
   NS_LOG_WARN ("The protocol number should really be transmitted in a header somehow");
 
-  GroundSatTag tag;
-  tag.SetDst (m_remoteAddress);
-  tag.SetProto (protocolNumber);
-  tag.SetPower (GetTxPower ());
-  packet->AddPacketTag (tag);
-
   m_macTxTrace (packet);
   if (GetQueue ()->Enqueue (packet) == false)
     {
       m_macTxDropTrace (packet);
       return false;
     }
+  m_txMetadata.Push (packet, {m_remoteAddress, protocolNumber, GetTxPower ()});
 
   if (m_txMachineState == IDLE)
     {
@@ -395,11 +362,10 @@ GroundStaNetDevice::TransmitStart ()
   m_txMachineState = BUSY;
   auto packet = GetQueue ()->Dequeue ();
 
-  GroundSatTag tag;
-  packet->PeekPacketTag (tag);
-  const auto dst = tag.GetDst ();
-  const auto proto = tag.GetProto ();
-  const auto power = tag.GetPower ();
+  const auto metadata = m_txMetadata.Pop (packet);
+  const auto dst = metadata.dst;
+  const auto proto = metadata.protocolNumber;
+  const auto power = metadata.power;
 
   m_macModel->Send (
       packet,
@@ -420,8 +386,6 @@ GroundStaNetDevice::TransmitComplete (const Ptr<Packet> &packet)
 {
   NS_LOG_FUNCTION (this << packet);
 
-  GroundSatTag tag;
-  packet->RemovePacketTag (tag);
   m_txMachineState = IDLE;
 
   if (GetQueue ()->IsEmpty () == false)
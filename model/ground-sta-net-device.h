@@ -49,6 +49,9 @@ public:
 
   void ReceiveFromSat (const Ptr<Packet> &packet, DataRate bps, const Address &src,
                        uint16_t protocolNumber, double rxPower);
+  // Receive a whole frame in a single event at the end of its reception
+  void ReceiveFromSatCutThrough (const Ptr<Packet> &packet, DataRate bps, const Address &src,
+                                 uint16_t protocolNumber, double rxPower);
 
   Address GetAddress () const override;
   void SetAddress (Address address) override;
@@ -56,6 +59,9 @@ public:
   Address GetRemoteAddress () const;
   void SetRemoteAddress (const Address &address);
   void SetRemoteAddress (const SatAddress &address);
+  // Whether the device accepts transmissions from any satellite, not just the tracked one
+  bool IsPromiscuousDownlink () const;
+  void SetPromiscuousDownlink (bool promiscuous);
 
   virtual void AddLinkChangeCallback (Callback<void> callback) override;
   virtual bool IsBroadcast (void) const override;
@@ -83,6 +89,12 @@ public:
   ::ndn::util::signal::Signal<GroundStaNetDevice, const SatAddress & /*old*/,
                               const SatAddress & /*new*/>
       remoteAddressChange;
+  /** \brief signals when the device starts or stops listening to every satellite
+   */
+  ::ndn::util::signal::Signal<GroundStaNetDevice, bool /*promiscuous*/> promiscuousDownlinkChange;
+
+protected:
+  virtual void DoInitialize (void) override;
 
 private:
   enum { IDLE, BUSY } m_txMachineState = IDLE;
@@ -90,7 +102,26 @@ private:
 
   Mac48Address m_localAddress;
   SatAddress m_remoteAddress;
-
+  bool m_promiscuousDownlink = false;
+  // Remote address and promiscuity before the last change, which took place at
+  // m_listeningChange, for the frames that started earlier
+  Time m_listeningChange;
+  SatAddress m_previousRemoteAddress;
+  bool m_previousPromiscuousDownlink = false;
+
+  struct TxMetadata
+  {
+    SatAddress dst;
+    uint16_t protocolNumber;
+    double power;
+  };
+  TxMetadataQueue<TxMetadata> m_txMetadata;
+
+  SatAddress GetRemoteSatAddress () const;
+  // Keep the current listening state before changing it
+  void SaveListeningState ();
+  // Whether the reception of a transmission from the satellite src starting at start is accepted
+  bool IsListening (const Address &src, Time start) const;
   void ReceiveFromSatFinish (const Ptr<Packet> &packet, const Address &src,
                              uint16_t protocolNumber);
   void TransmitStart ();
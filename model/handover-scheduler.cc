@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "handover-scheduler.h"
+
+#include "ground-node-sat-tracker.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.HandoverScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (HandoverScheduler);
+
+TypeId
+HandoverScheduler::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::icarus::HandoverScheduler")
+          .SetParent<Object> ()
+          .SetGroupName ("ICARUS")
+          .AddConstructor<HandoverScheduler> ()
+          .AddTraceSource ("Handover",
+                           "A ground station has changed the satellite it is tracking",
+                           MakeTraceSourceAccessor (&HandoverScheduler::m_handoverTrace),
+                           "ns3::icarus::HandoverScheduler::HandoverTracedCallback");
+
+  return tid;
+}
+
+HandoverScheduler::HandoverScheduler () : m_sequence (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HandoverScheduler::~HandoverScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HandoverScheduler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_event);
+  m_calendar = decltype (m_calendar) ();
+  m_pending.clear ();
+
+  Object::DoDispose ();
+}
+
+void
+HandoverScheduler::Schedule (GroundNodeSatTracker *tracker, Time t)
+{
+  NS_LOG_FUNCTION (this << tracker << t);
+  NS_ASSERT_MSG (t >= Simulator::Now (), "Cannot schedule an update in the past");
+
+  m_pending[tracker] = ++m_sequence;
+  m_calendar.push ({t, m_sequence, tracker});
+
+  Reschedule ();
+}
+
+void
+HandoverScheduler::Cancel (GroundNodeSatTracker *tracker)
+{
+  NS_LOG_FUNCTION (this << tracker);
+
+  // The calendar entry is discarded when it reaches the top
+  m_pending.erase (tracker);
+}
+
+std::size_t
+HandoverScheduler::GetNPending () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_pending.size ();
+}
+
+void
+HandoverScheduler::NotifyHandover (Ptr<Node> ground, const Address &oldAddress,
+                                   const Address &newAddress)
+{
+  NS_LOG_FUNCTION (this << ground << oldAddress << newAddress);
+
+  m_handoverTrace (ground, oldAddress, newAddress);
+}
+
+void
+HandoverScheduler::Reschedule ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // Drop cancelled and superseded entries
+  while (!m_calendar.empty ())
+    {
+      const auto &top = m_calendar.top ();
+      const auto pending = m_pending.find (top.tracker);
+      if (pending != m_pending.end () && pending->second == top.sequence)
+        {
+          break;
+        }
+      m_calendar.pop ();
+    }
+
+  if (m_calendar.empty ())
+    {
+      Simulator::Cancel (m_event);
+      return;
+    }
+
+  const auto next = m_calendar.top ().time;
+  if (m_event.IsRunning () && m_eventTime == next)
+    {
+      return;
+    }
+
+  Simulator::Cancel (m_event);
+  m_eventTime = next;
+  m_event = Simulator::Schedule (next - Simulator::Now (), &HandoverScheduler::Expire, this);
+}
+
+void
+HandoverScheduler::Expire ()
+{
+  NS_LOG_FUNCTION (this);
+
+  const auto now = Simulator::Now ();
+
+  std::size_t nDue = 0;
+  while (!m_calendar.empty () && m_calendar.top ().time <= now)
+    {
+      const auto entry = m_calendar.top ();
+      m_calendar.pop ();
+
+      const auto pending = m_pending.find (entry.tracker);
+      if (pending == m_pending.end () || pending->second != entry.sequence)
+        {
+          continue;
+        }
+      m_pending.erase (pending);
+      nDue++;
+
+      // The tracker moves to the node context by itself if it hands over
+      if (const auto next = entry.tracker->Track ())
+        {
+          m_pending[entry.tracker] = ++m_sequence;
+          m_calendar.push ({*next, m_sequence, entry.tracker});
+        }
+    }
+
+  NS_LOG_DEBUG ("Ran " << nDue << " tracker updates");
+
+  Reschedule ();
+}
+
+} // namespace icarus
+} // namespace ns3
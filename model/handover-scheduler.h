@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef HANDOVER_SCHEDULER_H
+#define HANDOVER_SCHEDULER_H
+
+#include "ns3/address.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+class Node;
+
+namespace icarus {
+
+class GroundNodeSatTracker;
+
+/**
+ * \ingroup icarus
+ *
+ * \brief Calendar of the next tracking update of every ground station of a constellation.
+ *
+ * Instead of every tracker keeping its own recurring event in the simulator, trackers register
+ * the time of their next update here. The scheduler keeps a single simulator event for the
+ * earliest entry. When it expires, it runs every update due at that instant in a row, in the
+ * context of that event. Only the updates ending in a handover schedule an event of their own, in
+ * the context of the node of the tracker.
+ */
+class HandoverScheduler : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  HandoverScheduler ();
+  virtual ~HandoverScheduler ();
+
+  // Call tracker->Track () at time t, replacing any pending update of tracker
+  void Schedule (GroundNodeSatTracker *tracker, Time t);
+  void Cancel (GroundNodeSatTracker *tracker);
+  std::size_t GetNPending () const noexcept;
+
+  void NotifyHandover (Ptr<Node> ground, const Address &oldAddress, const Address &newAddress);
+
+  typedef void (*HandoverTracedCallback) (Ptr<Node> ground, const Address &oldAddress,
+                                          const Address &newAddress);
+
+private:
+  struct Entry
+  {
+    Time time;
+    std::uint64_t sequence;
+    GroundNodeSatTracker *tracker;
+
+    bool
+    operator> (const Entry &other) const noexcept
+    {
+      return time != other.time ? time > other.time : sequence > other.sequence;
+    }
+  };
+
+  virtual void DoDispose (void) override;
+
+  void Reschedule ();
+  void Expire ();
+
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> m_calendar;
+  // Sequence number of the valid entry of every tracker. Older entries are skipped.
+  std::unordered_map<GroundNodeSatTracker *, std::uint64_t> m_pending;
+  std::uint64_t m_sequence;
+  EventId m_event;
+  Time m_eventTime;
+
+  TracedCallback<Ptr<Node>, const Address &, const Address &> m_handoverTrace;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* HANDOVER_SCHEDULER_H */
@@ -23,11 +23,15 @@
 #ifndef ICARUS_NET_DEVICE_H
 #define ICARUS_NET_DEVICE_H
 
+#include "ns3/assert.h"
 #include "ns3/net-device.h"
 #include "ns3/data-rate.h"
 #include "ns3/queue.h"
 #include "ns3/ground-sat-channel.h"
 
+#include <deque>
+#include <utility>
+
 namespace ns3 {
 namespace icarus {
 
@@ -91,6 +95,42 @@ public:
   virtual double GetTxPower (void) const;
 
 protected:
+  /**
+   * Transmission parameters of the packets waiting in a queue, kept next to it instead of in
+   * packet tags. Entries follow the queue order, so the ones of packets the queue dropped are
+   * skipped when a later packet leaves it.
+   */
+  template <typename Metadata>
+  class TxMetadataQueue
+  {
+  public:
+    // Call after packet is accepted by the queue
+    void
+    Push (const Ptr<Packet> &packet, const Metadata &metadata)
+    {
+      m_entries.emplace_back (packet, metadata);
+    }
+
+    // Call with each packet leaving the queue
+    Metadata
+    Pop (const Ptr<Packet> &packet)
+    {
+      while (!m_entries.empty () && m_entries.front ().first != packet)
+        {
+          m_entries.pop_front ();
+        }
+      NS_ASSERT_MSG (!m_entries.empty (), "Packet " << packet << " was never queued");
+
+      const auto metadata = m_entries.front ().second;
+      m_entries.pop_front ();
+
+      return metadata;
+    }
+
+  private:
+    std::deque<std::pair<Ptr<Packet>, Metadata>> m_entries;
+  };
+
   TracedCallback<> m_linkChangeCallbacks;
   TracedCallback<Ptr<const Packet>> m_macTxTrace, m_macTxDropTrace, m_macRxTrace, m_phyTxBeginTrace,
       m_phyTxEndTrace, m_phyRxBeginTrace, m_phyRxEndTrace, m_snifferTrace;
@@ -0,0 +1,292 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "isl-fabric.h"
+
+#include "circular-orbit.h"
+#include "sat-net-device.h"
+#include "sat2sat-success-model.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.IslFabric");
+
+NS_OBJECT_ENSURE_REGISTERED (IslFabric);
+
+TypeId
+IslFabric::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::icarus::IslFabric")
+          .SetParent<Channel> ()
+          .SetGroupName ("ICARUS")
+          .AddConstructor<IslFabric> ()
+          .AddAttribute ("TxSuccess",
+                         "The object used to decide whether there is sufficient "
+                         "visibility for a successful transmission",
+                         PointerValue (), MakePointerAccessor (&IslFabric::m_txSuccessModel),
+                         MakePointerChecker<Sat2SatSuccessModel> ())
+          .AddAttribute ("PropDelayModel", "Object used to calculate the propagation delay",
+                         PointerValue (), MakePointerAccessor (&IslFabric::m_propDelayModel),
+                         MakePointerChecker<PropagationDelayModel> ())
+          .AddAttribute ("CutThrough",
+                         "Deliver every frame in a single event at the end of its reception, "
+                         "instead of one at its start and another one at its end. The PhyRxBegin "
+                         "and PhyRxEnd traces of the receiver are fired back to back.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&IslFabric::m_cutThrough),
+                         MakeBooleanChecker ())
+          .AddTraceSource ("PhyTxDrop",
+                           "Trace source indicating a packet has been dropped by the channel",
+                           MakeTraceSourceAccessor (&IslFabric::m_phyTxDropTrace),
+                           "ns3::Packet::TracedCallback");
+
+  return tid;
+}
+
+IslFabric::IslFabric () : Channel (), m_nPlanes (0), m_planeSize (0), m_cutThrough (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+IslFabric::~IslFabric ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+IslFabric::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_slots.clear ();
+  m_mobility.clear ();
+  m_devices.clear ();
+  m_txSuccessModel = nullptr;
+  m_propDelayModel = nullptr;
+
+  Channel::DoDispose ();
+}
+
+void
+IslFabric::SetTopology (std::size_t nPlanes, std::size_t planeSize)
+{
+  NS_LOG_FUNCTION (this << nPlanes << planeSize);
+  NS_ABORT_MSG_UNLESS (m_devices.empty (), "Cannot change the topology of a fabric in use");
+
+  m_nPlanes = nPlanes;
+  m_planeSize = planeSize;
+
+  const auto nSatellites = nPlanes * planeSize;
+  m_slots.assign (nSatellites * N_DIRECTIONS, nullptr);
+  m_mobility.assign (nSatellites, nullptr);
+  m_linkUp.assign (2 * nSatellites, 0);
+  m_distance.assign (2 * nSatellites, 0.0);
+  m_distanceTime.assign (2 * nSatellites, -1);
+}
+
+std::size_t
+IslFabric::GetSlot (std::size_t plane, std::size_t index, Direction direction) const
+{
+  NS_LOG_FUNCTION (this << plane << index << direction);
+  NS_ASSERT (plane < m_nPlanes && index < m_planeSize && direction < N_DIRECTIONS);
+
+  return (plane * m_planeSize + index) * N_DIRECTIONS + direction;
+}
+
+std::size_t
+IslFabric::GetPeerSlot (std::size_t slot) const
+{
+  NS_LOG_FUNCTION (this << slot);
+  NS_ASSERT (slot < m_slots.size ());
+
+  const auto satellite = slot / N_DIRECTIONS;
+  const auto plane = satellite / m_planeSize, index = satellite % m_planeSize;
+
+  switch (slot % N_DIRECTIONS)
+    {
+    case NEXT_IN_PLANE:
+      return GetSlot (plane, (index + 1) % m_planeSize, PREVIOUS_IN_PLANE);
+    case PREVIOUS_IN_PLANE:
+      return GetSlot (plane, (index + m_planeSize - 1) % m_planeSize, NEXT_IN_PLANE);
+    case NEXT_PLANE:
+      return GetSlot ((plane + 1) % m_nPlanes, index, PREVIOUS_PLANE);
+    default:
+      return GetSlot ((plane + m_nPlanes - 1) % m_nPlanes, index, NEXT_PLANE);
+    }
+}
+
+std::size_t
+IslFabric::GetLink (std::size_t slot) const
+{
+  switch (slot % N_DIRECTIONS)
+    {
+    case NEXT_IN_PLANE:
+    case NEXT_PLANE:
+      return 2 * (slot / N_DIRECTIONS) + (slot % N_DIRECTIONS == NEXT_PLANE);
+    default:
+      return GetLink (GetPeerSlot (slot));
+    }
+}
+
+bool
+IslFabric::Attach (const Ptr<SatNetDevice> &device, std::size_t slot)
+{
+  NS_LOG_FUNCTION (this << device << slot);
+  NS_ABORT_MSG_UNLESS (slot < m_slots.size (), "Slot " << slot << " out of the fabric");
+  NS_ABORT_MSG_UNLESS (m_slots[slot] == nullptr, "Slot " << slot << " already in use");
+
+  const auto peer = GetPeerSlot (slot);
+  NS_ABORT_MSG_IF (peer / N_DIRECTIONS == slot / N_DIRECTIONS,
+                   "A satellite cannot be linked to itself");
+
+  const auto satellite = slot / N_DIRECTIONS;
+  if (m_mobility[satellite] == nullptr)
+    {
+      m_mobility[satellite] = device->GetNode ()->GetObject<MobilityModel> ();
+      NS_ABORT_MSG_UNLESS (m_mobility[satellite] != nullptr, "Satellites need a mobility model");
+    }
+
+  if (m_devices.empty () && m_txSuccessModel != nullptr)
+    {
+      m_txSuccessModel->CalcMaxDistance (
+          device->GetNode ()->GetObject<CircularOrbitMobilityModel> ()->getRadius ());
+    }
+
+  m_slots[slot] = device;
+  m_devices.push_back (device);
+
+  if (m_slots[peer] != nullptr)
+    {
+      m_linkUp[GetLink (slot)] = 1;
+      m_slots[peer]->NotifyLinkChange ();
+    }
+
+  return true;
+}
+
+Ptr<SatNetDevice>
+IslFabric::GetPeer (std::size_t slot) const
+{
+  NS_LOG_FUNCTION (this << slot);
+
+  return m_slots[GetPeerSlot (slot)];
+}
+
+bool
+IslFabric::IsLinkUp (std::size_t slot) const
+{
+  NS_LOG_FUNCTION (this << slot);
+
+  return m_linkUp[GetLink (slot)] != 0;
+}
+
+double
+IslFabric::GetDistance (std::size_t slot) const
+{
+  NS_LOG_FUNCTION (this << slot);
+  NS_ASSERT (IsLinkUp (slot));
+
+  const auto link = GetLink (slot);
+  const auto now = Simulator::Now ().GetTimeStep ();
+  if (m_distanceTime[link] != now)
+    {
+      m_distanceTime[link] = now;
+      m_distance[link] = m_mobility[slot / N_DIRECTIONS]->GetDistanceFrom (
+          m_mobility[GetPeerSlot (slot) / N_DIRECTIONS]);
+    }
+
+  return m_distance[link];
+}
+
+Time
+IslFabric::TransmitStart (const Ptr<Packet> &packet, std::size_t slot, DataRate bps,
+                          uint16_t protocolNumber) const
+{
+  NS_LOG_FUNCTION (this << packet << slot << bps << protocolNumber);
+  NS_ASSERT (IsLinkUp (slot));
+
+  const auto peer = GetPeerSlot (slot);
+  const auto &dst = m_slots[peer];
+
+  Time endTx = bps.CalculateBytesTxTime (packet->GetSize ());
+  const auto distance = GetDistance (slot);
+
+  if (m_txSuccessModel != nullptr && m_txSuccessModel->TramsmitSuccess (distance, packet) != true)
+    {
+      NS_LOG_ERROR ("DROP PACKET, DISTANCE: " << distance);
+      m_phyTxDropTrace (packet);
+    }
+  else
+    {
+      // This is what the constant speed model computes, without looking up the positions again
+      const auto constantSpeed = DynamicCast<ConstantSpeedPropagationDelayModel> (m_propDelayModel);
+      const Time delay = constantSpeed != nullptr
+                             ? Seconds (distance / constantSpeed->GetSpeed ())
+                             : m_propDelayModel->GetDelay (m_mobility[slot / N_DIRECTIONS],
+                                                           m_mobility[peer / N_DIRECTIONS]);
+      if (m_cutThrough)
+        {
+          Simulator::ScheduleWithContext (dst->GetNode ()->GetId (), delay + endTx,
+                                          &SatNetDevice::ReceiveCutThrough, dst, packet,
+                                          protocolNumber);
+        }
+      else
+        {
+          Simulator::ScheduleWithContext (dst->GetNode ()->GetId (), delay,
+                                          &SatNetDevice::Receive, dst, packet, bps,
+                                          protocolNumber);
+        }
+    }
+
+  return endTx;
+}
+
+std::size_t
+IslFabric::GetNDevices (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_devices.size ();
+}
+
+Ptr<NetDevice>
+IslFabric::GetDevice (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  NS_ABORT_MSG_UNLESS (i < GetNDevices (),
+                       "Asking for " << i << "-th device of a total of " << GetNDevices ());
+
+  return m_devices[i];
+}
+
+} // namespace icarus
+} // namespace ns3
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef ISL_FABRIC_H
+#define ISL_FABRIC_H
+
+#include "ns3/channel.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+class Packet;
+class PropagationDelayModel;
+
+namespace icarus {
+
+class SatNetDevice;
+class Sat2SatSuccessModel;
+
+/**
+ * \ingroup icarus
+ *
+ * \brief All the inter satellite links of a +Grid constellation in a single channel.
+ *
+ * Every satellite has up to four link ends, or slots: towards the next and previous satellites of
+ * its plane, and towards the satellites with the same index in the next and previous planes. A
+ * slot is identified by (plane * planeSize + index) * N_DIRECTIONS + direction, and the slot at
+ * the other end of the link follows from the topology, so the fabric only keeps flat arrays of
+ * devices, link states and distances instead of a channel, a success model and a delay model per
+ * link.
+ */
+class IslFabric : public Channel
+{
+public:
+  enum Direction : std::uint8_t {
+    NEXT_IN_PLANE,
+    PREVIOUS_IN_PLANE,
+    NEXT_PLANE,
+    PREVIOUS_PLANE,
+    N_DIRECTIONS
+  };
+
+  static TypeId GetTypeId (void);
+
+  IslFabric ();
+  virtual ~IslFabric ();
+
+  // Size the fabric for a constellation of nPlanes planes of planeSize satellites
+  void SetTopology (std::size_t nPlanes, std::size_t planeSize);
+
+  std::size_t GetSlot (std::size_t plane, std::size_t index, Direction direction) const;
+  // The slot at the other end of the link
+  std::size_t GetPeerSlot (std::size_t slot) const;
+
+  bool Attach (const Ptr<SatNetDevice> &device, std::size_t slot);
+  Ptr<SatNetDevice> GetPeer (std::size_t slot) const;
+  // Whether both ends of the link are attached
+  bool IsLinkUp (std::size_t slot) const;
+  // Current distance between the satellites at both ends of the link, in meters
+  double GetDistance (std::size_t slot) const;
+
+  Time TransmitStart (const Ptr<Packet> &packet, std::size_t slot, DataRate bps,
+                      uint16_t protocolNumber) const;
+
+  virtual std::size_t GetNDevices (void) const override;
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const override;
+
+private:
+  virtual void DoDispose (void) override;
+
+  // The link of a slot, 2 * satellite + 0 for the link to the next satellite in the plane and
+  // 2 * satellite + 1 for the one to the next plane, shared with its peer slot
+  std::size_t GetLink (std::size_t slot) const;
+
+  std::size_t m_nPlanes, m_planeSize;
+  Ptr<Sat2SatSuccessModel> m_txSuccessModel;
+  Ptr<PropagationDelayModel> m_propDelayModel;
+  bool m_cutThrough;
+
+  // Indexed by slot
+  std::vector<Ptr<SatNetDevice>> m_slots;
+  // Indexed by satellite
+  std::vector<Ptr<MobilityModel>> m_mobility;
+  // Indexed by link. Distances are computed at most once per time step.
+  std::vector<std::uint8_t> m_linkUp;
+  mutable std::vector<double> m_distance;
+  mutable std::vector<int64_t> m_distanceTime;
+  // In attachment order
+  std::vector<Ptr<SatNetDevice>> m_devices;
+
+  TracedCallback<Ptr<const Packet>> m_phyTxDropTrace;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* ISL_FABRIC_H */
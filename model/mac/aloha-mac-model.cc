@@ -19,9 +19,12 @@
  */
 
 #include "aloha-mac-model.h"
+#include "private/slot-receiver.h"
+#include "ns3/abort.h"
 #include "ns3/log-macros-enabled.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 
 namespace ns3 {
@@ -45,15 +48,39 @@ AlohaMacModel::GetTypeId (void)
           .AddAttribute ("SirThreshold", "The SIR threshold in dB (no capture effect by default)",
                          DoubleValue (std::numeric_limits<double>::max ()),
                          MakeDoubleAccessor (&AlohaMacModel::m_sirThreshold),
-                         MakeDoubleChecker<double> ());
+                         MakeDoubleChecker<double> ())
+          .AddAttribute ("SlotSynchronous",
+                         "Resolve all the receptions of a slot together at its end, instead of "
+                         "every reception at its own end. Receptions are assumed to be aligned "
+                         "to the slots. Needs a SlotDuration.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&AlohaMacModel::m_slotSynchronous),
+                         MakeBooleanChecker ());
   return tid;
 }
 
-AlohaMacModel::AlohaMacModel () : m_busyPeriodPacketUid (boost::none), m_busyPeriodCollision (false)
+AlohaMacModel::AlohaMacModel ()
+    : m_busyPeriodPacketUid (boost::none), m_busyPeriodCollision (false), m_slotSynchronous (false)
 {
   NS_LOG_FUNCTION (this);
 }
 
+AlohaMacModel::~AlohaMacModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+AlohaMacModel::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_ABORT_MSG_IF (m_slotSynchronous && !m_slotDuration.IsStrictlyPositive (),
+                   "Slot synchronous reception needs a positive SlotDuration");
+
+  MacModel::DoInitialize ();
+}
+
 void
 AlohaMacModel::Send (const Ptr<Packet> &packet, std::function<Time (void)> transmit_callback,
                      std::function<void (void)> finish_callback)
@@ -102,6 +129,19 @@ AlohaMacModel::StartPacketRx (const Ptr<Packet> &packet, Time packet_tx_time, do
   NS_LOG_FUNCTION (this << packet << packet_tx_time << rx_power << &net_device_cb);
 
   double rx_power_mw = pow (10, rx_power / 10.0);
+  if (m_slotSynchronous)
+    {
+      if (m_slotReceiver == nullptr)
+        {
+          m_slotReceiver = std::make_unique<SlotReceiver> (
+              m_slotDuration, [this] (std::vector<SlotArrival> &arrivals, double total_power) {
+                FinishSlot (arrivals, total_power);
+              });
+        }
+      m_slotReceiver->Receive (packet->GetUid (), packet_tx_time, rx_power_mw, net_device_cb);
+      return;
+    }
+
   Time now = Simulator::Now ();
   if (m_busyPeriodPacketUid && now < m_busyPeriodFinishTime)
     {
@@ -167,5 +207,24 @@ AlohaMacModel::FinishReception (const Ptr<Packet> &packet, double rx_power,
     }
 }
 
+void
+AlohaMacModel::FinishSlot (std::vector<SlotArrival> &arrivals, double total_power)
+{
+  NS_LOG_FUNCTION (this << arrivals.size () << total_power);
+
+  for (const auto &arrival : arrivals)
+    {
+      if (SlotReceiver::IsCaptured (arrival.power, total_power, m_sirThreshold))
+        {
+          NS_LOG_LOGIC ("Packet " << arrival.uid << " correctly received");
+          arrival.callback ();
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Packet " << arrival.uid << " discarded due to collision");
+        }
+    }
+}
+
 } // namespace icarus
 } // namespace ns3
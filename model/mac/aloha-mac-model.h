@@ -28,20 +28,30 @@
 
 #include <boost/optional.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace ns3 {
 namespace icarus {
 
+class SlotReceiver;
+struct SlotArrival;
+
 class AlohaMacModel : public MacModel
 {
 public:
   static TypeId GetTypeId (void);
   AlohaMacModel ();
+  virtual ~AlohaMacModel ();
 
   virtual void Send (const Ptr<Packet> &packet, std::function<Time (void)> transmit_callback,
                      std::function<void (void)> finish_callback) override;
   virtual void StartPacketRx (const Ptr<Packet> &packet, Time packet_tx_time, double rx_power,
                               std::function<void (void)>) override;
 
+protected:
+  virtual void DoInitialize (void) override;
+
 private:
   Time m_slotDuration;
   double m_sirThreshold;
@@ -49,11 +59,14 @@ private:
   Time m_busyPeriodFinishTime;
   bool m_busyPeriodCollision;
   double m_busyPeriodInterferencePower;
+  bool m_slotSynchronous;
+  std::unique_ptr<SlotReceiver> m_slotReceiver;
 
   void DoSend (const Ptr<Packet> &packet, std::function<Time (void)> transmit_callback,
                std::function<void (void)> finish_callback) const;
   void FinishTransmission (std::function<void (void)>) const;
   void FinishReception (const Ptr<Packet> &packet, double rx_power, std::function<void (void)>);
+  void FinishSlot (std::vector<SlotArrival> &arrivals, double total_power);
 };
 
 } // namespace icarus
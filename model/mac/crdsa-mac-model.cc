@@ -21,17 +21,20 @@
 #include "crdsa-mac-model.h"
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
-#include "private/busy-period.h"
+#include "private/sic-decoder.h"
+#include "private/slot-receiver.h"
 #include "ns3/assert.h"
 #include "ns3/log-macros-disabled.h"
 #include "ns3/log-macros-enabled.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
 #include <algorithm>
 #include <limits>
+#include <memory>
 
 namespace ns3 {
 namespace icarus {
@@ -83,7 +86,10 @@ CrdsaMacModel::GetTypeId (void)
           .AddConstructor<CrdsaMacModel> ()
           .AddAttribute ("SlotDuration", "The duration of a slot", TimeValue (Seconds (0)),
                          MakeTimeAccessor (&CrdsaMacModel::m_slotDuration), MakeTimeChecker ())
-          .AddAttribute ("SlotsPerFrame", "The number of slots in a frame", UintegerValue (1),
+          .AddAttribute ("SlotsPerFrame",
+                         "The number of slots in a frame (0 for the fewest that fit every "
+                         "replica of a packet)",
+                         UintegerValue (0),
                          MakeUintegerAccessor (&CrdsaMacModel::SetSlotsPerFrame,
                                                &CrdsaMacModel::GetSlotsPerFrame),
                          MakeUintegerChecker<uint16_t> ())
@@ -98,7 +104,14 @@ CrdsaMacModel::GetTypeId (void)
           .AddAttribute ("SirThreshold", "The SIR threshold in dB (no capture effect by default)",
                          DoubleValue (std::numeric_limits<double>::max ()),
                          MakeDoubleAccessor (&CrdsaMacModel::m_sirThreshold),
-                         MakeDoubleChecker<double> ());
+                         MakeDoubleChecker<double> ())
+          .AddAttribute ("SlotSynchronous",
+                         "Resolve all the receptions of a slot together at its end, instead of "
+                         "every reception at its own end. Receptions are assumed to be aligned "
+                         "to the slots.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&CrdsaMacModel::m_slotSynchronous),
+                         MakeBooleanChecker ());
 
   return tid;
 }
@@ -107,13 +120,39 @@ CrdsaMacModel::CrdsaMacModel ()
     : m_busyPeriodPacketUid (boost::none),
       m_busyPeriodCollision (false),
       m_busyPeriodCollidedPackets (),
-      m_activeBusyPeriods (),
-      m_activeReceivedPackets (),
+      m_decoder (std::make_unique<SicDecoder> ()),
+      m_slotSynchronous (false),
       m_rng (CreateObject<UniformRandomVariable> ())
 {
   NS_LOG_FUNCTION (this);
 }
 
+CrdsaMacModel::~CrdsaMacModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CrdsaMacModel::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  const auto maxReplicas = GetMaxReplicasPerPacket ();
+  if (GetSlotsPerFrame () == 0)
+    {
+      SetSlotsPerFrame (maxReplicas);
+    }
+  NS_ABORT_MSG_IF (maxReplicas > GetSlotsPerFrame (),
+                   GetInstanceTypeId ().GetName ()
+                       << " sends up to " << maxReplicas << " replicas of a packet, but there are "
+                       << GetSlotsPerFrame ()
+                       << " slots per frame. Raise SlotsPerFrame or lower the replicas.");
+  NS_ABORT_MSG_IF (IsSlotSynchronous () && !m_slotDuration.IsStrictlyPositive (),
+                   "Slot synchronous reception needs a positive SlotDuration");
+
+  MacModel::DoInitialize ();
+}
+
 uint16_t
 CrdsaMacModel::NumReplicasPerPacket (void)
 {
@@ -126,6 +165,42 @@ CrdsaMacModel::NumReplicasPerPacket (void)
   return m_replicasPerPacket;
 }
 
+uint16_t
+CrdsaMacModel::GetMaxReplicasPerPacket (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_replicasDistribution)
+    {
+      return m_replicasDistribution->GetMaxReplicas ();
+    }
+  return m_replicasPerPacket;
+}
+
+bool
+CrdsaMacModel::IsSlotSynchronous (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_slotSynchronous;
+}
+
+uint16_t
+CrdsaMacModel::GetSegmentsPerPacket (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_decoder->GetSegmentsPerPacket ();
+}
+
+void
+CrdsaMacModel::SetSegmentsPerPacket (uint16_t segments)
+{
+  NS_LOG_FUNCTION (this << segments);
+
+  m_decoder->SetSegmentsPerPacket (segments);
+}
+
 uint16_t
 CrdsaMacModel::GetSlotsPerFrame () const
 {
@@ -154,9 +229,11 @@ CrdsaMacModel::GetSelectedSlots (void)
 {
   NS_LOG_FUNCTION (this);
 
+  const auto nReplicas = NumReplicasPerPacket ();
+  NS_ABORT_MSG_IF (nReplicas > GetSlotsPerFrame (), "More replicas than slots in a frame");
+
   std::shuffle (m_slotIds.begin (), m_slotIds.end (), UniformRandomGeneratorAdaptor (*m_rng));
-  std::vector<uint16_t> selectedSlots (m_slotIds.begin (),
-                                       m_slotIds.begin () + NumReplicasPerPacket ());
+  std::vector<uint16_t> selectedSlots (m_slotIds.begin (), m_slotIds.begin () + nReplicas);
 
   return selectedSlots;
 }
@@ -180,11 +257,22 @@ CrdsaMacModel::Send (const Ptr<Packet> &packet, txPacketCallback transmit_callba
     }
   NS_LOG_LOGIC ("Time until the next frame: " << time_to_next_frame);
 
-  for (auto slot : GetSelectedSlots ())
+  const auto selectedSlots = GetSelectedSlots ();
+
+  // The device is done with the packet once its last replica has been sent
+  const auto pending = std::make_shared<std::size_t> (selectedSlots.size ());
+  const rxPacketCallback replica_callback = [pending, finish_callback] () {
+    if (--*pending == 0)
+      {
+        finish_callback ();
+      }
+  };
+
+  for (auto slot : selectedSlots)
     {
       Time time_to_next_slot = time_to_next_frame + slot * m_slotDuration;
       Simulator::Schedule (time_to_next_slot, &CrdsaMacModel::StartPacketTx, this, packet,
-                           transmit_callback, finish_callback);
+                           transmit_callback, replica_callback);
       NS_LOG_LOGIC ("Time until the next slot " << slot << ": " << time_to_next_slot);
     }
 }
@@ -195,7 +283,8 @@ CrdsaMacModel::StartPacketTx (const Ptr<Packet> &packet, txPacketCallback transm
 {
   NS_LOG_FUNCTION (this << packet << &transmit_callback << &finish_callback);
 
-  Time tx_time = transmit_callback ();
+  // Every transmission carries a segment of the packet
+  Time tx_time = TimeStep (transmit_callback ().GetTimeStep () / GetSegmentsPerPacket ());
   Simulator::Schedule (tx_time, &CrdsaMacModel::FinishTransmission, this, finish_callback);
 }
 
@@ -208,121 +297,30 @@ CrdsaMacModel::FinishTransmission (rxPacketCallback finish_callback) const
 }
 
 void
-CrdsaMacModel::CleanActiveBusyPeriods (Time limit_time)
-{
-  NS_LOG_FUNCTION (this << limit_time);
-
-  m_activeBusyPeriods.erase (
-      m_activeBusyPeriods.begin (),
-      std::find_if (m_activeBusyPeriods.cbegin (), m_activeBusyPeriods.cend (),
-                    [limit_time] (auto period) { return period->GetFinishTime () > limit_time; }));
-}
-
-void
-CrdsaMacModel::CleanActiveReceivedPackets (Time limit_time)
-{
-  NS_LOG_FUNCTION (this << limit_time);
-
-  for (auto it = m_activeReceivedPackets.cbegin (); it != m_activeReceivedPackets.cend ();)
-    {
-      if (it->second < limit_time)
-        {
-          it = m_activeReceivedPackets.erase (it);
-        }
-      else
-        {
-          ++it;
-        }
-    }
-}
-
-std::vector<std::pair<uint64_t, MacModel::rxPacketCallback>>
-CrdsaMacModel::MakeInterferenceCancellation (void)
-{
-  NS_LOG_FUNCTION (this);
-
-  std::vector<std::pair<uint64_t, rxPacketCallback>> recoveredPackets;
-  std::vector<std::vector<Ptr<BusyPeriod>>::const_iterator> emptyPeriods;
-
-  for (auto it = m_activeBusyPeriods.begin (); it != m_activeBusyPeriods.end (); it++)
-    {
-      std::vector<uint64_t> receivedPackets;
-      for (const auto &collided : (*it)->GetCollidedPackets ())
-        {
-          if (m_activeReceivedPackets.find (collided.first) != m_activeReceivedPackets.end ())
-            {
-              receivedPackets.push_back (collided.first);
-            }
-        }
-      for (auto received : receivedPackets)
-        {
-          (*it)->RemoveCollidedPacket (received);
-        }
-      if ((*it)->GetCollidedPackets ().empty ())
-        {
-          emptyPeriods.push_back (it);
-        }
-      else if ((*it)->GetCollidedPackets ().size () == 1)
-        {
-          auto recovered = *(*it)->GetCollidedPackets ().cbegin ();
-          recoveredPackets.push_back (recovered);
-        }
-    }
-
-  for (auto &period : emptyPeriods)
-    {
-      m_activeBusyPeriods.erase (period);
-    }
-
-  return recoveredPackets;
-}
-
-void
-CrdsaMacModel::PrintActiveBusyPeriods (void) const
+CrdsaMacModel::StartPacketRx (const Ptr<Packet> &packet, Time packet_tx_time, double rx_power,
+                              rxPacketCallback net_device_cb)
 {
-  std::cout << "\n--> ActiveBusyPeriods (" << m_activeBusyPeriods.size () << ") :\n";
-  if (m_activeBusyPeriods.empty ())
-    {
-      std::cout << " { void }\n";
-    }
-  else
-    {
-      for (auto const &bp : m_activeBusyPeriods)
-        {
-          std::cout << " { " << bp->GetFinishTime () << ": ";
-          for (auto const &collided : bp->GetCollidedPackets ())
-            {
-              std::cout << collided.first << " " << &collided.second << " ";
-            }
-          std::cout << "}\n";
-        }
-    }
-}
+  NS_LOG_FUNCTION (this << packet << packet_tx_time << rx_power << &net_device_cb);
 
-void
-CrdsaMacModel::PrintActiveReceivedPackets (void) const
-{
-  std::cout << "\n--> ActiveReceivedPackets (" << m_activeReceivedPackets.size () << ") :\n";
-  if (m_activeReceivedPackets.empty ())
-    {
-      std::cout << "{ void }\n";
-    }
-  else
+  double rx_power_mw = pow (10, rx_power / 10.0);
+  if (IsSlotSynchronous ())
     {
-      for (auto const &received : m_activeReceivedPackets)
+      if (m_slotReceiver == nullptr)
         {
-          std::cout << " {" << received.first << ": " << received.second << " }\n";
+          m_slotReceiver = std::make_unique<SlotReceiver> (
+              m_slotDuration, [this] (std::vector<SlotArrival> &arrivals, double total_power) {
+                FinishSlot (arrivals, total_power);
+              });
         }
+      // Every transmission carries a segment of the packet
+      m_slotReceiver->Receive (packet->GetUid (),
+                               TimeStep (packet_tx_time.GetTimeStep () / GetSegmentsPerPacket ()),
+                               rx_power_mw, net_device_cb);
+      return;
     }
-}
 
-void
-CrdsaMacModel::StartPacketRx (const Ptr<Packet> &packet, Time packet_tx_time, double rx_power,
-                              rxPacketCallback net_device_cb)
-{
-  NS_LOG_FUNCTION (this << packet << packet_tx_time << rx_power << &net_device_cb);
+  NS_ASSERT_MSG (GetSegmentsPerPacket () == 1, "Segmented packets need slot synchronous reception");
 
-  double rx_power_mw = pow (10, rx_power / 10.0);
   Time now = Simulator::Now ();
   if (m_busyPeriodPacketUid && now < m_busyPeriodFinishTime)
     {
@@ -345,7 +343,7 @@ CrdsaMacModel::StartPacketRx (const Ptr<Packet> &packet, Time packet_tx_time, do
                                                   << m_busyPeriodInterferencePower);
     }
 
-  m_busyPeriodCollidedPackets.insert ({packet->GetUid (), net_device_cb});
+  m_busyPeriodCollidedPackets.emplace_back (packet->GetUid (), net_device_cb);
   Simulator::Schedule (packet_tx_time, &CrdsaMacModel::FinishReception, this, packet, rx_power_mw,
                        net_device_cb);
 }
@@ -366,7 +364,6 @@ CrdsaMacModel::FinishReception (const Ptr<Packet> &packet, double rx_power,
         }
     }
 
-  Time now = Simulator::Now ();
   uint64_t packet_uid = packet->GetUid ();
   if (has_collided)
     {
@@ -374,53 +371,73 @@ CrdsaMacModel::FinishReception (const Ptr<Packet> &packet, double rx_power,
     }
   else
     {
-      NS_LOG_LOGIC ("Packet " << packet_uid << " correctly received");
-
-      if (m_activeReceivedPackets.find (packet_uid) == m_activeReceivedPackets.end ())
-        {
-          // This is the first time this packet is correctly received
-          m_activeReceivedPackets[packet_uid] = now;
-          net_device_cb ();
-        }
+      ReceivePacket (packet_uid, net_device_cb);
     }
 
   if (m_busyPeriodPacketUid == packet_uid)
     {
-      if (has_collided)
+      FinishBusyPeriod (has_collided);
+    }
+}
+
+void
+CrdsaMacModel::FinishSlot (std::vector<SlotArrival> &arrivals, double total_power)
+{
+  NS_LOG_FUNCTION (this << arrivals.size () << total_power);
+
+  bool has_collided = false;
+  for (auto &arrival : arrivals)
+    {
+      if (SlotReceiver::IsCaptured (arrival.power, total_power, m_sirThreshold))
         {
-          // New busy period with collided packets
-          m_activeBusyPeriods.push_back (
-              CreateObject<BusyPeriod> (m_busyPeriodFinishTime, m_busyPeriodCollidedPackets));
+          ReceivePacket (arrival.uid, arrival.callback);
         }
-      Time limit_time = now - 2 * m_slotDuration * GetSlotsPerFrame ();
-      CleanActiveBusyPeriods (limit_time);
-      CleanActiveReceivedPackets (limit_time);
-
-      // Check if any previously collided packet can be recovered
-      auto recoveredPackets = MakeInterferenceCancellation ();
-      while (!recoveredPackets.empty ())
+      else
         {
-          for (auto const &recovered : recoveredPackets)
-            {
-              if (m_activeReceivedPackets.find (recovered.first) == m_activeReceivedPackets.end ())
-                {
-                  NS_LOG_LOGIC ("Packet " << recovered.first << " correctly recovered");
-
-                  m_activeReceivedPackets[recovered.first] = now;
-                  recovered.second ();
-                }
-            }
-          recoveredPackets = MakeInterferenceCancellation ();
+          NS_LOG_LOGIC ("Packet " << arrival.uid << " discarded due to collision");
+          has_collided = true;
+          m_busyPeriodCollidedPackets.emplace_back (arrival.uid, std::move (arrival.callback));
         }
+    }
+
+  m_busyPeriodFinishTime = Simulator::Now ();
+  FinishBusyPeriod (has_collided);
+}
+
+void
+CrdsaMacModel::ReceivePacket (uint64_t packet_uid, const rxPacketCallback &cb)
+{
+  NS_LOG_FUNCTION (this << packet_uid);
+  NS_LOG_LOGIC ("Packet " << packet_uid << " correctly received");
+
+  // The callback is only called the first time the packet is decoded
+  m_decoder->ReceiveSegment (packet_uid, cb);
+}
 
-      NS_LOG_LOGIC ("Cleaning busy period info");
+void
+CrdsaMacModel::FinishBusyPeriod (bool has_collided)
+{
+  NS_LOG_FUNCTION (this << has_collided);
 
-      m_busyPeriodPacketUid = boost::none;
-      m_busyPeriodFinishTime = now;
-      m_busyPeriodCollision = false;
-      m_busyPeriodInterferencePower = 0;
-      m_busyPeriodCollidedPackets.clear ();
+  Time now = Simulator::Now ();
+  Time limit_time = now - 2 * m_slotDuration * GetSlotsPerFrame ();
+  m_decoder->Expire (limit_time);
+  if (has_collided)
+    {
+      // New busy period with collided packets
+      m_decoder->AddBusyPeriod (m_busyPeriodFinishTime, m_busyPeriodCollidedPackets);
     }
+
+  // Check if any previously collided packet can be recovered
+  m_decoder->Decode ();
+
+  NS_LOG_LOGIC ("Cleaning busy period info");
+
+  m_busyPeriodPacketUid = boost::none;
+  m_busyPeriodFinishTime = now;
+  m_busyPeriodCollision = false;
+  m_busyPeriodInterferencePower = 0;
+  m_busyPeriodCollidedPackets.clear ();
 }
 
 } // namespace icarus
@@ -27,13 +27,15 @@
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 
-#include <map>
+#include <memory>
 #include <boost/optional.hpp>
 
 namespace ns3 {
 namespace icarus {
 
-class BusyPeriod;
+class SicDecoder;
+class SlotReceiver;
+struct SlotArrival;
 
 class ReplicasDistroPolynomial : public Object
 {
@@ -63,6 +65,35 @@ public:
     NS_ABORT_MSG ("Invalid number of replicas per packet");
   }
 
+  // Smallest and largest number of replicas drawn
+  uint16_t
+  GetMinReplicas (void) const
+  {
+    for (auto n = 1u; n < coefficients.size (); n++)
+      {
+        if (coefficients[n] > 0)
+          {
+            return n;
+          }
+      }
+
+    NS_ABORT_MSG ("Invalid number of replicas per packet");
+  }
+
+  uint16_t
+  GetMaxReplicas (void) const
+  {
+    for (auto n = coefficients.size () - 1; n > 0; n--)
+      {
+        if (coefficients[n] > 0)
+          {
+            return n;
+          }
+      }
+
+    NS_ABORT_MSG ("Invalid number of replicas per packet");
+  }
+
 private:
   const std::vector<double> coefficients;
   Ptr<UniformRandomVariable> rng;
@@ -73,6 +104,7 @@ class CrdsaMacModel : public MacModel
 public:
   static TypeId GetTypeId (void);
   CrdsaMacModel ();
+  virtual ~CrdsaMacModel ();
 
   virtual void Send (const Ptr<Packet> &packet, txPacketCallback transmit_callback,
                      rxPacketCallback finish_callback) override;
@@ -82,33 +114,46 @@ public:
   uint16_t GetSlotsPerFrame () const;
   void SetSlotsPerFrame (uint16_t nSlots);
 
-private:
-  Time m_slotDuration;
+protected:
+  // Sizes the frame if needed and checks that every packet fits in it
+  virtual void DoInitialize (void) override;
+  // Number of transmissions of the next packet
+  virtual uint16_t NumReplicasPerPacket (void);
+  // Largest number of transmissions of a packet
+  virtual uint16_t GetMaxReplicasPerPacket (void);
+  // Whether receptions are resolved per slot
+  virtual bool IsSlotSynchronous (void) const;
+  // Number of transmissions needed to decode a packet
+  uint16_t GetSegmentsPerPacket (void) const;
+  void SetSegmentsPerPacket (uint16_t segments);
+
   uint16_t m_replicasPerPacket;
   Ptr<ReplicasDistroPolynomial> m_replicasDistribution;
+
+private:
+  Time m_slotDuration;
   double m_sirThreshold;
   boost::optional<uint64_t> m_busyPeriodPacketUid;
   Time m_busyPeriodFinishTime;
   bool m_busyPeriodCollision;
   double m_busyPeriodInterferencePower;
-  std::map<uint64_t, rxPacketCallback> m_busyPeriodCollidedPackets;
-  std::vector<Ptr<BusyPeriod>> m_activeBusyPeriods;
-  std::map<uint64_t, Time> m_activeReceivedPackets;
+  std::vector<std::pair<uint64_t, rxPacketCallback>> m_busyPeriodCollidedPackets;
+  std::unique_ptr<SicDecoder> m_decoder;
+  bool m_slotSynchronous;
+  std::unique_ptr<SlotReceiver> m_slotReceiver;
   std::vector<uint16_t> m_slotIds;
   Ptr<UniformRandomVariable> m_rng;
 
-  uint16_t NumReplicasPerPacket (void);
   std::vector<uint16_t> GetSelectedSlots (void);
   void StartPacketTx (const Ptr<Packet> &packet, txPacketCallback transmit_callback,
                       rxPacketCallback finish_callback) const;
   void FinishTransmission (rxPacketCallback cb) const;
   void FinishReception (const Ptr<Packet> &packet, double rx_power, rxPacketCallback cb);
-
-  void CleanActiveBusyPeriods (Time limit_time);
-  void CleanActiveReceivedPackets (Time limit_time);
-  void PrintActiveBusyPeriods (void) const;
-  void PrintActiveReceivedPackets (void) const;
-  std::vector<std::pair<uint64_t, rxPacketCallback>> MakeInterferenceCancellation (void);
+  void FinishSlot (std::vector<SlotArrival> &arrivals, double total_power);
+  // Hand a correctly received packet to the device, unless it already was
+  void ReceivePacket (uint64_t packet_uid, const rxPacketCallback &cb);
+  // Record the current busy period, if collided, and recover what is possible
+  void FinishBusyPeriod (bool has_collided);
 };
 
 } // namespace icarus
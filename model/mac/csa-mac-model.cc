@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#include "csa-mac-model.h"
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.CsaMacModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CsaMacModel);
+
+TypeId
+CsaMacModel::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::icarus::CsaMacModel")
+          .SetParent<CrdsaMacModel> ()
+          .SetGroupName ("ICARUS")
+          .AddConstructor<CsaMacModel> ()
+          .AddAttribute ("SegmentsPerPacket",
+                         "The number of segments a packet is split in (k). Any k of its coded "
+                         "segments are needed to recover it.",
+                         UintegerValue (2),
+                         MakeUintegerAccessor (&CsaMacModel::SetSegmentsPerPacket,
+                                               &CsaMacModel::GetSegmentsPerPacket),
+                         MakeUintegerChecker<uint16_t> (1));
+
+  return tid;
+}
+
+CsaMacModel::CsaMacModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CsaMacModel::~CsaMacModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CsaMacModel::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_ABORT_MSG_IF (m_replicasDistribution &&
+                       m_replicasDistribution->GetMinReplicas () < GetSegmentsPerPacket (),
+                   "CSA may send fewer coded segments than the "
+                       << GetSegmentsPerPacket () << " needed to recover a packet");
+
+  CrdsaMacModel::DoInitialize ();
+}
+
+uint16_t
+CsaMacModel::NumReplicasPerPacket (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  const auto k = GetSegmentsPerPacket ();
+  const uint16_t n =
+      m_replicasDistribution ? m_replicasDistribution->NumReplicasPerPacket () : 2 * k;
+  NS_ABORT_MSG_IF (n < k, "Fewer coded segments than needed to recover the packet");
+
+  return n;
+}
+
+uint16_t
+CsaMacModel::GetMaxReplicasPerPacket (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_replicasDistribution ? m_replicasDistribution->GetMaxReplicas ()
+                                : 2 * GetSegmentsPerPacket ();
+}
+
+bool
+CsaMacModel::IsSlotSynchronous (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return true;
+}
+
+} // namespace icarus
+} // namespace ns3
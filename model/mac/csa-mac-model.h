@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef CSA_MAC_MODEL_H
+#define CSA_MAC_MODEL_H
+
+#include "crdsa-mac-model.h"
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * \ingroup icarus
+ *
+ * \brief Coded Slotted ALOHA.
+ *
+ * Every packet is split in k segments and encoded into n > k coded segments, each sent in a
+ * different slot of the frame. Any k of them are enough to recover the packet, and once it is
+ * recovered all its segments are cancelled from the slots where they collided.
+ *
+ * Packets are not really split: every transmission carries the whole packet, but it takes 1/k of
+ * the packet transmission time, both at the transmitter and at the receiver, so the slot duration
+ * should be sized for the segments. Receptions are always resolved per slot. n is drawn from the
+ * ReplicasDistribution attribute when set and is 2k otherwise. Either way, a frame needs at least
+ * as many slots as the largest n, which is the frame size unless SlotsPerFrame is set.
+ */
+class CsaMacModel : public CrdsaMacModel
+{
+public:
+  static TypeId GetTypeId (void);
+  CsaMacModel ();
+  virtual ~CsaMacModel ();
+
+protected:
+  virtual void DoInitialize (void) override;
+  virtual uint16_t NumReplicasPerPacket (void) override;
+  virtual uint16_t GetMaxReplicasPerPacket (void) override;
+  virtual bool IsSlotSynchronous (void) const override;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* CSA_MAC_MODEL_H */
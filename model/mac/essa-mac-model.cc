@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#include "essa-mac-model.h"
+#include "private/sic-window.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.EssaMacModel");
+
+NS_OBJECT_ENSURE_REGISTERED (EssaMacModel);
+
+TypeId
+EssaMacModel::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::icarus::EssaMacModel")
+          .SetParent<MacModel> ()
+          .SetGroupName ("ICARUS")
+          .AddConstructor<EssaMacModel> ()
+          .AddAttribute ("WindowDuration",
+                         "The duration of the receiver window (0 for three times MaxTxTime)",
+                         TimeValue (Seconds (0)),
+                         MakeTimeAccessor (&EssaMacModel::m_windowDuration), MakeTimeChecker ())
+          .AddAttribute ("MaxTxTime",
+                         "The transmission time of the longest packet. Sizes the receiver window "
+                         "when WindowDuration is not set.",
+                         TimeValue (Seconds (0)), MakeTimeAccessor (&EssaMacModel::m_maxTxTime),
+                         MakeTimeChecker ())
+          .AddAttribute ("WindowStep",
+                         "How much the receiver window advances between decoding rounds (0 for a "
+                         "third of the window)",
+                         TimeValue (Seconds (0)), MakeTimeAccessor (&EssaMacModel::m_windowStep),
+                         MakeTimeChecker ())
+          .AddAttribute ("SpreadingFactor", "The spreading factor of the transmissions",
+                         UintegerValue (256),
+                         MakeUintegerAccessor (&EssaMacModel::m_spreadingFactor),
+                         MakeUintegerChecker<uint16_t> (1))
+          .AddAttribute ("SinrThreshold", "The SINR after despreading needed to decode, in dB",
+                         DoubleValue (1.0), MakeDoubleAccessor (&EssaMacModel::m_sinrThreshold),
+                         MakeDoubleChecker<double> ())
+          .AddAttribute ("NoisePower", "The noise power at the receiver in dBm (none by default)",
+                         DoubleValue (std::numeric_limits<double>::lowest ()),
+                         MakeDoubleAccessor (&EssaMacModel::m_noisePower),
+                         MakeDoubleChecker<double> ());
+
+  return tid;
+}
+
+EssaMacModel::EssaMacModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EssaMacModel::~EssaMacModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+EssaMacModel::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  CheckWindow ();
+
+  MacModel::DoInitialize ();
+}
+
+void
+EssaMacModel::CheckWindow (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  // Sizing it from the first packet would reject any later one more than twice as long
+  NS_ABORT_MSG_IF (!m_windowDuration.IsStrictlyPositive () && !m_maxTxTime.IsStrictlyPositive (),
+                   "E-SSA needs either a WindowDuration or the MaxTxTime of the longest packet");
+}
+
+void
+EssaMacModel::Send (const Ptr<Packet> &packet, txPacketCallback transmit_callback,
+                    rxPacketCallback finish_callback)
+{
+  NS_LOG_FUNCTION (this << packet << &transmit_callback << &finish_callback);
+
+  const Time tx_time = transmit_callback ();
+  Simulator::Schedule (tx_time, &EssaMacModel::FinishTransmission, this, finish_callback);
+}
+
+void
+EssaMacModel::FinishTransmission (rxPacketCallback cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+
+  return cb ();
+}
+
+void
+EssaMacModel::StartPacketRx (const Ptr<Packet> &packet, Time packet_tx_time, double rx_power,
+                             rxPacketCallback net_device_cb)
+{
+  NS_LOG_FUNCTION (this << packet << packet_tx_time << rx_power << &net_device_cb);
+
+  if (m_window == nullptr)
+    {
+      CheckWindow ();
+      const auto duration = m_windowDuration.IsStrictlyPositive ()
+                                ? m_windowDuration
+                                : TimeStep (3 * m_maxTxTime.GetTimeStep ());
+      const auto step = m_windowStep.IsStrictlyPositive ()
+                            ? m_windowStep
+                            : TimeStep (duration.GetTimeStep () / 3);
+      NS_LOG_LOGIC ("Receiver window of " << duration << " every " << step);
+      m_window = std::make_unique<SicWindow> (
+          duration, step, [this] (double power, double interference) {
+            return IsDecodable (power, interference);
+          });
+    }
+
+  m_window->Receive (packet->GetUid (), packet_tx_time, pow (10, rx_power / 10.0),
+                     net_device_cb);
+}
+
+bool
+EssaMacModel::IsDecodable (double rx_power, double interference_power) const
+{
+  const auto noise_power = pow (10, m_noisePower / 10.0);
+  const auto interference = noise_power + interference_power;
+
+  return interference <= 0.0 ||
+         10.0 * std::log10 (m_spreadingFactor * rx_power / interference) >= m_sinrThreshold;
+}
+
+} // namespace icarus
+} // namespace ns3
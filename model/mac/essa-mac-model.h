@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef ESSA_MAC_MODEL_H
+#define ESSA_MAC_MODEL_H
+
+#include "mac-model.h"
+
+#include <memory>
+
+namespace ns3 {
+namespace icarus {
+
+class SicWindow;
+
+/**
+ * \ingroup icarus
+ *
+ * \brief Enhanced Spread Spectrum ALOHA.
+ *
+ * Terminals transmit as soon as they have a packet, without slots. The receiver keeps a sliding
+ * window of the received signal and runs iterative successive interference cancellation on it
+ * every window step. A packet is decoded when its SINR after despreading reaches SinrThreshold.
+ * The interference of every other packet is weighted by the fraction of the packet it overlaps
+ * with, and decoded packets are perfectly cancelled. The window is set by WindowDuration, or else
+ * by MaxTxTime, and every transmission must fit in it minus a step.
+ */
+class EssaMacModel : public MacModel
+{
+public:
+  static TypeId GetTypeId (void);
+  EssaMacModel ();
+  virtual ~EssaMacModel ();
+
+  virtual void Send (const Ptr<Packet> &packet, txPacketCallback transmit_callback,
+                     rxPacketCallback finish_callback) override;
+  virtual void StartPacketRx (const Ptr<Packet> &packet, Time packet_tx_time, double rx_power,
+                              rxPacketCallback cb) override;
+
+protected:
+  // Checks that the receiver window is configured
+  virtual void DoInitialize (void) override;
+
+private:
+  Time m_windowDuration;
+  Time m_maxTxTime;
+  Time m_windowStep;
+  uint16_t m_spreadingFactor;
+  double m_sinrThreshold;
+  double m_noisePower;
+  std::unique_ptr<SicWindow> m_window;
+
+  void CheckWindow (void) const;
+  void FinishTransmission (rxPacketCallback cb) const;
+  bool IsDecodable (double rx_power, double interference_power) const;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* ESSA_MAC_MODEL_H */
@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#include "irsa-mac-model.h"
+
+#include "ns3/log.h"
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.IrsaMacModel");
+
+NS_OBJECT_ENSURE_REGISTERED (IrsaMacModel);
+
+TypeId
+IrsaMacModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::icarus::IrsaMacModel")
+                          .SetParent<CrdsaMacModel> ()
+                          .SetGroupName ("ICARUS")
+                          .AddConstructor<IrsaMacModel> ();
+
+  return tid;
+}
+
+IrsaMacModel::IrsaMacModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+IrsaMacModel::~IrsaMacModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint16_t
+IrsaMacModel::NumReplicasPerPacket (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  return GetReplicasDistribution ().NumReplicasPerPacket ();
+}
+
+uint16_t
+IrsaMacModel::GetMaxReplicasPerPacket (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  return GetReplicasDistribution ().GetMaxReplicas ();
+}
+
+const ReplicasDistroPolynomial &
+IrsaMacModel::GetReplicasDistribution (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_replicasDistribution)
+    {
+      // 0.5 x² + 0.28 x³ + 0.22 x⁸
+      m_replicasDistribution = CreateObject<ReplicasDistroPolynomial> (
+          std::vector<double>{0.0, 0.0, 0.5, 0.28, 0.0, 0.0, 0.0, 0.0, 0.22});
+    }
+
+  return *m_replicasDistribution;
+}
+
+} // namespace icarus
+} // namespace ns3
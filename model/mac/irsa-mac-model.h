@@ -0,0 +1,57 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef IRSA_MAC_MODEL_H
+#define IRSA_MAC_MODEL_H
+
+#include "crdsa-mac-model.h"
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * \ingroup icarus
+ *
+ * \brief Irregular Repetition Slotted ALOHA.
+ *
+ * Like CRDSA, but every packet is sent a random number of times drawn from the
+ * ReplicasDistribution attribute. When none is set, packets use the degree distribution
+ * Λ(x) = 0.5 x² + 0.28 x³ + 0.22 x⁸, which keeps the iterative interference cancellation
+ * converging up to a load of about 0.8 packets per slot. It needs at least 8 slots per frame, which
+ * is the frame size unless SlotsPerFrame is set.
+ */
+class IrsaMacModel : public CrdsaMacModel
+{
+public:
+  static TypeId GetTypeId (void);
+  IrsaMacModel ();
+  virtual ~IrsaMacModel ();
+
+protected:
+  virtual uint16_t NumReplicasPerPacket (void) override;
+  virtual uint16_t GetMaxReplicasPerPacket (void) override;
+
+private:
+  const ReplicasDistroPolynomial &GetReplicasDistribution (void);
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* IRSA_MAC_MODEL_H */
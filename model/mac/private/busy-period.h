@@ -23,22 +23,46 @@
 #ifndef BUSY_PERIOD_H
 #define BUSY_PERIOD_H
 
-#include "ns3/mac-model.h"
+#include "ns3/assert.h"
 #include "ns3/nstime.h"
-#include "ns3/object.h"
-#include <functional>
-#include <map>
+
+#include <boost/container/small_vector.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
 namespace ns3 {
 namespace icarus {
 
-class BusyPeriod : public Object
+/**
+ * A busy period with collided packets. It only holds the uids of the packets not received yet.
+ *
+ * A busy period is resolved once the segment of the only packet left in it has been decoded.
+ */
+class BusyPeriod
 {
 public:
-  BusyPeriod (const Time &finish_time,
-              const std::map<uint64_t, MacModel::rxPacketCallback> &collided_packets)
-      : finishTime (finish_time), collidedPackets (collided_packets)
+  typedef boost::container::small_vector<uint64_t, 4> PacketUids;
+
+  void
+  Reset (const Time &finish_time)
   {
+    finishTime = finish_time;
+    collidedPackets.clear ();
+    resolved = false;
+  }
+
+  bool
+  IsResolved (void) const
+  {
+    return resolved;
+  }
+
+  void
+  SetResolved (void)
+  {
+    resolved = true;
   }
 
   Time
@@ -47,25 +71,129 @@ public:
     return finishTime;
   }
 
-  const std::map<uint64_t, std::function<void (void)>> &
+  const PacketUids &
   GetCollidedPackets (void) const
   {
     return collidedPackets;
   }
 
+  void
+  AddCollidedPacket (uint64_t packet_uid)
+  {
+    collidedPackets.push_back (packet_uid);
+  }
+
   bool
   RemoveCollidedPacket (uint64_t packet_uid)
   {
-    auto removed = collidedPackets.erase (packet_uid);
+    auto removed = std::find (collidedPackets.begin (), collidedPackets.end (), packet_uid);
 
-    NS_ASSERT_MSG (removed == 1, "Packet to be removed from the busy period not found");
+    NS_ASSERT_MSG (removed != collidedPackets.end (),
+                   "Packet to be removed from the busy period not found");
+
+    *removed = collidedPackets.back ();
+    collidedPackets.pop_back ();
 
     return true;
   }
 
 private:
-  const Time finishTime;
-  std::map<uint64_t, std::function<void (void)>> collidedPackets;
+  Time finishTime;
+  PacketUids collidedPackets;
+  bool resolved = false;
+};
+
+/**
+ * Busy periods sorted by finish time, stored in a ring buffer that only grows.
+ *
+ * Busy periods are created in finish time order and expire in the same order, so they are
+ * appended at the back and removed from the front. Every busy period gets a sequence number
+ * that identifies it while it is active. The storage of expired periods is reused.
+ */
+class BusyPeriodRing
+{
+public:
+  BusyPeriodRing () : periods (INITIAL_CAPACITY), head (0), tail (0)
+  {
+  }
+
+  bool
+  Empty (void) const
+  {
+    return head == tail;
+  }
+
+  // Sequence numbers of the active busy periods, from Begin () to End ()
+  uint64_t
+  Begin (void) const
+  {
+    return head;
+  }
+
+  uint64_t
+  End (void) const
+  {
+    return tail;
+  }
+
+  bool
+  IsActive (uint64_t id) const
+  {
+    return id >= head && id < tail;
+  }
+
+  BusyPeriod &
+  Get (uint64_t id)
+  {
+    NS_ASSERT_MSG (IsActive (id), "The busy period is not active");
+
+    return periods[id & (periods.size () - 1)];
+  }
+
+  const BusyPeriod &
+  Get (uint64_t id) const
+  {
+    NS_ASSERT_MSG (IsActive (id), "The busy period is not active");
+
+    return periods[id & (periods.size () - 1)];
+  }
+
+  // Append a new empty busy period and return its sequence number
+  uint64_t
+  Push (const Time &finish_time)
+  {
+    NS_ASSERT_MSG (Empty () || Get (tail - 1).GetFinishTime () <= finish_time,
+                   "Busy periods must be added in finish time order");
+
+    if (tail - head == periods.size ())
+      {
+        // Capacities are powers of two, so every active period keeps a different position
+        std::vector<BusyPeriod> grown (2 * periods.size ());
+        for (auto id = head; id < tail; id++)
+          {
+            grown[id & (grown.size () - 1)] = std::move (Get (id));
+          }
+        periods.swap (grown);
+      }
+
+    periods[tail & (periods.size () - 1)].Reset (finish_time);
+
+    return tail++;
+  }
+
+  void
+  PopFront (void)
+  {
+    NS_ASSERT (!Empty ());
+
+    head++;
+  }
+
+private:
+  static constexpr std::size_t INITIAL_CAPACITY = 16;
+
+  std::vector<BusyPeriod> periods;
+  uint64_t head, tail;
 };
 
 } // namespace icarus
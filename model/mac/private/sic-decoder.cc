@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "sic-decoder.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.SicDecoder");
+
+SicDecoder::SicDecoder () : m_segmentsPerPacket (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint16_t
+SicDecoder::GetSegmentsPerPacket (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_segmentsPerPacket;
+}
+
+void
+SicDecoder::SetSegmentsPerPacket (uint16_t segments)
+{
+  NS_LOG_FUNCTION (this << segments);
+  NS_ASSERT_MSG (segments > 0, "Packets need at least one segment");
+
+  m_segmentsPerPacket = segments;
+}
+
+void
+SicDecoder::ReceiveSegment (uint64_t packet_uid, const rxPacketCallback &cb)
+{
+  NS_LOG_FUNCTION (this << packet_uid);
+
+  if (IsDecoded (packet_uid))
+    {
+      return;
+    }
+
+  // A busy period of its own, resolved right away
+  m_segment.clear ();
+  m_segment.emplace_back (packet_uid, cb);
+  AddBusyPeriod (Simulator::Now (), m_segment);
+  Decode ();
+}
+
+void
+SicDecoder::AddBusyPeriod (Time finish_time,
+                           std::vector<std::pair<uint64_t, rxPacketCallback>> &packets)
+{
+  NS_LOG_FUNCTION (this << finish_time << packets.size ());
+
+  const auto id = m_busyPeriods.Push (finish_time);
+  auto &period = m_busyPeriods.Get (id);
+
+  for (auto &packet : packets)
+    {
+      if (IsDecoded (packet.first))
+        {
+          continue;
+        }
+
+      // The callback is kept only once, no matter how many segments of the packet collide
+      auto &pending = m_pendingPackets[packet.first];
+      if (!pending.callback)
+        {
+          pending.callback = std::move (packet.second);
+        }
+      else if (!pending.busyPeriods.empty () && pending.busyPeriods.back () == id)
+        {
+          continue;
+        }
+      pending.busyPeriods.push_back (id);
+      period.AddCollidedPacket (packet.first);
+    }
+
+  if (period.GetCollidedPackets ().size () == 1)
+    {
+      m_resolvableBusyPeriods.push_back (id);
+    }
+}
+
+void
+SicDecoder::Decode (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Decoding a packet cancels it only from the busy periods with its segments, which may in turn
+  // leave other packets alone in their periods
+  while (!m_resolvableBusyPeriods.empty ())
+    {
+      const auto id = m_resolvableBusyPeriods.front ();
+      m_resolvableBusyPeriods.pop_front ();
+
+      if (!m_busyPeriods.IsActive (id))
+        {
+          continue;
+        }
+      auto &period = m_busyPeriods.Get (id);
+      if (period.IsResolved () || period.GetCollidedPackets ().size () != 1)
+        {
+          continue;
+        }
+
+      period.SetResolved ();
+      const auto packet_uid = period.GetCollidedPackets ().front ();
+      if (++m_pendingPackets[packet_uid].resolvedSegments < m_segmentsPerPacket)
+        {
+          continue;
+        }
+
+      NS_LOG_LOGIC ("Packet " << packet_uid << " decoded");
+
+      const auto callback = CancelPacket (packet_uid);
+      m_decodedPackets.insert (packet_uid);
+      m_decodingTimes.emplace_back (Simulator::Now (), packet_uid);
+      callback ();
+    }
+}
+
+SicDecoder::rxPacketCallback
+SicDecoder::CancelPacket (uint64_t packet_uid)
+{
+  NS_LOG_FUNCTION (this << packet_uid);
+
+  const auto pending = m_pendingPackets.find (packet_uid);
+  NS_ASSERT (pending != m_pendingPackets.end ());
+
+  for (const auto id : pending->second.busyPeriods)
+    {
+      auto &period = m_busyPeriods.Get (id);
+      period.RemoveCollidedPacket (packet_uid);
+      if (!period.IsResolved () && period.GetCollidedPackets ().size () == 1)
+        {
+          m_resolvableBusyPeriods.push_back (id);
+        }
+    }
+
+  auto callback = std::move (pending->second.callback);
+  m_pendingPackets.erase (pending);
+
+  return callback;
+}
+
+void
+SicDecoder::Expire (Time limit_time)
+{
+  NS_LOG_FUNCTION (this << limit_time);
+
+  while (!m_busyPeriods.Empty () &&
+         m_busyPeriods.Get (m_busyPeriods.Begin ()).GetFinishTime () <= limit_time)
+    {
+      // Forget the period in the packets still in it, which are lost if it was their last one
+      const auto id = m_busyPeriods.Begin ();
+      for (const auto packet_uid : m_busyPeriods.Get (id).GetCollidedPackets ())
+        {
+          const auto pending = m_pendingPackets.find (packet_uid);
+          NS_ASSERT (pending != m_pendingPackets.end () &&
+                     pending->second.busyPeriods.front () == id);
+
+          pending->second.busyPeriods.erase (pending->second.busyPeriods.begin ());
+          if (pending->second.busyPeriods.empty ())
+            {
+              m_pendingPackets.erase (pending);
+            }
+        }
+      m_busyPeriods.PopFront ();
+    }
+
+  while (!m_decodingTimes.empty () && m_decodingTimes.front ().first < limit_time)
+    {
+      m_decodedPackets.erase (m_decodingTimes.front ().second);
+      m_decodingTimes.pop_front ();
+    }
+}
+
+bool
+SicDecoder::IsDecoded (uint64_t packet_uid) const
+{
+  return m_decodedPackets.count (packet_uid) > 0;
+}
+
+void
+SicDecoder::Print (std::ostream &os) const
+{
+  os << "\n--> ActiveBusyPeriods (" << m_busyPeriods.End () - m_busyPeriods.Begin () << ") :\n";
+  for (auto id = m_busyPeriods.Begin (); id < m_busyPeriods.End (); id++)
+    {
+      const auto &bp = m_busyPeriods.Get (id);
+      os << " { " << bp.GetFinishTime () << (bp.IsResolved () ? " resolved: " : ": ");
+      for (auto const collided : bp.GetCollidedPackets ())
+        {
+          os << collided << " ";
+        }
+      os << "}\n";
+    }
+
+  os << "\n--> DecodedPackets (" << m_decodingTimes.size () << ") :\n";
+  for (auto const &decoded : m_decodingTimes)
+    {
+      os << " {" << decoded.second << ": " << decoded.first << " }\n";
+    }
+}
+
+} // namespace icarus
+} // namespace ns3
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef SIC_DECODER_H
+#define SIC_DECODER_H
+
+#include "busy-period.h"
+
+#include "ns3/mac-model.h"
+#include "ns3/nstime.h"
+
+#include <boost/container/small_vector.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * Iterative successive interference cancellation shared by the MAC models that send several
+ * transmissions of every packet.
+ *
+ * Every packet is sent as a number of segments, each one in a different slot. A packet is decoded
+ * once SegmentsPerPacket of them have been resolved, either because they were received without
+ * interference or because the rest of the packets of their busy period were cancelled. Once
+ * decoded, all its segments are cancelled from their busy periods. With one segment per packet the
+ * segments are plain replicas, as in CRDSA and IRSA. With more, they are the codewords of a packet
+ * level MDS code, as in Coded Slotted ALOHA.
+ *
+ * Decoding works on the bipartite graph of packets and busy periods: only the busy periods left
+ * with a single packet are visited, and decoding a packet only updates its own busy periods.
+ */
+class SicDecoder
+{
+public:
+  typedef MacModel::rxPacketCallback rxPacketCallback;
+
+  SicDecoder ();
+
+  uint16_t GetSegmentsPerPacket (void) const;
+  void SetSegmentsPerPacket (uint16_t segments);
+
+  // A segment received without interference
+  void ReceiveSegment (uint64_t packet_uid, const rxPacketCallback &cb);
+  // A busy period with colliding segments. Callbacks are moved out of packets.
+  void AddBusyPeriod (Time finish_time,
+                      std::vector<std::pair<uint64_t, rxPacketCallback>> &packets);
+  // Decode every packet that can be recovered, calling its callback
+  void Decode (void);
+  // Forget the busy periods finished and the packets decoded before limit_time
+  void Expire (Time limit_time);
+
+  bool IsDecoded (uint64_t packet_uid) const;
+
+  void Print (std::ostream &os) const;
+
+private:
+  // Remove a decoded packet from its busy periods and return its callback
+  rxPacketCallback CancelPacket (uint64_t packet_uid);
+
+  uint16_t m_segmentsPerPacket;
+  // Busy periods, sorted by finish time
+  BusyPeriodRing m_busyPeriods;
+  // A packet not decoded yet, its active busy periods and the number of segments resolved
+  struct PendingPacket
+  {
+    rxPacketCallback callback;
+    boost::container::small_vector<uint64_t, 4> busyPeriods;
+    uint16_t resolvedSegments = 0;
+  };
+  std::unordered_map<uint64_t, PendingPacket> m_pendingPackets;
+  // Busy periods left with a single packet, whose segment can be resolved
+  std::deque<uint64_t> m_resolvableBusyPeriods;
+  std::unordered_set<uint64_t> m_decodedPackets;
+  std::deque<std::pair<Time, uint64_t>> m_decodingTimes;
+  std::vector<std::pair<uint64_t, rxPacketCallback>> m_segment;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* SIC_DECODER_H */
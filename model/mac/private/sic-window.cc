@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#include "sic-window.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.SicWindow");
+
+SicWindow::SicWindow (Time windowDuration, Time windowStep, DecodingCriterion criterion)
+    : m_windowDuration (windowDuration),
+      m_windowStep (windowStep),
+      m_criterion (std::move (criterion)),
+      m_maxTxTime (Seconds (0)),
+      m_lastStep (Seconds (0))
+{
+  NS_LOG_FUNCTION (this << windowDuration << windowStep);
+  NS_ASSERT_MSG (m_windowStep.IsStrictlyPositive () && m_windowStep < m_windowDuration,
+                 "The window step must be positive and shorter than the window");
+}
+
+SicWindow::~SicWindow ()
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_event);
+}
+
+void
+SicWindow::Receive (uint64_t uid, Time txTime, double power, MacModel::rxPacketCallback callback)
+{
+  NS_LOG_FUNCTION (this << uid << txTime << power);
+  // Otherwise an arrival could still be on the air when it is forgotten
+  NS_ABORT_MSG_IF (txTime > m_windowDuration - m_windowStep,
+                   "Transmissions must fit in the window minus a step");
+
+  const auto now = Simulator::Now ();
+  Arrival arrival{uid, now, now + txTime, power, 0.0, false, std::move (callback)};
+  m_maxTxTime = std::max (m_maxTxTime, txTime);
+
+  const auto candidates = Candidates (arrival.start, arrival.end);
+  for (auto i = candidates.first; i < candidates.second; i++)
+    {
+      auto &other = m_arrivals[i];
+      const auto overlap = Overlap (arrival, other);
+      if (other.decoded || overlap <= 0.0)
+        {
+          continue;
+        }
+      other.interference += power * overlap;
+      arrival.interference += other.power * overlap;
+    }
+  m_arrivals.push_back (std::move (arrival));
+
+  if (!m_event.IsRunning ())
+    {
+      m_lastStep = now;
+      m_event = Simulator::Schedule (m_windowStep, &SicWindow::Step, this);
+    }
+}
+
+double
+SicWindow::Overlap (const Arrival &a, const Arrival &b)
+{
+  return (std::min (a.end, b.end) - std::max (a.start, b.start)).GetSeconds ();
+}
+
+std::pair<std::size_t, std::size_t>
+SicWindow::Candidates (Time start, Time end) const
+{
+  const auto byStart = [] (const Arrival &arrival, Time t) { return arrival.start < t; };
+  const auto first =
+      std::lower_bound (m_arrivals.begin (), m_arrivals.end (), start - m_maxTxTime, byStart);
+  const auto last = std::lower_bound (first, m_arrivals.end (), end, byStart);
+
+  return {first - m_arrivals.begin (), last - m_arrivals.begin ()};
+}
+
+bool
+SicWindow::TryDecode (std::size_t index) const
+{
+  const auto &arrival = m_arrivals[index];
+  const auto duration = (arrival.end - arrival.start).GetSeconds ();
+
+  return m_criterion (arrival.power, std::max (arrival.interference, 0.0) / duration);
+}
+
+void
+SicWindow::Cancel (std::size_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+
+  const auto now = Simulator::Now ();
+  const auto &arrival = m_arrivals[index];
+  const auto candidates = Candidates (arrival.start, arrival.end);
+  for (auto i = candidates.first; i < candidates.second; i++)
+    {
+      auto &other = m_arrivals[i];
+      const auto overlap = Overlap (arrival, other);
+      if (i == index || other.decoded || overlap <= 0.0)
+        {
+          continue;
+        }
+      other.interference -= arrival.power * overlap;
+      // Arrivals still on the air are tried when they end
+      if (other.end <= now)
+        {
+          m_decodable.push_back (i);
+        }
+    }
+}
+
+void
+SicWindow::Step ()
+{
+  NS_LOG_FUNCTION (this);
+
+  const auto now = Simulator::Now ();
+
+  // Interference only goes down with cancellations, so the arrivals that failed in a previous
+  // step are only tried again when an overlapping arrival is cancelled
+  m_decodable.clear ();
+  for (std::size_t i = 0; i < m_arrivals.size (); i++)
+    {
+      if (m_arrivals[i].end > m_lastStep && m_arrivals[i].end <= now)
+        {
+          m_decodable.push_back (i);
+        }
+    }
+  m_lastStep = now;
+
+  while (!m_decodable.empty ())
+    {
+      const auto i = m_decodable.back ();
+      m_decodable.pop_back ();
+      if (m_arrivals[i].decoded || !TryDecode (i))
+        {
+          continue;
+        }
+
+      NS_LOG_LOGIC ("Packet " << m_arrivals[i].uid << " decoded");
+      m_arrivals[i].decoded = true;
+      Cancel (i);
+      const auto callback = std::move (m_arrivals[i].callback);
+      callback ();
+    }
+
+  // Forget the arrivals that start before the next window
+  const auto limit = now + m_windowStep - m_windowDuration;
+  while (!m_arrivals.empty () && m_arrivals.front ().start < limit)
+    {
+      if (!m_arrivals.front ().decoded)
+        {
+          NS_LOG_LOGIC ("Packet " << m_arrivals.front ().uid << " lost");
+        }
+      m_arrivals.pop_front ();
+    }
+
+  // A callback may already have started the next step with a new arrival
+  if (!m_arrivals.empty () && !m_event.IsRunning ())
+    {
+      m_event = Simulator::Schedule (m_windowStep, &SicWindow::Step, this);
+    }
+}
+
+} // namespace icarus
+} // namespace ns3
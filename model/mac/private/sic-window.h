@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef SIC_WINDOW_H
+#define SIC_WINDOW_H
+
+#include "ns3/event-id.h"
+#include "ns3/mac-model.h"
+#include "ns3/nstime.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * Sliding window receiver with iterative successive interference cancellation, for asynchronous
+ * spread spectrum access.
+ *
+ * Every arrival keeps the interference energy received from the others, weighted by how long
+ * they overlap with it. It is updated when an overlapping arrival starts or is cancelled, so the
+ * SINR of an arrival is always at hand. Arrivals are kept sorted by their start time and no
+ * arrival is longer than the longest one seen, so the arrivals overlapping an interval are found
+ * with a binary search and every update only visits them.
+ *
+ * Every window step the receiver decodes the arrivals that ended inside the window and reach the
+ * decoding threshold, cancels them from the rest and tries again until no more can be decoded.
+ * Arrivals that will not fit in the next window are then forgotten.
+ */
+class SicWindow
+{
+public:
+  // Whether an arrival can be decoded, from its power and its average interference, in mW
+  typedef std::function<bool (double power, double interference)> DecodingCriterion;
+
+  SicWindow (Time windowDuration, Time windowStep, DecodingCriterion criterion);
+  ~SicWindow ();
+
+  void Receive (uint64_t uid, Time txTime, double power, MacModel::rxPacketCallback callback);
+
+private:
+  struct Arrival
+  {
+    uint64_t uid;
+    Time start;
+    Time end;
+    // In mW
+    double power;
+    // In mW·s, from the arrivals not cancelled
+    double interference;
+    bool decoded;
+    MacModel::rxPacketCallback callback;
+  };
+
+  // Overlap of two arrivals, in seconds
+  static double Overlap (const Arrival &a, const Arrival &b);
+  // Range of arrivals that may overlap [start, end)
+  std::pair<std::size_t, std::size_t> Candidates (Time start, Time end) const;
+  bool TryDecode (std::size_t index) const;
+  void Cancel (std::size_t index);
+  void Step ();
+
+  Time m_windowDuration;
+  Time m_windowStep;
+  DecodingCriterion m_criterion;
+  // Sorted by start time
+  std::deque<Arrival> m_arrivals;
+  Time m_maxTxTime;
+  Time m_lastStep;
+  std::vector<std::size_t> m_decodable;
+  EventId m_event;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* SIC_WINDOW_H */
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "slot-receiver.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <cmath>
+
+namespace ns3 {
+namespace icarus {
+
+NS_LOG_COMPONENT_DEFINE ("icarus.SlotReceiver");
+
+SlotReceiver::SlotReceiver (Time slotDuration, SlotHandler handler)
+    : m_handler (std::move (handler)), m_slotDuration (slotDuration)
+{
+  NS_LOG_FUNCTION (this << slotDuration);
+  NS_ASSERT_MSG (m_slotDuration.IsStrictlyPositive (), "Slot synchronous reception needs slots");
+}
+
+SlotReceiver::~SlotReceiver ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (auto &pending : m_slots)
+    {
+      Simulator::Cancel (pending.event);
+    }
+}
+
+void
+SlotReceiver::Receive (uint64_t uid, Time txTime, double power,
+                       MacModel::rxPacketCallback callback)
+{
+  NS_LOG_FUNCTION (this << uid << txTime << power);
+  NS_ASSERT_MSG (txTime <= m_slotDuration, "Transmissions must fit in a slot");
+
+  const auto now = Simulator::Now ();
+  const auto slot = (now / m_slotDuration).GetHigh ();
+  const auto end = now + txTime;
+
+  if (end > (slot + 1) * m_slotDuration)
+    {
+      NS_LOG_WARN ("Packet " << uid << " starts at " << now << " and ends at " << end
+                             << ", after the end of slot " << slot
+                             << ". The receptions are not aligned to the slots.");
+    }
+
+  if (m_slots.empty () || m_slots.back ().index != slot)
+    {
+      m_slots.push_back ({slot, {}, 0.0, (slot + 1) * m_slotDuration, EventId ()});
+      m_slots.back ().event = Simulator::Schedule (m_slots.back ().end - now,
+                                                   &SlotReceiver::FinishSlot, this, slot);
+    }
+
+  auto &pending = m_slots.back ();
+  if (end > pending.end)
+    {
+      // Do not resolve the slot before the whole transmission has arrived
+      Simulator::Cancel (pending.event);
+      pending.end = end;
+      pending.event = Simulator::Schedule (txTime, &SlotReceiver::FinishSlot, this, slot);
+    }
+
+  pending.arrivals.push_back ({uid, power, std::move (callback)});
+  pending.totalPower += power;
+}
+
+bool
+SlotReceiver::IsCaptured (double power, double totalPower, double sirThreshold)
+{
+  const auto interference = totalPower - power;
+
+  return interference <= 0.0 || 10.0 * std::log10 (power / interference) >= sirThreshold;
+}
+
+void
+SlotReceiver::FinishSlot (int64_t slot)
+{
+  NS_LOG_FUNCTION (this << slot);
+
+  // A slot extended by a late reception may end together with the following one
+  while (!m_slots.empty () && m_slots.front ().index <= slot)
+    {
+      auto pending = std::move (m_slots.front ());
+      m_slots.pop_front ();
+      Simulator::Cancel (pending.event);
+
+      NS_LOG_LOGIC (pending.arrivals.size () << " transmissions in slot " << pending.index);
+      m_handler (pending.arrivals, pending.totalPower);
+    }
+}
+
+} // namespace icarus
+} // namespace ns3
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef SLOT_RECEIVER_H
+#define SLOT_RECEIVER_H
+
+#include "ns3/event-id.h"
+#include "ns3/mac-model.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+struct SlotArrival
+{
+  uint64_t uid;
+  // In mW
+  double power;
+  MacModel::rxPacketCallback callback;
+};
+
+/**
+ * Slot synchronous reception for the slotted MAC models.
+ *
+ * Receptions are assumed to be aligned to the slots of the receiver, as if the terminals used
+ * timing advance. All the transmissions starting in the same slot collide with each other, and
+ * they are resolved together in a single event at the end of the slot, instead of having an
+ * event for the end of every reception. Nothing aligns them, though: a transmission that starts
+ * late in a slot is logged, it only collides with the ones starting in the same slot, and its
+ * slot is not resolved before it has been fully received.
+ */
+class SlotReceiver
+{
+public:
+  // Called at the end of every slot with transmissions, with them and their total power
+  typedef std::function<void (std::vector<SlotArrival> &arrivals, double totalPower)> SlotHandler;
+
+  SlotReceiver (Time slotDuration, SlotHandler handler);
+  ~SlotReceiver ();
+
+  void Receive (uint64_t uid, Time txTime, double power, MacModel::rxPacketCallback callback);
+
+  // Whether an arrival is decoded in spite of the rest of the power received in its slot
+  static bool IsCaptured (double power, double totalPower, double sirThreshold);
+
+private:
+  struct PendingSlot
+  {
+    int64_t index;
+    std::vector<SlotArrival> arrivals;
+    double totalPower;
+    // The end of the slot or of its last reception, whichever is later
+    Time end;
+    EventId event;
+  };
+
+  // Resolves the pending slots up to the given one, in order
+  void FinishSlot (int64_t slot);
+
+  SlotHandler m_handler;
+  Time m_slotDuration;
+  std::deque<PendingSlot> m_slots;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* SLOT_RECEIVER_H */
@@ -27,11 +27,18 @@
 #include "ns3/ndnSIM/utils/ndn-ns3-packet-tag.hpp"
 
 #include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/tlv.hpp>
 #include <ndn-cxx/interest.hpp>
 #include <ndn-cxx/data.hpp>
+#include <ndn-cxx/lp/packet.hpp>
+#include <ndn-cxx/lp/tlv.hpp>
 
 #include "ns3/queue.h"
 #include "ns3/sat2ground-net-device.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <tuple>
 
 NS_LOG_COMPONENT_DEFINE ("icarus.ndn.Sat2GroundTransport");
 
@@ -39,12 +46,75 @@ namespace ns3 {
 namespace ndn {
 namespace icarus {
 
+namespace {
+// Minimum number of pending Interests before looking for expired ones
+constexpr std::size_t MIN_SWEEP_SIZE = 64;
+
+struct NetworkHeader
+{
+  // Type of the network layer packet, or 0 if it cannot be read
+  uint32_t type = 0;
+  bool nack = false;
+  // Whether this is a fragment after the first one, which lacks the header
+  bool nextFragment = false;
+  ::ndn::Name name;
+};
+
+// Read the type and name of the network layer packet in an NDNLP packet, or in a bare one. The
+// name is at the start of the packet, so the first fragment is enough.
+NetworkHeader
+parseNetworkHeader (const Block &packet)
+{
+  NetworkHeader header;
+  auto begin = packet.begin ();
+  auto end = packet.end ();
+  if (packet.type () == ::ndn::lp::tlv::LpPacket)
+    {
+      const ::ndn::lp::Packet lpPacket (packet);
+      if (!lpPacket.has<::ndn::lp::FragmentField> ())
+        {
+          // An IDLE packet
+          return header;
+        }
+      if (lpPacket.has<::ndn::lp::FragIndexField> () &&
+          lpPacket.get<::ndn::lp::FragIndexField> () > 0)
+        {
+          header.nextFragment = true;
+          return header;
+        }
+      header.nack = lpPacket.has<::ndn::lp::NackField> ();
+      std::tie (begin, end) = lpPacket.get<::ndn::lp::FragmentField> ();
+    }
+
+  uint32_t type;
+  uint64_t length;
+  if (!::ndn::tlv::readType (begin, end, type) || !::ndn::tlv::readVarNumber (begin, end, length) ||
+      begin == end)
+    {
+      return header;
+    }
+
+  bool isOk;
+  Block name;
+  std::tie (isOk, name) = Block::fromBuffer (&*begin, end - begin);
+  if (isOk && name.type () == ::ndn::tlv::Name)
+    {
+      header.type = type;
+      header.name = ::ndn::Name (name);
+    }
+
+  return header;
+}
+} // namespace
+
 Sat2GroundTransport::Sat2GroundTransport (Ptr<Node> node, const Ptr<NetDevice> &netDevice,
                                           const std::string &localUri, const std::string &remoteUri,
                                           ::ndn::nfd::FaceScope scope,
                                           ::ndn::nfd::FacePersistency persistency,
                                           ::ndn::nfd::LinkType linkType)
-    : m_netDevice (DynamicCast<::ns3::icarus::Sat2GroundNetDevice> (netDevice)), m_node (node)
+    : m_netDevice (DynamicCast<::ns3::icarus::Sat2GroundNetDevice> (netDevice)),
+      m_node (node),
+      m_sweepSize (MIN_SWEEP_SIZE)
 {
   this->setLocalUri (FaceUri (localUri));
   this->setRemoteUri (FaceUri (remoteUri));
@@ -90,16 +160,8 @@ Sat2GroundTransport::~Sat2GroundTransport ()
 ssize_t
 Sat2GroundTransport::getSendQueueLength ()
 {
-  PointerValue txQueueAttribute;
-  if (m_netDevice->GetAttributeFailSafe ("TxQueue", txQueueAttribute))
-    {
-      Ptr<ns3::QueueBase> txQueue = txQueueAttribute.Get<ns3::QueueBase> ();
-      return txQueue->GetNBytes ();
-    }
-  else
-    {
-      return nfd::face::QUEUE_UNSUPPORTED;
-    }
+  // Includes the per destination queues of the device, if any
+  return m_netDevice->GetQueuedBytes ();
 }
 
 void
@@ -122,8 +184,69 @@ Sat2GroundTransport::doSend (const Block &packet, const nfd::EndpointId &endpoin
   Ptr<ns3::Packet> ns3Packet = Create<ns3::Packet> ();
   ns3Packet->AddHeader (header);
 
-  // send the NS3 packet
-  m_netDevice->Send (ns3Packet, m_netDevice->GetBroadcast (), L3Protocol::ETHERNET_FRAME_TYPE);
+  // send the NS3 packet. The downlink is broadcast, but a device with a scheduler queues the
+  // packets for every ground station apart.
+  m_netDevice->Send (ns3Packet, getDestination (packet), L3Protocol::ETHERNET_FRAME_TYPE);
+}
+
+void
+Sat2GroundTransport::rememberRequester (const Block &packet, const Address &from)
+{
+  NS_LOG_FUNCTION (this << from);
+
+  const auto header = parseNetworkHeader (packet);
+  if (header.type != ::ndn::tlv::Interest || header.nack)
+    {
+      return;
+    }
+
+  const auto now = Simulator::Now ();
+  if (m_requesters.size () >= m_sweepSize)
+    {
+      for (auto requester = m_requesters.begin (); requester != m_requesters.end ();)
+        {
+          requester = requester->second.second < now ? m_requesters.erase (requester)
+                                                     : std::next (requester);
+        }
+      m_sweepSize = std::max (MIN_SWEEP_SIZE, 2 * m_requesters.size ());
+    }
+
+  // The actual lifetime is only known once the whole Interest is decoded
+  m_requesters[header.name] = {
+      from, now + MilliSeconds (::ndn::DEFAULT_INTEREST_LIFETIME.count ())};
+}
+
+Address
+Sat2GroundTransport::getDestination (const Block &packet)
+{
+  NS_LOG_FUNCTION (this);
+
+  const auto header = parseNetworkHeader (packet);
+  if (header.nextFragment)
+    {
+      return m_lastDestination;
+    }
+
+  m_lastDestination = m_netDevice->GetBroadcast ();
+  if (header.type == ::ndn::tlv::Data || (header.type == ::ndn::tlv::Interest && header.nack))
+    {
+      // Data names may extend those of the Interests they satisfy
+      for (auto length = header.name.size () + 1; length-- > 0;)
+        {
+          const auto requester = m_requesters.find (header.name.getPrefix (length));
+          if (requester != m_requesters.end ())
+            {
+              if (requester->second.second >= Simulator::Now ())
+                {
+                  m_lastDestination = requester->second.first;
+                }
+              m_requesters.erase (requester);
+              break;
+            }
+        }
+    }
+
+  return m_lastDestination;
 }
 
 // callback
@@ -140,6 +263,7 @@ Sat2GroundTransport::receiveFromNetDevice (Ptr<NetDevice> device, Ptr<const ns3:
   BlockHeader header;
   packet->RemoveHeader (header);
 
+  rememberRequester (header.getBlock (), from);
   this->receive (std::move (header.getBlock ()));
 }
 
@@ -35,6 +35,9 @@
 
 #include "ns3/sat2ground-net-device.h"
 #include "ns3/channel.h"
+#include "ns3/nstime.h"
+
+#include <map>
 
 namespace ns3 {
 namespace ndn {
@@ -64,8 +67,20 @@ private:
                              const Address &from, const Address &to,
                              NetDevice::PacketType packetType);
 
+  // Remember the ground station that sent an Interest, so that its Data goes to it
+  void rememberRequester (const Block &packet, const Address &from);
+  // The ground station that asked for the Data or Nack in packet, or the broadcast address
+  Address getDestination (const Block &packet);
+
   Ptr<::ns3::icarus::Sat2GroundNetDevice> m_netDevice; ///< \brief Smart pointer to NetDevice
   Ptr<Node> m_node;
+
+  // Station that sent every pending Interest, and when the Interest expires
+  std::map<::ndn::Name, std::pair<Address, Time>> m_requesters;
+  // Size of m_requesters that triggers the removal of the expired Interests
+  std::size_t m_sweepSize;
+  // Of the last first fragment, for the fragments that follow it
+  Address m_lastDestination;
 };
 
 } // namespace icarus
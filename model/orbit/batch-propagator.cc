@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#include "batch-propagator.h"
+#include "circular-orbit-impl.h"
+
+#include <ns3/assert.h>
+
+#include <cmath>
+
+namespace ns3 {
+namespace icarus {
+
+BatchPropagator::BatchPropagator (std::size_t size)
+    : m_inclination (size),
+      m_ascendingNode (size),
+      m_radius (size),
+      m_phase (size),
+      m_meanMotion (size),
+      m_cosPhase (size, 1.0),
+      m_sinPhase (size),
+      m_px (size),
+      m_py (size),
+      m_qx (size),
+      m_qy (size),
+      m_qz (size),
+      m_uniformMeanMotion (true),
+      m_cosNt (size),
+      m_sinNt (size)
+{
+}
+
+std::size_t
+BatchPropagator::size () const noexcept
+{
+  return m_radius.size ();
+}
+
+void
+BatchPropagator::setOrbit (std::size_t slot, const CircularOrbitMobilityModelImpl &orbit) noexcept
+{
+  NS_ASSERT (slot < size ());
+
+  m_inclination[slot] = orbit.getInclination ().value ();
+  m_ascendingNode[slot] = orbit.getAscendingNode ().value ();
+  m_radius[slot] = orbit.getRadius ().value ();
+  m_phase[slot] = orbit.getPhase ().value ();
+  m_meanMotion[slot] = orbit.getMeanMotion ().value ();
+
+  m_cosPhase[slot] = std::cos (m_phase[slot]);
+  m_sinPhase[slot] = std::sin (m_phase[slot]);
+
+  const double cos_i = std::cos (m_inclination[slot]), sin_i = std::sin (m_inclination[slot]);
+  const double cos_node = std::cos (m_ascendingNode[slot]);
+  const double sin_node = std::sin (m_ascendingNode[slot]);
+
+  m_px[slot] = m_radius[slot] * cos_node;
+  m_py[slot] = m_radius[slot] * sin_node;
+  m_qx[slot] = -m_radius[slot] * cos_i * sin_node;
+  m_qy[slot] = m_radius[slot] * cos_i * cos_node;
+  m_qz[slot] = m_radius[slot] * sin_i;
+
+  updateMeanMotion ();
+}
+
+void
+BatchPropagator::updateMeanMotion () noexcept
+{
+  // Empty slots have a null mean motion and do not count
+  double n = 0.0;
+
+  m_uniformMeanMotion = true;
+  for (const auto mean_motion : m_meanMotion)
+    {
+      if (mean_motion == 0.0)
+        {
+          continue;
+        }
+      if (n == 0.0)
+        {
+          n = mean_motion;
+        }
+      else if (n != mean_motion)
+        {
+          m_uniformMeanMotion = false;
+          return;
+        }
+    }
+}
+
+void
+BatchPropagator::propagate (double t, double *x, double *y, double *z) const noexcept
+{
+  const std::size_t n_orbits = size ();
+
+  // With a single mean motion every orbit shares cos (n t) and sin (n t)
+  double shared_cos_nt = 1.0, shared_sin_nt = 0.0;
+  const double *cos_nt = &shared_cos_nt, *sin_nt = &shared_sin_nt;
+  std::size_t stride = 0;
+
+  if (m_uniformMeanMotion)
+    {
+      for (const auto mean_motion : m_meanMotion)
+        {
+          if (mean_motion != 0.0)
+            {
+              shared_cos_nt = std::cos (mean_motion * t);
+              shared_sin_nt = std::sin (mean_motion * t);
+              break;
+            }
+        }
+    }
+  else
+    {
+      for (std::size_t i = 0; i < n_orbits; i++)
+        {
+          m_cosNt[i] = std::cos (m_meanMotion[i] * t);
+          m_sinNt[i] = std::sin (m_meanMotion[i] * t);
+        }
+      cos_nt = m_cosNt.data ();
+      sin_nt = m_sinNt.data ();
+      stride = 1;
+    }
+
+  for (std::size_t i = 0; i < n_orbits; i++)
+    {
+      const double c = cos_nt[i * stride], s = sin_nt[i * stride];
+      const double cos_e = c * m_cosPhase[i] - s * m_sinPhase[i];
+      const double sin_e = s * m_cosPhase[i] + c * m_sinPhase[i];
+
+      x[i] = cos_e * m_px[i] + sin_e * m_qx[i];
+      y[i] = cos_e * m_py[i] + sin_e * m_qy[i];
+      z[i] = sin_e * m_qz[i];
+    }
+}
+
+void
+BatchPropagator::propagate (std::size_t slot, double t, double &x, double &y,
+                            double &z) const noexcept
+{
+  NS_ASSERT (slot < size ());
+
+  const double c = std::cos (m_meanMotion[slot] * t), s = std::sin (m_meanMotion[slot] * t);
+  const double cos_e = c * m_cosPhase[slot] - s * m_sinPhase[slot];
+  const double sin_e = s * m_cosPhase[slot] + c * m_sinPhase[slot];
+
+  x = cos_e * m_px[slot] + sin_e * m_qx[slot];
+  y = cos_e * m_py[slot] + sin_e * m_qy[slot];
+  z = sin_e * m_qz[slot];
+}
+
+} // namespace icarus
+} // namespace ns3
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef BATCH_PROPAGATOR_H
+#define BATCH_PROPAGATOR_H
+
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+class CircularOrbitMobilityModelImpl;
+
+/**
+ * Propagates a whole set of circular orbits at once.
+ *
+ * The orbital elements are kept as a structure of arrays. As the position of a satellite in a
+ * circular orbit is r (cos E P + sin E Q), where P and Q are the in-plane unit vectors at the
+ * ascending node and 90º ahead of it, and E = n t + phase, the propagator precomputes r P, r Q and
+ * the trigonometric functions of the phase. For a given time only the trigonometric functions of
+ * n t are needed, and they are shared by every orbit with the same radius. The rest is a few
+ * multiply and add operations per satellite that the compiler can vectorize.
+ *
+ * Slots without an orbit have a null radius and thus report a position at the origin.
+ */
+class BatchPropagator
+{
+public:
+  explicit BatchPropagator (std::size_t size);
+
+  std::size_t size () const noexcept;
+  void setOrbit (std::size_t slot, const CircularOrbitMobilityModelImpl &orbit) noexcept;
+
+  // Raw (inertial) positions of all the orbits at time t, in seconds, stored in x, y and z
+  void propagate (double t, double *x, double *y, double *z) const noexcept;
+  // Raw (inertial) position of the orbit at slot at time t, in seconds
+  void propagate (std::size_t slot, double t, double &x, double &y, double &z) const noexcept;
+
+private:
+  void updateMeanMotion () noexcept;
+
+  // Orbital elements
+  std::vector<double> m_inclination, m_ascendingNode, m_radius, m_phase;
+
+  // Derived quantities
+  std::vector<double> m_meanMotion, m_cosPhase, m_sinPhase;
+  std::vector<double> m_px, m_py, m_qx, m_qy, m_qz;
+  bool m_uniformMeanMotion;
+
+  // Scratch space for the per orbit values of cos (n t) and sin (n t)
+  mutable std::vector<double> m_cosNt, m_sinNt;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* BATCH_PROPAGATOR_H */
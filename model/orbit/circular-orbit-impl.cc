@@ -155,5 +155,11 @@ CircularOrbitMobilityModelImpl::getOrbitalPeriod () const noexcept
   return two_pi * si::radians / getN (radius, Earth);
 }
 
+CircularOrbitMobilityModelImpl::angular_velocity
+CircularOrbitMobilityModelImpl::getMeanMotion () const noexcept
+{
+  return getN (radius, Earth);
+}
+
 } // namespace icarus
 } // namespace ns3
\ No newline at end of file
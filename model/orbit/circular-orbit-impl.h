@@ -22,6 +22,7 @@
 
 #include <boost/optional/optional.hpp>
 #include <boost/units/quantity.hpp>
+#include <boost/units/systems/si/angular_velocity.hpp>
 #include <boost/units/systems/si/length.hpp>
 #include <boost/units/systems/si/plane_angle.hpp>
 #include <boost/units/systems/si/time.hpp>
@@ -35,6 +36,7 @@ public:
   typedef boost::units::quantity<boost::units::si::plane_angle> radians;
   typedef boost::units::quantity<boost::units::si::length> meters;
   typedef boost::units::quantity<boost::units::si::time> time;
+  typedef boost::units::quantity<boost::units::si::angular_velocity> angular_velocity;
 
   constexpr CircularOrbitMobilityModelImpl (radians inclination, radians ascending_node,
                                             meters radius, radians phase) noexcept
@@ -51,6 +53,26 @@ public:
     return radius;
   }
 
+  constexpr radians
+  getInclination () const noexcept
+  {
+    return inclination;
+  }
+
+  constexpr radians
+  getAscendingNode () const noexcept
+  {
+    return ascending_node;
+  }
+
+  constexpr radians
+  getPhase () const noexcept
+  {
+    return phase;
+  }
+
+  angular_velocity getMeanMotion () const noexcept;
+
   meters getSatAltitude () const noexcept;
 
   meters getGroundDistanceAtElevation (radians elevation, meters ground_radius) const noexcept;
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#include "ground-geometry.h"
+
+#include "circular-orbit-impl.h"
+#include "satpos/planet.h"
+
+#include <boost/math/constants/constants.hpp>
+
+#include <cmath>
+
+namespace ns3 {
+namespace icarus {
+
+GroundGeometry::GroundGeometry (const CircularOrbitMobilityModelImpl &orbit, double radius,
+                                const Vector &ground) noexcept
+{
+  using boost::math::double_constants::half_pi;
+  using ::icarus::satpos::planet::constants::Earth;
+
+  const double rho = std::hypot (ground.x, ground.y);
+  const double longitude = std::atan2 (ground.y, ground.x);
+  const double cos_inc = std::cos (orbit.getInclination ().value ());
+  const double sin_inc = std::sin (orbit.getInclination ().value ());
+  const double node = orbit.getAscendingNode ().value ();
+  const double phase = orbit.getPhase ().value ();
+  const double n = orbit.getMeanMotion ().value ();
+  const double omega = Earth.getRotationRate ().value ();
+
+  m_constant = radius * radius + rho * rho + ground.z * ground.z;
+  m_terms = {{{-radius * rho * (1 + cos_inc), n - omega, phase - longitude + node},
+              {-radius * rho * (1 - cos_inc), n + omega, phase + longitude - node},
+              {-2 * radius * ground.z * sin_inc, n, phase - half_pi}}};
+}
+
+void
+GroundGeometry::evaluate (double t, double &value, double &slope) const noexcept
+{
+  value = m_constant;
+  slope = 0.0;
+  for (const auto &term : m_terms)
+    {
+      const double angle = term.frequency * t + term.phase;
+      value += term.amplitude * std::cos (angle);
+      slope -= term.amplitude * term.frequency * std::sin (angle);
+    }
+}
+
+double
+GroundGeometry::getCurvatureBound () const noexcept
+{
+  double bound = 0.0;
+  for (const auto &term : m_terms)
+    {
+      bound += std::abs (term.amplitude) * term.frequency * term.frequency;
+    }
+
+  return bound;
+}
+
+double
+GroundGeometry::getSquaredDistance (double t) const noexcept
+{
+  double value, slope;
+  evaluate (t, value, slope);
+
+  return value;
+}
+
+boost::optional<double>
+GroundGeometry::getNextOvertaking (const GroundGeometry &other, double t0, double t1,
+                                   double resolution) const noexcept
+{
+  // h (t) = other distance² - this distance², positive while this satellite is the closest
+  const double bound = getCurvatureBound () + other.getCurvatureBound ();
+
+  for (double t = t0; t <= t1;)
+    {
+      double near, nearSlope, far, farSlope;
+      evaluate (t, near, nearSlope);
+      other.evaluate (t, far, farSlope);
+      const double h = far - near, slope = farSlope - nearSlope;
+      if (h <= 0)
+        {
+          return t;
+        }
+
+      // First root of h + slope τ - bound τ² / 2
+      const double step = bound > 0 ? (slope + std::sqrt (slope * slope + 2 * bound * h)) / bound
+                          : slope < 0 ? -h / slope
+                                      : t1 - t0 + resolution;
+      if (step < resolution)
+        {
+          return t + resolution <= t1 ? boost::optional<double> (t + resolution) : boost::none;
+        }
+      t += step;
+    }
+
+  return {};
+}
+
+} // namespace icarus
+} // namespace ns3
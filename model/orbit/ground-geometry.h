@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef GROUND_GEOMETRY_H
+#define GROUND_GEOMETRY_H
+
+#include "ns3/vector.h"
+
+#include <boost/optional/optional.hpp>
+
+#include <array>
+
+namespace ns3 {
+namespace icarus {
+
+class CircularOrbitMobilityModelImpl;
+
+/**
+ * Closed form of the squared distance between a ground station and a satellite on a circular
+ * orbit.
+ *
+ * In inertial coordinates the satellite is at r (cos E P + sin E Q), with E = n t + phase, and a
+ * station at distance ρ from the Earth axis, height z and longitude λ is at
+ * (ρ cos (λ + ω t), ρ sin (λ + ω t), z), where ω is the rotation rate of the Earth. With
+ * θ = λ + ω t - Ω the squared distance is
+ *
+ *   r² + ρ² + z² - r ρ (1 + cos i) cos (E - θ) - r ρ (1 - cos i) cos (E + θ)
+ *     - 2 r z sin i sin E,
+ *
+ * a constant plus three sinusoids of frequencies n - ω, n + ω and n.
+ *
+ * The difference of the squared distances to two satellites is then a sum of sinusoids as well.
+ * Its first crossing of zero has no closed form, but its second derivative is bounded by the sum
+ * of the amplitudes times the squared frequencies. So from any time where it is positive, it stays
+ * positive at least until the first root of the parabola that bounds it from below. Stepping to
+ * that root never skips a crossing, however brief, and the steps shrink quadratically close to it.
+ */
+class GroundGeometry
+{
+public:
+  // ground is an Earth fixed position and radius the one of the satellite in the same coordinates
+  GroundGeometry (const CircularOrbitMobilityModelImpl &orbit, double radius,
+                  const Vector &ground) noexcept;
+
+  // Squared distance at time t, in seconds
+  double getSquaredDistance (double t) const noexcept;
+  // The earliest time in [t0, t1] at which other gets closer to the station than this satellite,
+  // if any, up to resolution seconds late
+  boost::optional<double> getNextOvertaking (const GroundGeometry &other, double t0, double t1,
+                                             double resolution) const noexcept;
+
+private:
+  // amplitude cos (frequency t + phase)
+  struct Term
+  {
+    double amplitude, frequency, phase;
+  };
+
+  // Squared distance and its derivative at time t
+  void evaluate (double t, double &value, double &slope) const noexcept;
+  // Bound of the second derivative of the squared distance
+  double getCurvatureBound () const noexcept;
+
+  double m_constant;
+  std::array<Term, 3> m_terms;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* GROUND_GEOMETRY_H */
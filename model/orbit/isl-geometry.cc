@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "isl-geometry.h"
+
+#include "circular-orbit-impl.h"
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+namespace icarus {
+
+namespace {
+using boost::math::double_constants::pi;
+
+// Relative difference of radii below which two orbits are taken as the same shell
+constexpr double RADIUS_TOLERANCE = 1e-12;
+// Amplitudes below this correspond to a constant distance
+constexpr double AMPLITUDE_TOLERANCE = 1e-12;
+
+struct PlaneVectors
+{
+  double p[3], q[3];
+};
+
+// Unit vectors of the orbit at the ascending node and 90º ahead of it, rotated by angle
+PlaneVectors
+getPlaneVectors (const CircularOrbitMobilityModelImpl &orbit, double angle) noexcept
+{
+  const double cos_node = std::cos (orbit.getAscendingNode ().value ());
+  const double sin_node = std::sin (orbit.getAscendingNode ().value ());
+  const double cos_inc = std::cos (orbit.getInclination ().value ());
+  const double sin_inc = std::sin (orbit.getInclination ().value ());
+  const double p[3] = {cos_node, sin_node, 0.0};
+  const double q[3] = {-cos_inc * sin_node, cos_inc * cos_node, sin_inc};
+  const double c = std::cos (angle), s = std::sin (angle);
+
+  PlaneVectors vectors;
+  for (int i = 0; i < 3; i++)
+    {
+      vectors.p[i] = c * p[i] + s * q[i];
+      vectors.q[i] = c * q[i] - s * p[i];
+    }
+
+  return vectors;
+}
+
+double
+dot (const double *a, const double *b) noexcept
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+} // namespace
+
+boost::optional<IslGeometry>
+IslGeometry::create (const CircularOrbitMobilityModelImpl &first,
+                     const CircularOrbitMobilityModelImpl &second)
+{
+  const double radius = first.getRadius ().value ();
+  if (std::abs (second.getRadius ().value () - radius) > radius * RADIUS_TOLERANCE)
+    {
+      return {};
+    }
+
+  const auto one = getPlaneVectors (first, 0.0);
+  const auto two =
+      getPlaneVectors (second, second.getPhase ().value () - first.getPhase ().value ());
+
+  // u1 · u2 = a cos² E + b sin E cos E + c sin² E
+  const double a = dot (one.p, two.p);
+  const double b = dot (one.p, two.q) + dot (one.q, two.p);
+  const double c = dot (one.q, two.q);
+
+  return IslGeometry (radius, first.getMeanMotion ().value (), first.getPhase ().value (), a, b,
+                      c);
+}
+
+IslGeometry::IslGeometry (double radius, double meanMotion, double phase, double a, double b,
+                          double c) noexcept
+    : m_radius (radius),
+      m_meanMotion (meanMotion),
+      m_phase (phase),
+      m_mean ((a + c) / 2),
+      m_amplitude (std::hypot ((a - c) / 2, b / 2)),
+      m_shift (std::atan2 (b / 2, (a - c) / 2))
+{
+}
+
+double
+IslGeometry::getDistance (double t) const noexcept
+{
+  const double E = m_meanMotion * t + m_phase;
+  const double cosine = m_mean + m_amplitude * std::cos (2 * E - m_shift);
+
+  return m_radius * std::sqrt (std::max (0.0, 2 * (1 - cosine)));
+}
+
+boost::optional<double>
+IslGeometry::getNextCrossing (double t, double distance) const noexcept
+{
+  if (m_amplitude < AMPLITUDE_TOLERANCE)
+    {
+      return {};
+    }
+
+  // Solve cos (2E - shift) = x. Tangent solutions do not cross the distance.
+  const double x =
+      (1 - distance * distance / (2 * m_radius * m_radius) - m_mean) / m_amplitude;
+  if (std::abs (x) >= 1)
+    {
+      return {};
+    }
+
+  const double E0 = m_meanMotion * t + m_phase;
+  const double alpha = std::acos (x);
+  double next = std::numeric_limits<double>::infinity ();
+  for (const double root : {(m_shift + alpha) / 2, (m_shift - alpha) / 2})
+    {
+      // The solutions repeat every π
+      double E = root + std::ceil ((E0 - root) / pi) * pi;
+      if (E <= E0)
+        {
+          E += pi;
+        }
+      next = std::min (next, E);
+    }
+
+  return (next - m_phase) / m_meanMotion;
+}
+
+} // namespace icarus
+} // namespace ns3
@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef ISL_GEOMETRY_H
+#define ISL_GEOMETRY_H
+
+#include <boost/optional/optional.hpp>
+
+namespace ns3 {
+namespace icarus {
+
+class CircularOrbitMobilityModelImpl;
+
+/**
+ * Closed form of the distance between two satellites on circular orbits of the same radius.
+ *
+ * Both satellites share the mean motion n, so with the unit vectors u1 and u2 pointing to them
+ * and E = n t + phase1, the one of the second satellite is cos E P2' + sin E Q2', where P2' and
+ * Q2' are the in-plane vectors of its orbit rotated by the constant phase difference. Then
+ * u1 · u2 = A + B cos 2E + C sin 2E, and the distance is r sqrt (2 (1 - u1 · u2)). The Earth
+ * rotation moves both satellites alike, so it does not change the distance.
+ *
+ * The distance between satellites of the same plane is constant. For other pairs it is periodic,
+ * with half the orbital period, and the times at which it crosses a given value are the solutions
+ * of a single cosine equation.
+ */
+class IslGeometry
+{
+public:
+  // The geometry of the pair, unless their radii differ
+  static boost::optional<IslGeometry> create (const CircularOrbitMobilityModelImpl &first,
+                                              const CircularOrbitMobilityModelImpl &second);
+
+  // Distance between the satellites at time t, in seconds
+  double getDistance (double t) const noexcept;
+  // The earliest time after t at which the distance crosses the given value, if it ever does
+  boost::optional<double> getNextCrossing (double t, double distance) const noexcept;
+
+private:
+  IslGeometry (double radius, double meanMotion, double phase, double a, double b,
+               double c) noexcept;
+
+  double m_radius, m_meanMotion, m_phase;
+  // u1 · u2 = m_mean + m_amplitude cos (2E - m_shift)
+  double m_mean, m_amplitude, m_shift;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* ISL_GEOMETRY_H */
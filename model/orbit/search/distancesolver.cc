@@ -21,19 +21,18 @@
 #include "distancesolver.h"
 
 #include "../satpos/planet.h"
-#include "ns3/circular-orbit.h"
 #include "../circular-orbit-impl.h"
 
 #include <boost/optional/optional.hpp>
 #include <boost/units/quantity.hpp>
+#include <boost/units/cmath.hpp>
 #include <boost/units/pow.hpp>
-#include <boost/units/operators.hpp>
 #include <boost/math/constants/constants.hpp>
 
 #include <boost/units/systems/si/time.hpp>
-#include <gsl/gsl_errno.h>
-#include <gsl/gsl_roots.h>
-#include <gsl/gsl_math.h>
+
+#include <algorithm>
+#include <cmath>
 
 using namespace icarus::satpos::planet::constants;
 
@@ -45,156 +44,220 @@ namespace {
 using boost::units::quantity;
 using namespace boost::units::si;
 
-class GroundObserver
+/*
+ * Both the satellite and the ground observer move along circles, so the cosine of the angle
+ * between them, as seen from the centre of the Earth, determines their distance:
+ *
+ *     d² = r² + ρ² - 2 r ρ cos γ
+ *
+ * The observer is within distance D of the satellite whenever g (t) = cos γ (t) - cos γ* > 0, with
+ * cos γ* = (r² + ρ² - D²) / (2 r ρ). Ignoring the rotation of the Earth during a pass, cos γ is a
+ * sinusoid in the satellite phase E with amplitude K, so the pass is centred at the time of
+ * closest approach and lasts 2 acos (cos γ* / K) / n. That gives a bracket and a very good first
+ * guess for both crossings, which are then polished with a safeguarded Newton method using the
+ * analytic derivative of g.
+ */
+class VisibilitySolver
 {
-  using plane_angle = boost::units::si::plane_angle;
-  using length = boost::units::si::length;
-  using time = boost::units::si::time;
+public:
+  VisibilitySolver (const CircularOrbitMobilityModelImpl &sat, quantity<plane_angle> latitude,
+                    quantity<plane_angle> longitude, quantity<length> radius,
+                    quantity<length> distance) noexcept
+      : n (sat.getMeanMotion ().value ()),
+        phase (sat.getPhase ().value ()),
+        omega (Earth.getRotationRate ().value ()),
+        longitude (longitude.value ()),
+        cos_latitude (cos (latitude)),
+        sin_latitude (sin (latitude)),
+        target ((pow<2> (sat.getRadius ()) + pow<2> (radius) - pow<2> (distance)) /
+                (2.0 * sat.getRadius () * radius)),
+        synodic_period (boost::math::double_constants::two_pi /
+                        (n - omega * cos (sat.getInclination ())))
+  {
+    const double cos_i = cos (sat.getInclination ()), sin_i = sin (sat.getInclination ());
+    const double cos_node = cos (sat.getAscendingNode ());
+    const double sin_node = sin (sat.getAscendingNode ());
+
+    px = cos_node;
+    py = sin_node;
+    qx = -cos_i * sin_node;
+    qy = cos_i * cos_node;
+    qz = sin_i;
+  }
 
-  using vector3d = std::tuple<quantity<length>, quantity<length>, quantity<length>>;
+  // Whether the distance can be crossed at all
+  bool
+  isReachable () const noexcept
+  {
+    return std::abs (target) < 1.0;
+  }
 
-public:
-  constexpr GroundObserver (quantity<plane_angle> latitude, quantity<plane_angle> longitude,
-                            quantity<length> radius) noexcept
-      : latitude (latitude), longitude (longitude), radius (radius)
+  // Whether the satellite is always closer than the target distance
+  bool
+  isAlwaysVisible () const noexcept
   {
+    return target <= -1.0;
   }
 
-  constexpr vector3d
-  operator() (boost::units::quantity<time> t) const noexcept
+  // Value of g (t) and its derivative
+  std::pair<double, double>
+  evaluate (double t) const noexcept
   {
-    using namespace boost::math::double_constants;
+    const double e = n * t + phase;
+    const double cos_e = std::cos (e), sin_e = std::sin (e);
+    const double a = longitude + omega * t;
+    const double cos_a = std::cos (a), sin_a = std::sin (a);
 
-    const auto apparent_longitude = longitude + Earth.getRotationRate () * t;
+    const double ox = cos_latitude * cos_a, oy = cos_latitude * sin_a, oz = sin_latitude;
+    const double po = px * ox + py * oy, qo = qx * ox + qy * oy + qz * oz;
+    // Derivative of the observer position, divided by omega · cos (latitude)
+    const double pdo = -px * sin_a + py * cos_a, qdo = -qx * sin_a + qy * cos_a;
 
-    const auto x = radius * cos (apparent_longitude) * cos (latitude);
-    const auto y = radius * sin (apparent_longitude) * cos (latitude);
-    const auto z = radius * sin (latitude);
+    const double g = cos_e * po + sin_e * qo - target;
+    const double dg =
+        n * (cos_e * qo - sin_e * po) + omega * cos_latitude * (cos_e * pdo + sin_e * qdo);
 
-    return std::make_tuple (x, y, z);
+    return std::make_pair (g, dg);
   }
 
-private:
-  const quantity<plane_angle> latitude, longitude;
-  const quantity<length> radius;
-};
-
-template <typename T>
-constexpr auto
-sq_distance (std::tuple<T, T, T> a, std::tuple<T, T, T> b) -> auto
-{
-  T a1, a2, a3, b1, b2, b3;
+  // Time of the closest approach nearest to t, and the amplitude of cos γ around it
+  std::pair<double, double>
+  closestApproach (double t) const noexcept
+  {
+    using namespace boost::math::double_constants;
 
-  std::tie (a1, a2, a3) = a;
-  std::tie (b1, b2, b3) = b;
+    double amplitude = 0.0;
 
-  return pow<2> (b1 - a1) + pow<2> (b2 - a2) + pow<2> (b3 - a3);
-}
+    // The observer hardly moves during a pass, so a few fixed point iterations are enough
+    for (int i = 0; i < 4; i++)
+      {
+        const double a = longitude + omega * t;
+        const double ox = cos_latitude * std::cos (a), oy = cos_latitude * std::sin (a);
+        const double po = px * ox + py * oy, qo = qx * ox + qy * oy + qz * sin_latitude;
 
-class DistanceSolver
-{
-  using Satellite = CircularOrbitMobilityModelImpl;
-  using time = boost::units::si::time;
+        amplitude = std::hypot (po, qo);
+        t += std::remainder (std::atan2 (qo, po) - (n * t + phase), two_pi) / n;
+      }
 
-public:
-  DistanceSolver (quantity<time> min, quantity<time> max, const GroundObserver &observer,
-                  const Satellite &sat, quantity<length> target_distance) noexcept
-      : min (min),
-        max (max),
-        obs (observer),
-        sat (sat),
-        target_sq (pow<2> (target_distance)),
-        T (gsl_root_fsolver_brent),
-        s (gsl_root_fsolver_alloc (T))
-  {
-    old_handler = gsl_set_error_handler_off ();
-  }
-  ~DistanceSolver () noexcept
-  {
-    gsl_root_fsolver_free (s);
-    gsl_set_error_handler (old_handler);
+    return std::make_pair (t, amplitude);
   }
 
-  boost::optional<quantity<time>>
-  operator() () noexcept
+  // Approximate time between two consecutive closest approaches
+  double
+  getSynodicPeriod () const noexcept
   {
-    solve ();
-
-    return solution;
+    return synodic_period;
   }
 
-private:
-  const quantity<time> min, max;
-  const GroundObserver &obs;
-  const Satellite &sat;
-  const quantity<boost::units::multiply_typeof_helper<length, length>::type> target_sq;
-
-  const gsl_root_fsolver_type *T;
-  gsl_root_fsolver *s;
-  bool run = false;
-  boost::optional<quantity<time>> solution{};
-  gsl_error_handler_t *old_handler = nullptr;
-
-  static double
-  distance_function_rep (double x, void *params) noexcept
+  // Approximate duration of half a pass with the given amplitude of cos γ
+  double
+  getHalfPass (double amplitude) const noexcept
   {
-    DistanceSolver *self = static_cast<DistanceSolver *> (params);
-    return self->distance_function (x);
+    return std::acos (std::min (1.0, target / amplitude)) / n;
   }
 
-  void
-  solve () noexcept
+  // Root of g in [a, b] starting at guess, if g changes sign in the interval
+  boost::optional<double>
+  findRoot (double a, double b, double guess) const noexcept
   {
-    if (run)
-      return;
-
-    run = true;
-    double x_lower = min.value (), x_upper = max.value ();
+    constexpr double tolerance = 1e-6; // seconds
+    constexpr int max_iter = 100;
 
-    gsl_function F;
-    F.function = &DistanceSolver::distance_function_rep;
-    F.params = this;
-    gsl_root_fsolver_set (s, &F, min.value (), max.value ());
+    const double fa = evaluate (a).first, fb = evaluate (b).first;
+    if (fa == 0.0)
+      {
+        return a;
+      }
+    if (fb == 0.0)
+      {
+        return b;
+      }
+    if ((fa > 0.0) == (fb > 0.0))
+      {
+        return {};
+      }
 
-    int iter = 0;
-    const int max_iter = 1000;
-    int status;
+    // Keep g (low) < 0 < g (high)
+    double low = fa < 0.0 ? a : b, high = fa < 0.0 ? b : a;
+    double t = (guess > std::min (a, b) && guess < std::max (a, b)) ? guess : (a + b) / 2.0;
+    double step = std::abs (b - a), old_step = step;
 
-    do
+    for (int iter = 0; iter < max_iter; iter++)
       {
-        iter++;
-        status = gsl_root_fsolver_iterate (s);
-        double r = gsl_root_fsolver_root (s);
-        x_lower = gsl_root_fsolver_x_lower (s);
-        x_upper = gsl_root_fsolver_x_upper (s);
-        status = gsl_root_test_interval (x_lower, x_upper, 0, 0.000001);
-
-        if (status == GSL_SUCCESS)
+        double g, dg;
+        std::tie (g, dg) = evaluate (t);
+
+        if (g < 0.0)
           {
-            /* We simply check that the distance drops below target near the
-            found root. This is to ensure that the result is not just a point
-            where the distance gets close to 0, but without even crossing the
-            target threshold. */
-            if (std::min (distance_function (r - 1), distance_function (r + 1)) < 0)
-              {
-                solution = r * second;
-              }
-            break;
+            low = t;
+          }
+        else
+          {
+            high = t;
           }
-    } while (status == GSL_CONTINUE && iter < max_iter);
-  }
 
-  double
-  distance_function (double x) const noexcept
-  {
-    quantity<time> t (x * seconds);
+        // Bisect whenever Newton would leave the bracket or is not converging fast enough
+        if (((t - high) * dg - g) * ((t - low) * dg - g) > 0.0 ||
+            std::abs (2.0 * g) > std::abs (old_step * dg))
+          {
+            old_step = step;
+            step = (high - low) / 2.0;
+            t = low + step;
+          }
+        else
+          {
+            old_step = step;
+            step = g / dg;
+            t -= step;
+          }
+
+        if (std::abs (step) < tolerance)
+          {
+            return t;
+          }
+      }
 
-    return (sq_distance (sat.getCartesianPositionRightAscensionDeclination (t), obs (t)) -
-            target_sq)
-        .value ();
+    return t;
   }
+
+private:
+  const double n, phase, omega;
+  const double longitude, cos_latitude, sin_latitude;
+  const double target;
+  const double synodic_period;
+  double px, py, qx, qy, qz;
 };
 
+/*
+ * Calls f (rise, set) for every pass whose closest approach is near [begin, end]. The rise (set)
+ * time is missing if the satellite does not cross the target distance in the preceding
+ * (following) half synodic period.
+ */
+template <typename F>
+void
+forEachPass (const VisibilitySolver &solver, double begin, double end, F &&f)
+{
+  const double period = solver.getSynodicPeriod ();
+
+  // Consecutive approaches drift with respect to the orbital period, so chain them
+  for (auto next = solver.closestApproach (solver.closestApproach (begin).first - period);
+       next.first - period / 2.0 <= end; next = solver.closestApproach (next.first + period))
+    {
+      double approach, amplitude;
+      std::tie (approach, amplitude) = next;
+
+      if (approach + period / 2.0 < begin || solver.evaluate (approach).first <= 0.0)
+        {
+          continue;
+        }
+
+      const double half_pass = solver.getHalfPass (amplitude);
+      f (solver.findRoot (approach - period / 2.0, approach, approach - half_pass),
+         solver.findRoot (approach, approach + period / 2.0, approach + half_pass), approach,
+         period);
+    }
+}
+
 } // namespace
 
 boost::optional<quantity<boost::units::si::time>>
@@ -202,24 +265,77 @@ findNextCross (quantity<boost::units::si::time> now, CircularOrbitMobilityModelI
                quantity<length> distance, quantity<plane_angle> latitude,
                quantity<plane_angle> longitude, quantity<length> radius)
 {
+  const VisibilitySolver solver (satellite, latitude, longitude, radius, distance);
+  if (!solver.isReachable ())
+    {
+      return {};
+    }
 
-  const auto orbitalPeriod = satellite.getOrbitalPeriod ();
-  const GroundObserver observer (latitude, longitude, radius);
+  const double begin = now.value (), end = begin + satellite.getOrbitalPeriod ().value ();
+  boost::optional<double> sol;
+
+  forEachPass (solver, begin, end,
+               [begin, end, &sol] (boost::optional<double> rise, boost::optional<double> set,
+                                   double, double) {
+                 for (const auto &root : {rise, set})
+                   {
+                     if (root && *root >= begin && *root <= end && (!sol || *root < *sol))
+                       {
+                         sol = *root;
+                       }
+                   }
+               });
 
-  // Find the first cross, going half a period at a time
-  auto sol = DistanceSolver (now, now + orbitalPeriod, observer, satellite, distance) ();
-  // If there is a solution, check whether there is a previous one
   if (sol)
     {
-      if (now < *sol - 1 * second)
-        {
-          const auto previous =
-              DistanceSolver (now, *sol - 1 * second, observer, satellite, distance) ();
-          sol = previous ? previous : sol;
-        }
+      return *sol * second;
+    }
+
+  return {};
+}
+
+std::vector<std::pair<quantity<boost::units::si::time>, quantity<boost::units::si::time>>>
+findPasses (quantity<boost::units::si::time> begin, quantity<boost::units::si::time> end,
+            CircularOrbitMobilityModelImpl satellite, quantity<length> distance,
+            quantity<plane_angle> latitude, quantity<plane_angle> longitude,
+            quantity<length> radius)
+{
+  std::vector<std::pair<quantity<boost::units::si::time>, quantity<boost::units::si::time>>>
+      passes;
+
+  const VisibilitySolver solver (satellite, latitude, longitude, radius, distance);
+  if (solver.isAlwaysVisible () && begin < end)
+    {
+      passes.emplace_back (begin, end);
+    }
+  if (!solver.isReachable () || end <= begin)
+    {
+      return passes;
     }
 
-  return sol;
+  forEachPass (solver, begin.value (), end.value (),
+               [begin, end, &passes] (boost::optional<double> rise, boost::optional<double> set,
+                                      double approach, double period) {
+                 // Without a crossing the satellite stays in sight for the whole half period
+                 const auto from =
+                     std::max (rise.value_or (approach - period / 2.0) * second, begin);
+                 const auto to = std::min (set.value_or (approach + period / 2.0) * second, end);
+                 if (from >= to)
+                   {
+                     return;
+                   }
+
+                 if (!passes.empty () && from <= passes.back ().second)
+                   {
+                     passes.back ().second = std::max (passes.back ().second, to);
+                   }
+                 else
+                   {
+                     passes.emplace_back (from, to);
+                   }
+               });
+
+  return passes;
 }
 
 } // namespace orbit
@@ -25,6 +25,9 @@
 
 #include <boost/optional/optional.hpp>
 
+#include <utility>
+#include <vector>
+
 namespace ns3 {
 namespace icarus {
 namespace orbit {
@@ -37,6 +40,18 @@ findNextCross (boost::units::quantity<boost::units::si::time> now,
                boost::units::quantity<boost::units::si::plane_angle> longitude,
                boost::units::quantity<boost::units::si::length> radius);
 
+// Intervals within [begin, end] during which the satellite is closer than distance to the
+// observer, sorted by start time
+std::vector<std::pair<boost::units::quantity<boost::units::si::time>,
+                      boost::units::quantity<boost::units::si::time>>>
+findPasses (boost::units::quantity<boost::units::si::time> begin,
+            boost::units::quantity<boost::units::si::time> end,
+            CircularOrbitMobilityModelImpl satellite,
+            boost::units::quantity<boost::units::si::length> distance,
+            boost::units::quantity<boost::units::si::plane_angle> latitude,
+            boost::units::quantity<boost::units::si::plane_angle> longitude,
+            boost::units::quantity<boost::units::si::length> radius);
+
 } // namespace orbit
 } // namespace icarus
 } // namespace ns3
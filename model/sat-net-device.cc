@@ -119,7 +119,7 @@ SatNetDevice::GetTypeId (void)
   return tid;
 }
 
-SatNetDevice::SatNetDevice () : m_channel (0), m_txMachineState (IDLE)
+SatNetDevice::SatNetDevice () : m_channel (0), m_fabric (0), m_slot (0), m_txMachineState (IDLE)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -153,7 +153,10 @@ SatNetDevice::TransmitStart (const Ptr<Packet> &packet, uint16_t protocolNumber)
   m_txMachineState = TRANSMITTING;
 
   m_phyTxBeginTrace (packet);
-  Time endTx = GetInternalChannel ()->TransmitStart (packet, this, GetDataRate (), protocolNumber);
+  Time endTx =
+      m_fabric != nullptr
+          ? m_fabric->TransmitStart (packet, m_slot, GetDataRate (), protocolNumber)
+          : GetInternalChannel ()->TransmitStart (packet, this, GetDataRate (), protocolNumber);
   Simulator::Schedule (endTx, &SatNetDevice::TransmitComplete, this, packet, protocolNumber);
 }
 
@@ -188,6 +191,38 @@ SatNetDevice::Attach (const Ptr<Sat2SatChannel> &channel)
   return false;
 }
 
+bool
+SatNetDevice::Attach (const Ptr<IslFabric> &fabric, std::size_t slot)
+{
+  NS_LOG_FUNCTION (this << fabric << slot);
+
+  if (fabric->Attach (this, slot))
+    {
+      m_fabric = fabric;
+      m_slot = slot;
+      m_linkChangeCallbacks ();
+      return true;
+    }
+
+  return false;
+}
+
+Ptr<SatNetDevice>
+SatNetDevice::GetRemoteDevice () const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_fabric != nullptr)
+    {
+      return m_fabric->GetPeer (m_slot);
+    }
+
+  NS_ASSERT (m_channel != nullptr);
+  const auto remote = DynamicCast<SatNetDevice> (m_channel->GetDevice (0));
+
+  return remote != this ? remote : DynamicCast<SatNetDevice> (m_channel->GetDevice (1));
+}
+
 Ptr<Queue<Packet>>
 SatNetDevice::GetQueue () const
 {
@@ -214,6 +249,15 @@ SatNetDevice::Receive (Ptr<Packet> packet, DataRate bps, uint16_t protocolNumber
                        this, packet, protocolNumber);
 }
 
+void
+SatNetDevice::ReceiveCutThrough (Ptr<Packet> packet, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packet << protocolNumber);
+
+  m_phyRxBeginTrace (packet);
+  ReceiveFinish (packet, protocolNumber);
+}
+
 void
 SatNetDevice::ReceiveFinish (const Ptr<Packet> &packet, uint16_t protocolNumber)
 {
@@ -256,6 +300,11 @@ SatNetDevice::GetChannel (void) const
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_fabric != nullptr)
+    {
+      return m_fabric;
+    }
+
   return m_channel;
 }
 
@@ -299,7 +348,20 @@ SatNetDevice::IsLinkUp (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  return m_channel != 0;
+  if (m_fabric != nullptr)
+    {
+      return m_fabric->IsLinkUp (m_slot);
+    }
+
+  return m_channel != 0 && m_channel->IsLinkUp ();
+}
+
+void
+SatNetDevice::NotifyLinkChange ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_linkChangeCallbacks ();
 }
 
 void
@@ -27,6 +27,7 @@
 #include "ns3/net-device.h"
 #include "ns3/mac48-address.h"
 #include "ns3/queue.h"
+#include "isl-fabric.h"
 #include "sat2sat-channel.h"
 
 namespace ns3 {
@@ -48,11 +49,18 @@ public:
   virtual void SetDataRate (DataRate rate);
 
   bool Attach (const Ptr<Sat2SatChannel> &channel);
+  bool Attach (const Ptr<IslFabric> &fabric, std::size_t slot);
+  // The device at the other end of the link
+  Ptr<SatNetDevice> GetRemoteDevice () const;
 
   virtual Ptr<Queue<Packet>> GetQueue () const;
   virtual void SetQueue (Ptr<Queue<Packet>> rate);
 
   void Receive (Ptr<Packet> packet, DataRate bps, uint16_t protocolNumber);
+  // Receive a whole frame in a single event at the end of its reception
+  void ReceiveCutThrough (Ptr<Packet> packet, uint16_t protocolNumber);
+  // Called by the channel when the link goes up or down
+  void NotifyLinkChange ();
 
   virtual void SetIfIndex (const uint32_t index) override;
   virtual uint32_t GetIfIndex (void) const override;
@@ -98,6 +106,9 @@ private:
   uint32_t m_ifIndex;
   Ptr<Queue<Packet>> m_queue;
   Ptr<Sat2SatChannel> m_channel;
+  // Set instead of m_channel when the device is attached to a slot of a fabric
+  Ptr<IslFabric> m_fabric;
+  std::size_t m_slot;
   Ptr<Node> m_node;
   uint16_t m_mtu;
   static constexpr uint16_t DEFAULT_MTU = 1500;
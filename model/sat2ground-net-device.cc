@@ -29,129 +29,20 @@
 #include "ns3/mac48-address.h"
 #include "ns3/sat-address.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-size.h"
+#include "ns3/string.h"
 #include "ns3/uinteger.h"
 #include "ns3/abort.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+
 namespace ns3 {
 namespace icarus {
 NS_LOG_COMPONENT_DEFINE ("icarus.Sat2GroundNetDevice");
 
 NS_OBJECT_ENSURE_REGISTERED (Sat2GroundNetDevice);
 
-namespace {
-/**
- * \brief Tag to store source, destination, protocol and power of each packet.
- */
-class SatGroundTag : public Tag
-{
-public:
-  /**
-   * \brief Get the type ID.
-   * \return the object TypeId
-   */
-  static TypeId GetTypeId (void);
-  virtual TypeId GetInstanceTypeId (void) const override;
-
-  virtual uint32_t GetSerializedSize (void) const override;
-  virtual void Serialize (TagBuffer i) const override;
-  virtual void Deserialize (TagBuffer i) override;
-
-  /**
-   * Set the protocol number
-   * \param proto protocol number
-   */
-  void
-  SetProto (uint16_t proto)
-  {
-    m_protocolNumber = proto;
-  }
-  /**
-   * Get the protocol number
-   * \return the protocol number
-   */
-  uint16_t
-  GetProto (void) const
-  {
-    return m_protocolNumber;
-  }
-
-  /**
-   * Set the packet power
-   * \param power packet power
-   */
-  void
-  SetPower (double power)
-  {
-    m_power = power;
-  }
-  /**
-   * Get the packet power
-   * \return the packet power
-   */
-  double
-  GetPower (void) const
-  {
-    return m_power;
-  }
-
-  void Print (std::ostream &os) const override;
-
-private:
-  Mac48Address m_dst; //!< destination address
-  uint16_t m_protocolNumber; //!< protocol number
-  double m_power; //!< packet power
-};
-
-NS_OBJECT_ENSURE_REGISTERED (SatGroundTag);
-
-TypeId
-SatGroundTag::GetTypeId (void)
-{
-  static TypeId tid = TypeId ("ns3::SatGroundTag")
-                          .SetParent<Tag> ()
-                          .SetGroupName ("ICARUS")
-                          .AddConstructor<SatGroundTag> ();
-  return tid;
-}
-TypeId
-SatGroundTag::GetInstanceTypeId (void) const
-{
-  return GetTypeId ();
-}
-
-uint32_t
-SatGroundTag::GetSerializedSize (void) const
-{
-  return 8 + 8 + 2 + 8;
-}
-void
-SatGroundTag::Serialize (TagBuffer i) const
-{
-  uint8_t mac[6];
-  m_dst.CopyTo (mac);
-  i.Write (mac, 6);
-  i.WriteU16 (m_protocolNumber);
-  i.WriteDouble (m_power);
-}
-void
-SatGroundTag::Deserialize (TagBuffer i)
-{
-  uint8_t mac[6];
-
-  i.Read (mac, 6);
-  m_dst.CopyFrom (mac);
-  m_protocolNumber = i.ReadU16 ();
-  m_power = i.ReadDouble ();
-}
-
-void
-SatGroundTag::Print (std::ostream &os) const
-{
-  os << " dst=" << m_dst << " proto=" << m_protocolNumber << " power=" << m_power;
-}
-} // namespace
-
 TypeId
 Sat2GroundNetDevice::GetTypeId (void)
 {
@@ -169,7 +60,24 @@ Sat2GroundNetDevice::GetTypeId (void)
           .AddAttribute (
               "TxPower", "The transmission power for this device (in dBm)", DoubleValue (0),
               MakeDoubleAccessor (&IcarusNetDevice::SetTxPower, &IcarusNetDevice::GetTxPower),
-              MakeDoubleChecker<double> ());
+              MakeDoubleChecker<double> ())
+          .AddAttribute ("NCarriers",
+                         "The number of downlink carriers. Each one transmits a different packet "
+                         "at DataRate in parallel with the others.",
+                         UintegerValue (1),
+                         MakeUintegerAccessor (&Sat2GroundNetDevice::SetNCarriers,
+                                               &Sat2GroundNetDevice::GetNCarriers),
+                         MakeUintegerChecker<uint32_t> (1))
+          .AddAttribute ("Scheduler",
+                         "The TypeId name of a DownlinkScheduler. If set, every device creates "
+                         "its own one, packets wait in a queue per destination address, created "
+                         "like TxQueue, and the scheduler picks the next one to transmit. The NDN "
+                         "transport addresses Data and Nacks to the ground station that sent the "
+                         "Interest, and everything else to the broadcast address.",
+                         StringValue (""),
+                         MakeStringAccessor (&Sat2GroundNetDevice::SetScheduler,
+                                             &Sat2GroundNetDevice::GetScheduler),
+                         MakeStringChecker ());
 
   return tid;
 }
@@ -179,6 +87,20 @@ Sat2GroundNetDevice::~Sat2GroundNetDevice ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+void
+Sat2GroundNetDevice::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Let the MAC model check its configuration before the first frame
+  if (m_macModel != nullptr)
+    {
+      m_macModel->Initialize ();
+    }
+
+  IcarusNetDevice::DoInitialize ();
+}
+
 bool
 Sat2GroundNetDevice::Attach (const Ptr<GroundSatChannel> &channel)
 {
@@ -304,69 +226,186 @@ Sat2GroundNetDevice::Send (Ptr<Packet> packet, const Address &dest, uint16_t pro
 {
   NS_LOG_FUNCTION (this << packet << dest << protocolNumber);
 
-  SatGroundTag tag;
-  tag.SetProto (protocolNumber);
-  tag.SetPower (GetTxPower ());
-  packet->AddPacketTag (tag);
-
   m_macTxTrace (packet);
-  if (GetQueue ()->Enqueue (packet) == false)
+  const auto voq = m_scheduler != nullptr ? GetVirtualQueue (dest) : 0;
+  const auto queue = m_scheduler != nullptr ? m_voqs[voq] : GetQueue ();
+  if (queue->Enqueue (packet) == false)
     {
       m_macTxDropTrace (packet);
       return false;
     }
+  (m_scheduler != nullptr ? m_voqMetadata[voq] : m_txMetadata)
+      .Push (packet, {protocolNumber, GetTxPower ()});
+
+  ScheduleTransmissions ();
+
+  return true;
+}
+
+void
+Sat2GroundNetDevice::SetNCarriers (uint32_t nCarriers)
+{
+  NS_LOG_FUNCTION (this << nCarriers);
+  NS_ABORT_MSG_IF (std::find (m_carriers.cbegin (), m_carriers.cend (), BUSY) != m_carriers.cend (),
+                   "Cannot change the number of carriers while transmitting");
+
+  m_carriers.assign (nCarriers, IDLE);
+}
+
+uint32_t
+Sat2GroundNetDevice::GetNCarriers () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_carriers.size ();
+}
+
+void
+Sat2GroundNetDevice::SetScheduler (const std::string &type)
+{
+  NS_LOG_FUNCTION (this << type);
+  NS_ABORT_MSG_IF (!m_voqs.empty (), "Cannot change the scheduler once packets have been sent");
 
-  NS_LOG_INFO (
-      "Should we be able to perform simultaneous transmissions to DIFFERENT ground stations?");
-  if (m_txMachineState == IDLE)
+  if (type.empty ())
     {
-      m_txMachineState = BUSY;
-      TransmitStart ();
+      m_scheduler = nullptr;
+      return;
     }
 
-  return true;
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  m_scheduler = factory.Create<DownlinkScheduler> ();
+  NS_ABORT_MSG_IF (m_scheduler == nullptr, type << " is not a DownlinkScheduler");
+}
+
+std::string
+Sat2GroundNetDevice::GetScheduler () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_scheduler != nullptr ? m_scheduler->GetInstanceTypeId ().GetName () : "";
+}
+
+uint32_t
+Sat2GroundNetDevice::GetQueuedBytes () const
+{
+  NS_LOG_FUNCTION (this);
+
+  auto bytes = GetQueue ()->GetNBytes ();
+  for (const auto &queue : m_voqs)
+    {
+      bytes += queue->GetNBytes ();
+    }
+
+  return bytes;
+}
+
+std::size_t
+Sat2GroundNetDevice::GetVirtualQueue (const Address &dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  const auto position = m_voqIndex.find (dest);
+  if (position != m_voqIndex.end ())
+    {
+      return position->second;
+    }
+
+  ObjectFactory factory;
+  factory.SetTypeId (GetQueue ()->GetInstanceTypeId ());
+  QueueSizeValue maxSize;
+  GetQueue ()->GetAttribute ("MaxSize", maxSize);
+  factory.Set ("MaxSize", maxSize);
+
+  NS_LOG_DEBUG ("New downlink queue for " << dest);
+  m_voqIndex.emplace (dest, m_voqs.size ());
+  m_voqs.push_back (factory.Create<Queue<Packet>> ());
+  m_voqMetadata.emplace_back ();
+
+  return m_voqs.size () - 1;
+}
+
+bool
+Sat2GroundNetDevice::HasQueuedPackets () const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_scheduler == nullptr)
+    {
+      return !GetQueue ()->IsEmpty ();
+    }
+
+  return std::any_of (m_voqs.cbegin (), m_voqs.cend (),
+                      [] (const Ptr<Queue<Packet>> &queue) { return !queue->IsEmpty (); });
+}
+
+Ptr<Packet>
+Sat2GroundNetDevice::DequeueNext (TxMetadata &metadata)
+{
+  NS_LOG_FUNCTION (this);
+
+  const auto voq = m_scheduler != nullptr ? m_scheduler->Select (m_voqs) : 0;
+  auto packet = m_scheduler != nullptr ? m_voqs[voq]->Dequeue () : GetQueue ()->Dequeue ();
+  if (packet != nullptr)
+    {
+      metadata = (m_scheduler != nullptr ? m_voqMetadata[voq] : m_txMetadata).Pop (packet);
+    }
+
+  return packet;
 }
 
 void
-Sat2GroundNetDevice::TransmitStart ()
+Sat2GroundNetDevice::ScheduleTransmissions ()
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT_MSG (m_txMachineState == BUSY,
-                 "Must be BUSY to transmit. Tx state is: " << m_txMachineState);
 
-  auto packet = GetQueue ()->Dequeue ();
-  m_snifferTrace (packet);
+  std::size_t carrier = 0;
+  while (carrier < m_carriers.size () && HasQueuedPackets ())
+    {
+      if (m_carriers[carrier] != IDLE)
+        {
+          carrier++;
+          continue;
+        }
+
+      // The queue may drop the packet on its way out. Then try again with the same carrier.
+      TxMetadata metadata;
+      const auto packet = DequeueNext (metadata);
+      if (packet != nullptr)
+        {
+          m_carriers[carrier] = BUSY;
+          TransmitStart (packet, metadata, carrier);
+          carrier++;
+        }
+    }
+}
 
-  SatGroundTag tag;
-  packet->PeekPacketTag (tag);
-  const auto proto = tag.GetProto ();
-  const auto power = tag.GetPower ();
+void
+Sat2GroundNetDevice::TransmitStart (const Ptr<Packet> &packet, const TxMetadata &metadata,
+                                    std::size_t carrier)
+{
+  NS_LOG_FUNCTION (this << packet << carrier);
+  NS_ASSERT_MSG (m_carriers[carrier] == BUSY,
+                 "Must be BUSY to transmit. Tx state is: " << m_carriers[carrier]);
+
+  m_snifferTrace (packet);
 
   m_phyTxBeginTrace (packet);
   GetInternalChannel ()->Transmit2Ground (packet, GetDataRate (), GetObject<Sat2GroundNetDevice> (),
-                                          proto, power);
+                                          metadata.protocolNumber, metadata.power);
   Simulator::Schedule (GetDataRate ().CalculateBytesTxTime (packet->GetSize ()),
-                       &Sat2GroundNetDevice::TransmitComplete, this, packet);
+                       &Sat2GroundNetDevice::TransmitComplete, this, packet, carrier);
 }
 
 void
-Sat2GroundNetDevice::TransmitComplete (const Ptr<Packet> &packet)
+Sat2GroundNetDevice::TransmitComplete (const Ptr<Packet> &packet, std::size_t carrier)
 {
-  NS_LOG_FUNCTION (this << packet);
+  NS_LOG_FUNCTION (this << packet << carrier);
 
   m_phyTxEndTrace (packet);
 
-  SatGroundTag tag;
-  packet->RemovePacketTag (tag);
-
-  if (GetQueue ()->IsEmpty ())
-    {
-      m_txMachineState = IDLE;
-    }
-  else
-    {
-      TransmitStart ();
-    }
+  m_carriers[carrier] = IDLE;
+  ScheduleTransmissions ();
 }
 
 bool
@@ -30,6 +30,11 @@
 #include "icarus-net-device.h"
 #include "ns3/sat-address.h"
 #include "ns3/mac-model.h"
+#include "ns3/downlink-scheduler.h"
+
+#include <map>
+#include <string>
+#include <vector>
 
 namespace ns3 {
 namespace icarus {
@@ -72,15 +77,52 @@ public:
 
   virtual bool SupportsSendFrom (void) const override;
 
+  void SetNCarriers (uint32_t nCarriers);
+  uint32_t GetNCarriers () const;
+
+  // Name of the TypeId of the scheduler of this device, or empty to use TxQueue alone
+  void SetScheduler (const std::string &type);
+  std::string GetScheduler () const;
+
+  // Bytes waiting for transmission, in TxQueue or in the per destination queues
+  uint32_t GetQueuedBytes () const;
+
+protected:
+  virtual void DoInitialize (void) override;
+
 private:
   SatAddress m_address;
   Ptr<MacModel> m_macModel;
-  enum { IDLE, BUSY } m_txMachineState = IDLE;
+  enum TxState { IDLE, BUSY };
+  // State machine of every parallel downlink transmitter
+  std::vector<TxState> m_carriers{IDLE};
 
   void ReceiveFromGroundFinish (const Ptr<Packet> &packet, const Address &src,
                                 uint16_t protocolNumber);
-  void TransmitStart ();
-  void TransmitComplete (const Ptr<Packet> &packet);
+  struct TxMetadata
+  {
+    uint16_t protocolNumber;
+    double power;
+  };
+  // Of the packets in TxQueue
+  TxMetadataQueue<TxMetadata> m_txMetadata;
+
+  // Per destination queues, only used with a Scheduler
+  Ptr<DownlinkScheduler> m_scheduler;
+  std::vector<Ptr<Queue<Packet>>> m_voqs;
+  std::vector<TxMetadataQueue<TxMetadata>> m_voqMetadata;
+  std::map<Address, std::size_t> m_voqIndex;
+
+  // Index of the queue of dest, created like TxQueue on first use
+  std::size_t GetVirtualQueue (const Address &dest);
+  bool HasQueuedPackets () const;
+  Ptr<Packet> DequeueNext (TxMetadata &metadata);
+
+  // Hand queued packets to the free carriers
+  void ScheduleTransmissions ();
+  void TransmitStart (const Ptr<Packet> &packet, const TxMetadata &metadata,
+                      std::size_t carrier);
+  void TransmitComplete (const Ptr<Packet> &packet, std::size_t carrier);
 };
 
 } // namespace icarus
@@ -31,17 +31,26 @@
 #include "ns3/abort.h"
 #include "ns3/mobility-model.h"
 #include "ns3/net-device.h"
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
 #include "ns3/ptr.h"
 #include "ns3/simulator.h"
 #include "sat-net-device.h"
 #include "ns3/assert.h"
 #include "ns3/propagation-delay-model.h"
+#include "orbit/isl-geometry.h"
+
+#include <algorithm>
 
 namespace ns3 {
 namespace icarus {
 NS_LOG_COMPONENT_DEFINE ("icarus.Sat2SatChannel");
 
+namespace {
+// Time after a predicted crossing at which the new link state is evaluated, in seconds
+constexpr double CROSSING_GUARD = 1e-6;
+} // namespace
+
 NS_OBJECT_ENSURE_REGISTERED (Sat2SatChannel);
 
 TypeId
@@ -60,6 +69,20 @@ Sat2SatChannel::GetTypeId (void)
           .AddAttribute ("PropDelayModel", "Object used to calculate the propagation delay",
                          PointerValue (), MakePointerAccessor (&Sat2SatChannel::m_propDelayModel),
                          MakePointerChecker<PropagationDelayModel> ())
+          .AddAttribute ("CutThrough",
+                         "Deliver every frame in a single event at the end of its reception, "
+                         "instead of one at its start and another one at its end. The PhyRxBegin "
+                         "and PhyRxEnd traces of the receiver are fired back to back.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&Sat2SatChannel::m_cutThrough),
+                         MakeBooleanChecker ())
+          .AddAttribute ("PredictLinkState",
+                         "Compute in advance when the satellites get in and out of range and "
+                         "notify the devices of the link changes, instead of checking the "
+                         "distance for every packet. Only for the default TxSuccess model.",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&Sat2SatChannel::m_predictLinkState),
+                         MakeBooleanChecker ())
           .AddTraceSource ("PhyTxDrop",
                            "Trace source indicating a packet has been "
                            "completely received by the device",
@@ -69,7 +92,15 @@ Sat2SatChannel::GetTypeId (void)
   return tid;
 }
 
-Sat2SatChannel::Sat2SatChannel () : Channel (), m_nSatellites (0)
+Sat2SatChannel::Sat2SatChannel ()
+    : Channel (),
+      m_nSatellites (0),
+      m_cutThrough (false),
+      m_predictLinkState (false),
+      m_linkUp (true),
+      m_scale (1.0),
+      m_maxDistance (0.0),
+      m_propSpeed (0.0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -79,6 +110,17 @@ Sat2SatChannel::~Sat2SatChannel ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+void
+Sat2SatChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_linkEvent);
+  m_geometry.reset ();
+
+  Channel::DoDispose ();
+}
+
 bool
 Sat2SatChannel::AttachNewSat (const Ptr<SatNetDevice> &device)
 {
@@ -101,6 +143,11 @@ Sat2SatChannel::AttachNewSat (const Ptr<SatNetDevice> &device)
       m_link[1].m_state = IDLE;
       m_txSuccessModel->CalcMaxDistance (
           m_link[0].m_dst->GetNode ()->GetObject<CircularOrbitMobilityModel> ()->getRadius ());
+
+      if (m_predictLinkState)
+        {
+          Simulator::ScheduleNow (&Sat2SatChannel::StartLinkPrediction, this);
+        }
     }
 
   return true;
@@ -119,6 +166,28 @@ Sat2SatChannel::TransmitStart (const Ptr<Packet> &packet, const Ptr<SatNetDevice
   auto dst = m_link[wire].m_dst;
 
   Time endTx = bps.CalculateBytesTxTime (packet->GetSize ());
+
+  if (m_geometry != nullptr)
+    {
+      if (!m_linkUp)
+        {
+          NS_LOG_ERROR ("DROP PACKET, LINK DOWN");
+          m_phyTxDropTrace (packet);
+          return endTx;
+        }
+
+      // The link is up, so there is no need to check the positions
+      const Time delay =
+          m_propSpeed > 0.0
+              ? Seconds (m_scale * m_geometry->getDistance (Simulator::Now ().GetSeconds ()) /
+                         m_propSpeed)
+              : m_propDelayModel->GetDelay (src->GetNode ()->GetObject<MobilityModel> (),
+                                            dst->GetNode ()->GetObject<MobilityModel> ());
+      ScheduleReceive (dst, delay, packet, bps, protocolNumber);
+
+      return endTx;
+    }
+
   const auto posSrc = src->GetNode ()->GetObject<MobilityModel> ();
   const auto posDst = dst->GetNode ()->GetObject<MobilityModel> ();
 
@@ -130,13 +199,96 @@ Sat2SatChannel::TransmitStart (const Ptr<Packet> &packet, const Ptr<SatNetDevice
       NS_LOG_ERROR ("DROP PACKET, DISTANCE: " << posSrc->GetDistanceFrom (posDst));
       m_phyTxDropTrace (packet);
     }
+  else
+    {
+      ScheduleReceive (dst, delay, packet, bps, protocolNumber);
+    }
+
+  return endTx;
+}
+
+void
+Sat2SatChannel::ScheduleReceive (const Ptr<SatNetDevice> &dst, Time delay,
+                                 const Ptr<Packet> &packet, DataRate bps,
+                                 uint16_t protocolNumber) const
+{
+  NS_LOG_FUNCTION (this << dst << delay << packet << bps << protocolNumber);
+
+  if (m_cutThrough)
+    {
+      Simulator::ScheduleWithContext (dst->GetNode ()->GetId (),
+                                      delay + bps.CalculateBytesTxTime (packet->GetSize ()),
+                                      &SatNetDevice::ReceiveCutThrough, dst, packet,
+                                      protocolNumber);
+    }
   else
     {
       Simulator::ScheduleWithContext (dst->GetNode ()->GetId (), delay, &SatNetDevice::Receive, dst,
                                       packet, bps, protocolNumber);
     }
+}
 
-  return endTx;
+bool
+Sat2SatChannel::IsLinkUp () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_linkUp;
+}
+
+void
+Sat2SatChannel::StartLinkPrediction ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_txSuccessModel == nullptr)
+    {
+      // The link is always up
+      return;
+    }
+
+  const auto first = m_link[0].m_src->GetNode ()->GetObject<CircularOrbitMobilityModel> ();
+  const auto second = m_link[1].m_src->GetNode ()->GetObject<CircularOrbitMobilityModel> ();
+  auto geometry = IslGeometry::create (first->getOrbit (), second->getOrbit ());
+  if (!geometry)
+    {
+      NS_LOG_WARN ("Cannot predict the state of a link between different orbital shells");
+      return;
+    }
+
+  m_geometry.reset (new IslGeometry (*geometry));
+  m_scale = first->getPositionAt (Simulator::Now ()).GetLength () / first->getRadius ();
+  m_maxDistance = m_txSuccessModel->GetMaxDistance () / m_scale;
+  if (const auto constantSpeed = DynamicCast<ConstantSpeedPropagationDelayModel> (m_propDelayModel))
+    {
+      m_propSpeed = constantSpeed->GetSpeed ();
+    }
+
+  UpdateLinkState (Simulator::Now ().GetSeconds ());
+}
+
+void
+Sat2SatChannel::UpdateLinkState (double t)
+{
+  NS_LOG_FUNCTION (this << t);
+
+  const bool up = m_geometry->getDistance (t) <= m_maxDistance;
+  if (up != m_linkUp)
+    {
+      NS_LOG_DEBUG ("Link " << (up ? "up" : "down"));
+      m_linkUp = up;
+      m_link[0].m_src->NotifyLinkChange ();
+      m_link[1].m_src->NotifyLinkChange ();
+    }
+
+  // Intra plane links, and those always in or out of range, never change. Otherwise evaluate the
+  // state a little after the crossing, so that the distance is clearly on one side.
+  if (const auto next = m_geometry->getNextCrossing (t, m_maxDistance))
+    {
+      const auto delay = std::max (Seconds (*next + CROSSING_GUARD) - Simulator::Now (), Time ());
+      m_linkEvent = Simulator::Schedule (delay, &Sat2SatChannel::UpdateLinkState, this,
+                                         *next + CROSSING_GUARD);
+    }
 }
 
 std::size_t
@@ -30,13 +30,17 @@
 #include "ns3/net-device-container.h"
 #include "ns3/net-device.h"
 #include "ns3/data-rate.h"
+#include "ns3/event-id.h"
 #include "ns3/traced-callback.h"
 
+#include <memory>
+
 namespace ns3 {
 
 class PropagationDelayModel;
 
 namespace icarus {
+class IslGeometry;
 class SatNetDevice;
 class Sat2SatSuccessModel;
 class Sat2SatChannel : public Channel
@@ -56,16 +60,40 @@ public:
   Time TransmitStart (const Ptr<Packet> &packet, const Ptr<SatNetDevice> &src, DataRate bps,
                       uint16_t protocolNumber) const;
 
+  // Whether the satellites are within range. Always true unless PredictLinkState is enabled.
+  bool IsLinkUp () const noexcept;
+
   virtual std::size_t GetNDevices (void) const override;
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const override;
 
 private:
   static const std::size_t MAX_N_SATELLITES = 2;
 
+  virtual void DoDispose (void) override;
+
+  // Compute the link geometry once both satellites are in orbit
+  void StartLinkPrediction ();
+  // Update the link state at time t, in seconds, and schedule its next change
+  void UpdateLinkState (double t);
+  // Deliver packet to dst after the propagation delay
+  void ScheduleReceive (const Ptr<SatNetDevice> &dst, Time delay, const Ptr<Packet> &packet,
+                        DataRate bps, uint16_t protocolNumber) const;
+
   std::size_t m_nSatellites;
   Ptr<Sat2SatSuccessModel> m_txSuccessModel = nullptr;
   Ptr<PropagationDelayModel> m_propDelayModel;
 
+  bool m_cutThrough;
+  bool m_predictLinkState;
+  bool m_linkUp;
+  // Only set while the link state is being predicted
+  std::unique_ptr<IslGeometry> m_geometry;
+  // Ratio of the Earth fixed distances to the inertial ones, and the maximum inertial distance
+  double m_scale, m_maxDistance;
+  // Speed of a ConstantSpeedPropagationDelayModel, or 0 if the delay model is any other one
+  double m_propSpeed;
+  EventId m_linkEvent;
+
   TracedCallback<Ptr<const Packet>> m_phyTxDropTrace;
 
   /** \brief Wire states
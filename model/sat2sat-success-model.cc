@@ -67,7 +67,7 @@ Sat2SatSuccessModel::~Sat2SatSuccessModel ()
 
 bool
 Sat2SatSuccessModel::TramsmitSuccess (const Ptr<Node> &src, const Ptr<Node> &dst,
-                                      const Ptr<Packet> &) const
+                                      const Ptr<Packet> &packet) const
 {
   NS_LOG_FUNCTION (this << src << dst);
 
@@ -80,7 +80,15 @@ Sat2SatSuccessModel::TramsmitSuccess (const Ptr<Node> &src, const Ptr<Node> &dst
   const auto posSrc = mobilitySrc->GetPosition ();
   const auto posDst = mobilityDst->GetPosition ();
 
-  return CalculateDistance (posSrc, posDst) <= m_maxDistance;
+  return TramsmitSuccess (CalculateDistance (posSrc, posDst), packet);
+}
+
+bool
+Sat2SatSuccessModel::TramsmitSuccess (double distance, const Ptr<Packet> &) const
+{
+  NS_LOG_FUNCTION (this << distance);
+
+  return distance <= m_maxDistance;
 }
 
 void
@@ -92,5 +100,13 @@ Sat2SatSuccessModel::CalcMaxDistance (double altitude)
   m_maxDistance = 2 * sqrt ((h * h) - (r * r)); //max distance = 2*sqrt(h^2 - r^2)
 }
 
+double
+Sat2SatSuccessModel::GetMaxDistance () const noexcept
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_maxDistance;
+}
+
 } // namespace icarus
 } // namespace ns3
\ No newline at end of file
@@ -43,8 +43,11 @@ public:
 
   virtual bool TramsmitSuccess (const Ptr<Node> &srcNode, const Ptr<Node> &dstNode,
                                 const Ptr<Packet> &packet) const;
+  // Same decision when the distance between the satellites is already known
+  virtual bool TramsmitSuccess (double distance, const Ptr<Packet> &packet) const;
 
   virtual void CalcMaxDistance (double height);
+  double GetMaxDistance () const noexcept;
 
 private:
   static const double DEFAULT_MAX_DISTANCE;
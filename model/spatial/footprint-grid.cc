@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "footprint-grid.h"
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ns3 {
+namespace icarus {
+
+namespace {
+using boost::math::double_constants::half_pi;
+using boost::math::double_constants::pi;
+using boost::math::double_constants::two_pi;
+
+// Widen the cells looked up so rounding never leaves out a point right at the border of the cap
+constexpr double ANGLE_MARGIN = 1e-9;
+} // namespace
+
+FootprintGrid::FootprintGrid (double cellSize)
+    : m_nRows (static_cast<std::size_t> (std::ceil (pi / cellSize))),
+      m_nColumns (static_cast<std::size_t> (std::ceil (two_pi / cellSize))),
+      m_rowHeight (pi / m_nRows),
+      m_columnWidth (two_pi / m_nColumns)
+{
+}
+
+std::size_t
+FootprintGrid::getRow (double latitude) const noexcept
+{
+  const auto row = std::floor ((latitude + half_pi) / m_rowHeight);
+
+  return static_cast<std::size_t> (
+      std::min (std::max (row, 0.0), static_cast<double> (m_nRows - 1)));
+}
+
+long
+FootprintGrid::getColumn (double longitude) const noexcept
+{
+  // Not wrapped around, so that ranges of columns stay contiguous
+  return std::lround (std::floor ((longitude + pi) / m_columnWidth));
+}
+
+std::size_t
+FootprintGrid::wrapColumn (long column) const noexcept
+{
+  const auto nColumns = static_cast<long> (m_nColumns);
+
+  return static_cast<std::size_t> ((column % nColumns + nColumns) % nColumns);
+}
+
+void
+FootprintGrid::build (const std::vector<Vector> &points)
+{
+  std::vector<std::size_t> cells;
+  cells.reserve (points.size ());
+  std::vector<Entry> entries;
+  entries.reserve (points.size ());
+  for (std::size_t i = 0; i < points.size (); i++)
+    {
+      const auto &point = points[i];
+      const auto length = point.GetLength ();
+      const Entry entry{{length > 0 ? point.x / length : 0.0, length > 0 ? point.y / length : 0.0,
+                         length > 0 ? point.z / length : 0.0},
+                        i};
+      const auto latitude = std::asin (std::min (1.0, std::max (-1.0, entry.direction[2])));
+      const auto longitude = std::atan2 (entry.direction[1], entry.direction[0]);
+
+      cells.push_back (getRow (latitude) * m_nColumns + wrapColumn (getColumn (longitude)));
+      entries.push_back (entry);
+    }
+
+  // Counting sort by cell, which keeps the identifiers increasing within every cell
+  m_offsets.assign (m_nRows * m_nColumns + 1, 0);
+  for (const auto cell : cells)
+    {
+      m_offsets[cell + 1]++;
+    }
+  std::partial_sum (m_offsets.begin (), m_offsets.end (), m_offsets.begin ());
+
+  auto next = m_offsets;
+  m_entries.resize (entries.size ());
+  for (std::size_t i = 0; i < entries.size (); i++)
+    {
+      m_entries[next[cells[i]]++] = entries[i];
+    }
+}
+
+std::size_t
+FootprintGrid::size () const noexcept
+{
+  return m_entries.size ();
+}
+
+void
+FootprintGrid::withinAngle (const Vector &direction, double angle,
+                            std::vector<std::size_t> &result) const
+{
+  const auto length = direction.GetLength ();
+  if (length == 0.0 || angle < 0.0 || m_entries.empty ())
+    {
+      return;
+    }
+
+  const double d[3] = {direction.x / length, direction.y / length, direction.z / length};
+  const auto minCos = std::cos (std::min (angle, pi));
+  const auto margin = angle + ANGLE_MARGIN;
+
+  const auto latitude = std::asin (std::min (1.0, std::max (-1.0, d[2])));
+  const auto longitude = std::atan2 (d[1], d[0]);
+
+  // Longitude half width of the cap, unless it contains a pole
+  long firstColumn = 0, lastColumn = static_cast<long> (m_nColumns) - 1;
+  if (latitude - margin > -half_pi && latitude + margin < half_pi)
+    {
+      const auto width = std::asin (std::min (1.0, std::sin (margin) / std::cos (latitude)));
+      if (getColumn (longitude + width) - getColumn (longitude - width) + 1 <
+          static_cast<long> (m_nColumns))
+        {
+          firstColumn = getColumn (longitude - width);
+          lastColumn = getColumn (longitude + width);
+        }
+    }
+
+  const auto begin = result.size ();
+  for (auto row = getRow (latitude - margin); row <= getRow (latitude + margin); row++)
+    {
+      for (auto c = firstColumn; c <= lastColumn; c++)
+        {
+          const auto cell = row * m_nColumns + wrapColumn (c);
+
+          for (auto i = m_offsets[cell]; i < m_offsets[cell + 1]; i++)
+            {
+              const auto &entry = m_entries[i];
+              if (entry.direction[0] * d[0] + entry.direction[1] * d[1] +
+                      entry.direction[2] * d[2] >=
+                  minCos)
+                {
+                  result.push_back (entry.id);
+                }
+            }
+        }
+    }
+
+  std::sort (result.begin () + begin, result.end ());
+}
+
+} // namespace icarus
+} // namespace ns3
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef FOOTPRINT_GRID_H
+#define FOOTPRINT_GRID_H
+
+#include "ns3/vector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * Latitude and longitude grid over a static set of points around the Earth.
+ *
+ * Points are bucketed by the geocentric latitude and longitude of their direction in cells of
+ * about cellSize radians. A query for the points inside a spherical cap, such as the footprint of
+ * a satellite, only visits the cells overlapping the bounding box of the cap, and then checks the
+ * angle to every point in them.
+ */
+class FootprintGrid
+{
+public:
+  explicit FootprintGrid (double cellSize);
+
+  // Index every points[i] with identifier i
+  void build (const std::vector<Vector> &points);
+
+  std::size_t size () const noexcept;
+
+  // Append to result, in increasing order, the identifiers of the points whose direction is at
+  // most angle radians away from direction
+  void withinAngle (const Vector &direction, double angle, std::vector<std::size_t> &result) const;
+
+private:
+  struct Entry
+  {
+    double direction[3];
+    std::size_t id;
+  };
+
+  std::size_t getRow (double latitude) const noexcept;
+  long getColumn (double longitude) const noexcept;
+  std::size_t wrapColumn (long column) const noexcept;
+
+  // Cells are at most cellSize wide and tile the sphere exactly
+  std::size_t m_nRows, m_nColumns;
+  double m_rowHeight, m_columnWidth;
+  // The entries of cell row * m_nColumns + column are [m_offsets[cell], m_offsets[cell + 1])
+  std::vector<std::size_t> m_offsets;
+  std::vector<Entry> m_entries;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* FOOTPRINT_GRID_H */
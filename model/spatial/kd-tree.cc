@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "kd-tree.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3 {
+namespace icarus {
+
+namespace {
+inline double
+sqDistance (const double *a, const double *b) noexcept
+{
+  const double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+
+  return dx * dx + dy * dy + dz * dz;
+}
+} // namespace
+
+void
+KdTree::build (const std::vector<Vector> &points, const std::vector<std::size_t> &ids)
+{
+  m_nodes.clear ();
+  m_nodes.reserve (ids.size ());
+  for (const auto id : ids)
+    {
+      m_nodes.push_back ({{points[id].x, points[id].y, points[id].z}, id, 0});
+    }
+
+  build (0, m_nodes.size ());
+}
+
+void
+KdTree::build (std::size_t begin, std::size_t end)
+{
+  if (end - begin < 2)
+    {
+      return;
+    }
+
+  // Split along the axis with the widest spread
+  double low[3], high[3];
+  std::fill (low, low + 3, std::numeric_limits<double>::infinity ());
+  std::fill (high, high + 3, -std::numeric_limits<double>::infinity ());
+  for (auto i = begin; i < end; i++)
+    {
+      for (unsigned axis = 0; axis < 3; axis++)
+        {
+          low[axis] = std::min (low[axis], m_nodes[i].coordinates[axis]);
+          high[axis] = std::max (high[axis], m_nodes[i].coordinates[axis]);
+        }
+    }
+
+  unsigned axis = 0;
+  for (unsigned a = 1; a < 3; a++)
+    {
+      if (high[a] - low[a] > high[axis] - low[axis])
+        {
+          axis = a;
+        }
+    }
+
+  const auto middle = begin + (end - begin) / 2;
+  std::nth_element (m_nodes.begin () + begin, m_nodes.begin () + middle, m_nodes.begin () + end,
+                    [axis] (const Node &a, const Node &b) {
+                      return a.coordinates[axis] < b.coordinates[axis];
+                    });
+  m_nodes[middle].axis = axis;
+
+  build (begin, middle);
+  build (middle + 1, end);
+}
+
+std::size_t
+KdTree::size () const noexcept
+{
+  return m_nodes.size ();
+}
+
+bool
+KdTree::empty () const noexcept
+{
+  return m_nodes.empty ();
+}
+
+KdTree::neighbour
+KdTree::nearest (const Vector &query) const noexcept
+{
+  const double q[3] = {query.x, query.y, query.z};
+  neighbour best{std::numeric_limits<double>::infinity (), 0};
+
+  nearest (0, m_nodes.size (), q, best);
+
+  return best;
+}
+
+void
+KdTree::nearest (std::size_t begin, std::size_t end, const double *query,
+                 neighbour &best) const noexcept
+{
+  if (begin >= end)
+    {
+      return;
+    }
+
+  const auto middle = begin + (end - begin) / 2;
+  const Node &node = m_nodes[middle];
+
+  const auto distance = sqDistance (node.coordinates, query);
+  if (distance < best.first)
+    {
+      best = {distance, node.id};
+    }
+
+  const auto delta = query[node.axis] - node.coordinates[node.axis];
+  const bool left = delta < 0.0;
+
+  nearest (left ? begin : middle + 1, left ? middle : end, query, best);
+  if (delta * delta < best.first)
+    {
+      nearest (left ? middle + 1 : begin, left ? end : middle, query, best);
+    }
+}
+
+std::vector<KdTree::neighbour>
+KdTree::kNearest (const Vector &query, std::size_t k) const
+{
+  const double q[3] = {query.x, query.y, query.z};
+  std::vector<neighbour> heap;
+
+  if (k > 0)
+    {
+      heap.reserve (k);
+      kNearest (0, m_nodes.size (), q, k, heap);
+      std::sort_heap (heap.begin (), heap.end ());
+    }
+
+  return heap;
+}
+
+void
+KdTree::kNearest (std::size_t begin, std::size_t end, const double *query, std::size_t k,
+                  std::vector<neighbour> &heap) const
+{
+  if (begin >= end)
+    {
+      return;
+    }
+
+  const auto middle = begin + (end - begin) / 2;
+  const Node &node = m_nodes[middle];
+
+  // heap is a max-heap holding the best k candidates so far
+  const auto distance = sqDistance (node.coordinates, query);
+  if (heap.size () < k)
+    {
+      heap.emplace_back (distance, node.id);
+      std::push_heap (heap.begin (), heap.end ());
+    }
+  else if (distance < heap.front ().first)
+    {
+      std::pop_heap (heap.begin (), heap.end ());
+      heap.back () = {distance, node.id};
+      std::push_heap (heap.begin (), heap.end ());
+    }
+
+  const auto delta = query[node.axis] - node.coordinates[node.axis];
+  const bool left = delta < 0.0;
+
+  kNearest (left ? begin : middle + 1, left ? middle : end, query, k, heap);
+  if (heap.size () < k || delta * delta < heap.front ().first)
+    {
+      kNearest (left ? middle + 1 : begin, left ? end : middle, query, k, heap);
+    }
+}
+
+void
+KdTree::withinRadius (const Vector &query, double radius, std::vector<neighbour> &result) const
+{
+  const double q[3] = {query.x, query.y, query.z};
+
+  withinRadius (0, m_nodes.size (), q, radius * radius, result);
+}
+
+void
+KdTree::withinRadius (std::size_t begin, std::size_t end, const double *query, double sqRadius,
+                      std::vector<neighbour> &result) const
+{
+  if (begin >= end)
+    {
+      return;
+    }
+
+  const auto middle = begin + (end - begin) / 2;
+  const Node &node = m_nodes[middle];
+
+  const auto distance = sqDistance (node.coordinates, query);
+  if (distance <= sqRadius)
+    {
+      result.emplace_back (distance, node.id);
+    }
+
+  const auto delta = query[node.axis] - node.coordinates[node.axis];
+  if (delta <= 0.0 || delta * delta <= sqRadius)
+    {
+      withinRadius (begin, middle, query, sqRadius, result);
+    }
+  if (delta >= 0.0 || delta * delta <= sqRadius)
+    {
+      withinRadius (middle + 1, end, query, sqRadius, result);
+    }
+}
+
+} // namespace icarus
+} // namespace ns3
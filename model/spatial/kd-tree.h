@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include "ns3/vector.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+/**
+ * Static three dimensional kd-tree over a set of identified points.
+ *
+ * The tree is stored implicitly in a single array: the root of every range [begin, end) is its
+ * middle element, which splits it along the axis where the points of the range spread the most.
+ * Building it takes O(n log n) and nearest neighbour queries take O(log n) on average.
+ */
+class KdTree
+{
+public:
+  // Squared distance and identifier of a point
+  typedef std::pair<double, std::size_t> neighbour;
+
+  KdTree () = default;
+
+  // Index points[id] for every id in ids
+  void build (const std::vector<Vector> &points, const std::vector<std::size_t> &ids);
+
+  std::size_t size () const noexcept;
+  bool empty () const noexcept;
+
+  neighbour nearest (const Vector &query) const noexcept;
+  // The k nearest points, closest first
+  std::vector<neighbour> kNearest (const Vector &query, std::size_t k) const;
+  // Append the points closer than radius to result, in no particular order
+  void withinRadius (const Vector &query, double radius, std::vector<neighbour> &result) const;
+
+private:
+  struct Node
+  {
+    double coordinates[3];
+    std::size_t id;
+    unsigned axis;
+  };
+
+  void build (std::size_t begin, std::size_t end);
+  void nearest (std::size_t begin, std::size_t end, const double *query,
+                neighbour &best) const noexcept;
+  void kNearest (std::size_t begin, std::size_t end, const double *query, std::size_t k,
+                 std::vector<neighbour> &heap) const;
+  void withinRadius (std::size_t begin, std::size_t end, const double *query, double sqRadius,
+                     std::vector<neighbour> &result) const;
+
+  std::vector<Node> m_nodes;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* KD_TREE_H */
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+
+#include "walker-lookup.h"
+
+#include "../orbit/circular-orbit-impl.h"
+#include "../orbit/satpos/planet.h"
+
+#include <boost/math/constants/constants.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+namespace icarus {
+
+namespace {
+using boost::math::double_constants::half_pi;
+using boost::math::double_constants::pi;
+using boost::math::double_constants::two_pi;
+
+constexpr double ANGLE_TOLERANCE = 1e-9;
+
+bool
+sameAngle (double a, double b) noexcept
+{
+  return std::abs (std::remainder (a - b, two_pi)) < ANGLE_TOLERANCE;
+}
+} // namespace
+
+boost::optional<WalkerLookup>
+WalkerLookup::detect (const std::vector<const CircularOrbitMobilityModelImpl *> &orbits,
+                      std::size_t nPlanes, std::size_t planeSize)
+{
+  if (nPlanes == 0 || planeSize == 0 || orbits.size () != nPlanes * planeSize)
+    {
+      return {};
+    }
+  for (const auto orbit : orbits)
+    {
+      if (orbit == nullptr)
+        {
+          return {};
+        }
+    }
+
+  const auto &first = *orbits.front ();
+  const double firstPhase = first.getPhase ().value ();
+  const double planeOffset =
+      nPlanes > 1 ? std::remainder (orbits[planeSize]->getPhase ().value () - firstPhase, two_pi)
+                  : 0.0;
+
+  for (std::size_t plane = 0; plane < nPlanes; plane++)
+    {
+      for (std::size_t index = 0; index < planeSize; index++)
+        {
+          const auto &orbit = *orbits[plane * planeSize + index];
+
+          if (std::abs (orbit.getRadius ().value () - first.getRadius ().value ()) >
+                  first.getRadius ().value () * 4 * std::numeric_limits<double>::epsilon () ||
+              !sameAngle (orbit.getInclination ().value (), first.getInclination ().value ()) ||
+              !sameAngle (orbit.getAscendingNode ().value (),
+                          first.getAscendingNode ().value () + plane * two_pi / nPlanes) ||
+              !sameAngle (orbit.getPhase ().value (),
+                          firstPhase + plane * planeOffset + index * two_pi / planeSize))
+            {
+              return {};
+            }
+        }
+    }
+
+  return WalkerLookup (nPlanes, planeSize, first.getInclination ().value (),
+                       first.getAscendingNode ().value (), first.getMeanMotion ().value (),
+                       firstPhase, planeOffset);
+}
+
+WalkerLookup::WalkerLookup (std::size_t nPlanes, std::size_t planeSize, double inclination,
+                            double firstNode, double meanMotion, double firstPhase,
+                            double planeOffset) noexcept
+    : m_nPlanes (nPlanes),
+      m_planeSize (planeSize),
+      m_cosInclination (std::cos (inclination)),
+      m_sinInclination (std::sin (inclination)),
+      m_firstNode (firstNode),
+      m_nodeStep (two_pi / nPlanes),
+      m_meanMotion (meanMotion),
+      m_firstPhase (firstPhase),
+      m_phaseStep (two_pi / planeSize),
+      m_planeOffset (planeOffset)
+{
+}
+
+std::size_t
+WalkerLookup::closest (const Vector &position, double t) const noexcept
+{
+  using ::icarus::satpos::planet::constants::Earth;
+
+  // Observer direction in the inertial frame of the orbits
+  const double theta = Earth.getRotationRate ().value () * t;
+  const double cos_theta = std::cos (theta), sin_theta = std::sin (theta);
+  const double length = position.GetLength ();
+  const double o[3] = {(cos_theta * position.x - sin_theta * position.y) / length,
+                       (sin_theta * position.x + cos_theta * position.y) / length,
+                       position.z / length};
+
+  // Ascending nodes of the planes containing o, or the one closest to it. With the normal of the
+  // plane h = (sin i sin Ω, -sin i cos Ω, cos i), h · o = sin i ρ sin (Ω - λ) + cos i o_z.
+  const double rho = std::hypot (o[0], o[1]);
+  const double lambda = std::atan2 (o[1], o[0]);
+  double seeds[2];
+  std::size_t nSeeds = 1;
+
+  if (m_sinInclination * rho > ANGLE_TOLERANCE)
+    {
+      const double a = -m_cosInclination * o[2] / (m_sinInclination * rho);
+      if (std::abs (a) <= 1.0)
+        {
+          seeds[0] = lambda + std::asin (a);
+          seeds[1] = lambda + pi - std::asin (a);
+          nSeeds = 2;
+        }
+      else
+        {
+          seeds[0] = lambda + (a > 0.0 ? half_pi : -half_pi);
+        }
+    }
+  else
+    {
+      // Every plane is equally good
+      seeds[0] = m_firstNode;
+    }
+
+  const double phase = m_meanMotion * t + m_firstPhase;
+  double best = -std::numeric_limits<double>::infinity ();
+  std::size_t bestSlot = 0;
+
+  for (std::size_t i = 0; i < nSeeds; i++)
+    {
+      // The planes on both sides of the seed. Moving away from it the bound only decreases until
+      // the next seed, so stop as soon as it cannot beat the best candidate.
+      const double x = std::floor (std::remainder (seeds[i] - m_firstNode, two_pi) / m_nodeStep);
+      const auto below = static_cast<std::size_t> (
+          (static_cast<long> (x) % static_cast<long> (m_nPlanes) + m_nPlanes) % m_nPlanes);
+
+      visit (below, -1, o, phase, best, bestSlot);
+      visit ((below + 1) % m_nPlanes, 1, o, phase, best, bestSlot);
+    }
+
+  return bestSlot;
+}
+
+void
+WalkerLookup::visit (std::size_t plane, int direction, const double *o, double phase,
+                     double &best, std::size_t &bestSlot) const noexcept
+{
+  for (std::size_t step = 0; step < m_nPlanes; step++)
+    {
+      const double node = m_firstNode + plane * m_nodeStep;
+      const double cos_node = std::cos (node), sin_node = std::sin (node);
+
+      // Projections of o on the in-plane unit vectors P and Q
+      const double po = cos_node * o[0] + sin_node * o[1];
+      const double qo =
+          m_cosInclination * (cos_node * o[1] - sin_node * o[0]) + m_sinInclination * o[2];
+
+      if (std::hypot (po, qo) <= best)
+        {
+          return;
+        }
+
+      // Satellite of the plane nearest in phase to the projection of o
+      const double base = phase + plane * m_planeOffset;
+      const long index = std::lround (std::remainder (std::atan2 (qo, po) - base, two_pi) /
+                                      m_phaseStep);
+      const double e = base + index * m_phaseStep;
+      const double value = po * std::cos (e) + qo * std::sin (e);
+
+      if (value > best)
+        {
+          best = value;
+          bestSlot = plane * m_planeSize +
+                     (index % static_cast<long> (m_planeSize) + m_planeSize) % m_planeSize;
+        }
+
+      plane = (plane + m_nPlanes + direction) % m_nPlanes;
+    }
+}
+
+} // namespace icarus
+} // namespace ns3
@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Universidade de Vigo
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Miguel Rodríguez Pérez <miguel@det.uvigo.gal>
+ */
+#ifndef WALKER_LOOKUP_H
+#define WALKER_LOOKUP_H
+
+#include "ns3/vector.h"
+
+#include <boost/optional/optional.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+namespace icarus {
+
+class CircularOrbitMobilityModelImpl;
+
+/**
+ * Closest satellite lookup for Walker delta constellations.
+ *
+ * In a Walker delta constellation every orbit shares the radius and the inclination, the
+ * ascending nodes are evenly spread over 360º, the satellites are evenly spread within their
+ * plane and each plane is shifted by a fixed phase offset from the previous one. As all the
+ * satellites lie on the same sphere, the closest one to an observer is the one whose direction
+ * has the largest projection on the observer direction o.
+ *
+ * In a plane with normal h that projection is at most K = sqrt (1 - (h · o)²), and the best
+ * satellite of the plane is the one whose phase is nearest to that of the projection of o, which
+ * is found with a division. h · o is a sinusoid in the ascending node, so the planes where K is
+ * largest surround its roots. The lookup starts from those planes and moves away from them until K
+ * falls below the best candidate found, visiting only a handful of planes for any realistic
+ * constellation.
+ */
+class WalkerLookup
+{
+public:
+  // Returns the lookup if the orbits, flat indexed by plane * planeSize + index, form a Walker
+  // delta constellation.
+  static boost::optional<WalkerLookup>
+  detect (const std::vector<const CircularOrbitMobilityModelImpl *> &orbits, std::size_t nPlanes,
+          std::size_t planeSize);
+
+  // Slot of the satellite closest to an Earth fixed position at time t, in seconds
+  std::size_t closest (const Vector &position, double t) const noexcept;
+
+private:
+  WalkerLookup (std::size_t nPlanes, std::size_t planeSize, double inclination, double firstNode,
+                double meanMotion, double firstPhase, double planeOffset) noexcept;
+
+  // Expand from plane towards direction while the plane bound beats the best candidate
+  void visit (std::size_t plane, int direction, const double *o, double phase,
+              double &best, std::size_t &bestSlot) const noexcept;
+
+  std::size_t m_nPlanes, m_planeSize;
+  double m_cosInclination, m_sinInclination;
+  double m_firstNode, m_nodeStep;
+  double m_meanMotion, m_firstPhase, m_phaseStep, m_planeOffset;
+};
+
+} // namespace icarus
+} // namespace ns3
+
+#endif /* WALKER_LOOKUP_H */
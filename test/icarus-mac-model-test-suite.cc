@@ -41,7 +41,9 @@
 #include <boost/units/systems/angle/degrees.hpp>
 #include <boost/units/systems/si/prefixes.hpp>
 #include <boost/math/constants/constants.hpp>
+#include <algorithm>
 #include <ios>
+#include <map>
 
 using namespace ns3;
 using namespace icarus;
@@ -443,6 +445,369 @@ CrdsaAloha::DoRun ()
   Simulator::Destroy ();
 }
 
+// Receptions of packets, each one made of several copies, at a single MAC model
+class MacReceptionTest : public TestCase
+{
+protected:
+  explicit MacReceptionTest (const std::string &name) : TestCase (name)
+  {
+  }
+
+  struct Copy
+  {
+    Time start;
+    Time txTime;
+    double rxPower;
+  };
+
+  // Times every packet was received, and when it was for the first time
+  std::vector<unsigned> m_receptions;
+  std::vector<Time> m_firstReception;
+
+  // Copies of every packet that start at the beginning of the given slots of 1 ms
+  static std::vector<std::vector<Copy>>
+  InSlots (const std::vector<std::vector<unsigned>> &slots, Time txTime)
+  {
+    std::vector<std::vector<Copy>> packets (slots.size ());
+    for (std::size_t i = 0; i < slots.size (); i++)
+      {
+        for (const auto slot : slots[i])
+          {
+            packets[i].push_back ({MilliSeconds (slot), txTime, 0.0});
+          }
+      }
+
+    return packets;
+  }
+
+  // Start the reception of every copy of every packet at mac and run the simulation
+  void
+  Receive (const Ptr<MacModel> &mac, const std::vector<std::vector<Copy>> &packets)
+  {
+    m_receptions.assign (packets.size (), 0);
+    m_firstReception.assign (packets.size (), Time ());
+
+    for (std::size_t i = 0; i < packets.size (); i++)
+      {
+        const auto packet = Create<Packet> (100);
+        const MacModel::rxPacketCallback received = [this, i] () {
+          if (m_receptions[i]++ == 0)
+            {
+              m_firstReception[i] = Simulator::Now ();
+            }
+        };
+        for (const auto &copy : packets[i])
+          {
+            Simulator::Schedule (copy.start, &MacModel::StartPacketRx, mac, packet, copy.txTime,
+                                 copy.rxPower, received);
+          }
+      }
+
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+  void
+  CheckReceptions (const std::vector<unsigned> &expected, const std::string &message)
+  {
+    NS_TEST_EXPECT_MSG_EQ ((m_receptions == expected), true, message);
+  }
+};
+
+class CrdsaSicTest : public MacReceptionTest
+{
+public:
+  CrdsaSicTest (bool slotSynchronous)
+      : MacReceptionTest (slotSynchronous
+                              ? "Check the interference cancellation of slot synchronous CRDSA"
+                              : "Check the interference cancellation of CRDSA"),
+        m_slotSynchronous (slotSynchronous)
+  {
+  }
+  virtual ~CrdsaSicTest () = default;
+
+private:
+  const bool m_slotSynchronous;
+
+  virtual void
+  DoRun (void)
+  {
+    const auto mac = CreateObject<CrdsaMacModel> ();
+    mac->SetAttribute ("SlotDuration", TimeValue (MilliSeconds (1)));
+    mac->SetAttribute ("SlotsPerFrame", UintegerValue (10));
+    mac->SetAttribute ("SlotSynchronous", BooleanValue (m_slotSynchronous));
+
+    // Replica slots of every packet. a is received in slot 0, which uncovers b in slot 2 and
+    // then c in slot 1. d and e always collide. Leave a guard time between slots.
+    Receive (mac, InSlots ({{0, 2}, {1, 2}, {1, 3}, {4, 5}, {4, 5}}, MicroSeconds (900)));
+
+    CheckReceptions ({1, 1, 1, 0, 0}, "Every recoverable packet must be received exactly once");
+    // Slot synchronous receptions are resolved at the end of the slot, not of the transmission
+    const auto recovery = m_slotSynchronous ? MilliSeconds (3) : MicroSeconds (2900);
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[1], recovery,
+                           "The second packet must be recovered at the end of slot 2");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[2], recovery,
+                           "The third packet must be recovered right after the second one");
+  }
+};
+
+class AlohaSlotAlignmentTest : public MacReceptionTest
+{
+public:
+  AlohaSlotAlignmentTest ()
+      : MacReceptionTest ("Check slot synchronous ALOHA with receptions not aligned to the slots")
+  {
+  }
+  virtual ~AlohaSlotAlignmentTest () = default;
+
+private:
+  virtual void
+  DoRun (void)
+  {
+    const auto mac = CreateObject<AlohaMacModel> ();
+    mac->SetAttribute ("SlotDuration", TimeValue (MilliSeconds (1)));
+    mac->SetAttribute ("SlotSynchronous", BooleanValue (true));
+    mac->Initialize ();
+
+    // a is aligned to slot 0, while b arrives half a slot late and ends in slot 2. c and d start
+    // in slot 3, so they collide even if d arrives late too.
+    Receive (mac, {{{MicroSeconds (0), MicroSeconds (900), 0.0}},
+                   {{MicroSeconds (1500), MicroSeconds (900), 0.0}},
+                   {{MicroSeconds (3000), MicroSeconds (900), 0.0}},
+                   {{MicroSeconds (3400), MicroSeconds (900), 0.0}}});
+
+    CheckReceptions ({1, 1, 0, 0}, "Only the packets alone in their slots must be received");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[0], MilliSeconds (1),
+                           "An aligned packet must be received at the end of its slot");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[1], MicroSeconds (2400),
+                           "A late packet must not be received before it has fully arrived");
+  }
+};
+
+class IrsaDegreeTest : public TestCase
+{
+public:
+  IrsaDegreeTest () : TestCase ("Check the degree distribution and frame size of IRSA")
+  {
+  }
+  virtual ~IrsaDegreeTest () = default;
+
+private:
+  virtual void
+  DoRun (void)
+  {
+    const auto mac = CreateObject<IrsaMacModel> ();
+    mac->SetAttribute ("SlotDuration", TimeValue (MilliSeconds (1)));
+    mac->Initialize ();
+    NS_TEST_ASSERT_MSG_EQ (mac->GetSlotsPerFrame (), 8u,
+                           "The default frame must fit the largest degree");
+
+    // A packet per frame, so their transmissions never overlap
+    const auto nPackets = 1000u;
+    std::vector<unsigned> degrees (nPackets, 0);
+    std::vector<unsigned> completions (nPackets, 0);
+    for (auto i = 0u; i < nPackets; i++)
+      {
+        const MacModel::txPacketCallback transmit = [&degrees, i] () {
+          degrees[i]++;
+          return MicroSeconds (900);
+        };
+        const MacModel::rxPacketCallback finish = [&completions, i] () { completions[i]++; };
+        Simulator::Schedule (MilliSeconds (8 * i) + MicroSeconds (500), &IrsaMacModel::Send, mac,
+                             Create<Packet> (100), transmit, finish);
+      }
+
+    Simulator::Run ();
+    Simulator::Destroy ();
+
+    // 0.5 x² + 0.28 x³ + 0.22 x⁸
+    std::map<unsigned, double> frequencies;
+    for (auto i = 0u; i < nPackets; i++)
+      {
+        frequencies[degrees[i]] += 1.0 / nPackets;
+        NS_TEST_EXPECT_MSG_EQ (completions[i], 1u, "The device must be notified just once");
+      }
+    NS_TEST_ASSERT_MSG_EQ (frequencies.size (), 3u, "Only degrees 2, 3 and 8 can be drawn");
+    NS_TEST_EXPECT_MSG_EQ_TOL (frequencies[2], 0.5, 0.05, "Wrong frequency of degree 2");
+    NS_TEST_EXPECT_MSG_EQ_TOL (frequencies[3], 0.28, 0.05, "Wrong frequency of degree 3");
+    NS_TEST_EXPECT_MSG_EQ_TOL (frequencies[8], 0.22, 0.05, "Wrong frequency of degree 8");
+  }
+};
+
+class IrsaDecodingTest : public MacReceptionTest
+{
+public:
+  IrsaDecodingTest ()
+      : MacReceptionTest ("Check the interference cancellation of IRSA with irregular degrees")
+  {
+  }
+  virtual ~IrsaDecodingTest () = default;
+
+private:
+  virtual void
+  DoRun (void)
+  {
+    const auto mac = CreateObject<IrsaMacModel> ();
+    mac->SetAttribute ("SlotDuration", TimeValue (MilliSeconds (1)));
+    mac->SetAttribute ("SlotsPerFrame", UintegerValue (12));
+    mac->SetAttribute ("SlotSynchronous", BooleanValue (true));
+    mac->Initialize ();
+
+    // Replica slots of every packet. a has degree 8 and collides in all of them. c is alone in
+    // slot 8, and cancelling it uncovers a in slots 2 and 3. Cancelling a then uncovers b, d and
+    // e. f and g always collide.
+    Receive (mac, InSlots ({{0, 1, 2, 3, 4, 5, 6, 7},
+                            {0, 1},
+                            {2, 3, 8},
+                            {4, 5},
+                            {6, 7, 9},
+                            {10, 11},
+                            {10, 11}},
+                           MicroSeconds (900)));
+
+    CheckReceptions ({1, 1, 1, 1, 1, 0, 0},
+                     "Every recoverable packet must be received exactly once");
+    for (auto i = 0u; i < 5; i++)
+      {
+        NS_TEST_EXPECT_MSG_EQ (m_firstReception[i], MilliSeconds (9),
+                               "Every packet must be recovered at the end of slot 8");
+      }
+  }
+};
+
+class CsaDecodingTest : public MacReceptionTest
+{
+public:
+  CsaDecodingTest () : MacReceptionTest ("Check that CSA needs two segments to recover a packet")
+  {
+  }
+  virtual ~CsaDecodingTest () = default;
+
+private:
+  virtual void
+  DoRun (void)
+  {
+    const auto mac = CreateObject<CsaMacModel> ();
+    mac->SetAttribute ("SlotDuration", TimeValue (MilliSeconds (1)));
+    mac->SetAttribute ("SlotsPerFrame", UintegerValue (10));
+    mac->SetAttribute ("SegmentsPerPacket", UintegerValue (2));
+
+    // Segment slots of every packet. a is recovered in slot 1. Cancelling it from slot 2 gives b
+    // a segment, and its second one comes in slot 4. That uncovers c in slot 3, completed in slot
+    // 5. d and e always collide, and f only has a single segment. Every segment lasts half the
+    // packet transmission time.
+    Receive (mac, InSlots ({{0, 1, 2}, {2, 3, 4}, {3, 5}, {6, 7}, {6, 7}, {8}},
+                           MicroSeconds (1800)));
+
+    CheckReceptions ({1, 1, 1, 0, 0, 0},
+                     "Every recoverable packet must be received exactly once");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[0], MilliSeconds (2),
+                           "The first packet must be recovered at the end of slot 1");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[1], MilliSeconds (5),
+                           "The second packet must be recovered at the end of slot 4");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[2], MilliSeconds (6),
+                           "The third packet must be recovered at the end of slot 5");
+  }
+};
+
+class CsaTransmitTest : public TestCase
+{
+public:
+  CsaTransmitTest () : TestCase ("Check the segment airtime and completion of CSA transmissions")
+  {
+  }
+  virtual ~CsaTransmitTest () = default;
+
+private:
+  virtual void
+  DoRun (void)
+  {
+    const auto mac = CreateObject<CsaMacModel> ();
+    mac->SetAttribute ("SlotDuration", TimeValue (MilliSeconds (1)));
+    mac->SetAttribute ("SlotsPerFrame", UintegerValue (10));
+    mac->SetAttribute ("SegmentsPerPacket", UintegerValue (2));
+    mac->Initialize ();
+
+    std::vector<Time> transmissions, completions;
+    const MacModel::txPacketCallback transmit = [&transmissions] () {
+      transmissions.push_back (Simulator::Now ());
+      return MicroSeconds (1800);
+    };
+    const MacModel::rxPacketCallback finish = [&completions] () {
+      completions.push_back (Simulator::Now ());
+    };
+    Simulator::Schedule (MicroSeconds (500), &CsaMacModel::Send, mac, Create<Packet> (100),
+                         transmit, finish);
+
+    Simulator::Run ();
+    Simulator::Destroy ();
+
+    // 2k coded segments in different slots of the next frame
+    std::sort (transmissions.begin (), transmissions.end ());
+    NS_TEST_ASSERT_MSG_EQ (transmissions.size (), 4u, "Every coded segment must be sent");
+    for (std::size_t i = 0; i < transmissions.size (); i++)
+      {
+        NS_TEST_ASSERT_MSG_EQ ((transmissions[i] >= MilliSeconds (10) &&
+                                transmissions[i] < MilliSeconds (20)),
+                               true, "Segments must be sent in the next frame");
+        NS_TEST_ASSERT_MSG_EQ ((i == 0 || transmissions[i] > transmissions[i - 1]), true,
+                               "Segments must be sent in different slots");
+      }
+    NS_TEST_ASSERT_MSG_EQ (completions.size (), 1u, "The device must be notified just once");
+    NS_TEST_ASSERT_MSG_EQ (completions.front (), transmissions.back () + MicroSeconds (900),
+                           "Segments must last half the packet transmission time");
+  }
+};
+
+class EssaSicTest : public MacReceptionTest
+{
+public:
+  EssaSicTest () : MacReceptionTest ("Check the sliding window interference cancellation of E-SSA")
+  {
+  }
+  virtual ~EssaSicTest () = default;
+
+private:
+  virtual void
+  DoRun (void)
+  {
+    const auto mac = CreateObject<EssaMacModel> ();
+    mac->SetAttribute ("WindowDuration", TimeValue (MilliSeconds (3)));
+    mac->SetAttribute ("WindowStep", TimeValue (MilliSeconds (1)));
+    mac->SetAttribute ("SpreadingFactor", UintegerValue (1));
+    mac->SetAttribute ("SinrThreshold", DoubleValue (3.0));
+
+    // a is decoded over b, which is then recovered once a is cancelled. c and d overlap too much
+    // to be decoded, while e and f overlap little enough.
+    Receive (mac, {{{MicroSeconds (0), MilliSeconds (1), 10.0}},
+                   {{MicroSeconds (500), MilliSeconds (1), 0.0}},
+                   {{MicroSeconds (5000), MilliSeconds (1), 0.0}},
+                   {{MicroSeconds (5200), MilliSeconds (1), 0.0}},
+                   {{MicroSeconds (10000), MilliSeconds (1), 0.0}},
+                   {{MicroSeconds (10700), MilliSeconds (1), 0.0}}});
+
+    CheckReceptions ({1, 1, 0, 0, 1, 1}, "Every decodable packet must be received exactly once");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[0], MilliSeconds (1),
+                           "The strong packet must be decoded in the first window step");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[1], MilliSeconds (2),
+                           "The weak packet must be decoded in the step after it ends");
+    NS_TEST_ASSERT_MSG_EQ (m_firstReception[5], MilliSeconds (12),
+                           "The last packet must be decoded in the step after it ends");
+
+    // A window sized for the longest packet takes a short packet first and then one more than
+    // twice as long
+    const auto mixed = CreateObject<EssaMacModel> ();
+    mixed->SetAttribute ("MaxTxTime", TimeValue (MilliSeconds (2)));
+    mixed->SetAttribute ("SpreadingFactor", UintegerValue (1));
+    mixed->SetAttribute ("SinrThreshold", DoubleValue (3.0));
+
+    Receive (mixed, {{{MilliSeconds (0), MicroSeconds (500), 0.0}},
+                     {{MilliSeconds (5), MilliSeconds (2), 0.0}}});
+
+    CheckReceptions ({1, 1}, "Packets of any size up to MaxTxTime must be received");
+  }
+};
+
 class IcarusMacModelTestSuite : public TestSuite
 {
 public:
@@ -457,6 +822,14 @@ IcarusMacModelTestSuite::IcarusMacModelTestSuite () : TestSuite ("icarus.mac-mod
       AddTestCase (new SlottedAloha (g), TestCase::EXTENSIVE);
     }
   AddTestCase (new CrdsaAloha, TestCase::EXTENSIVE);
+  AddTestCase (new CrdsaSicTest (false), TestCase::QUICK);
+  AddTestCase (new CrdsaSicTest (true), TestCase::QUICK);
+  AddTestCase (new AlohaSlotAlignmentTest, TestCase::QUICK);
+  AddTestCase (new IrsaDegreeTest, TestCase::QUICK);
+  AddTestCase (new IrsaDecodingTest, TestCase::QUICK);
+  AddTestCase (new CsaDecodingTest, TestCase::QUICK);
+  AddTestCase (new CsaTransmitTest, TestCase::QUICK);
+  AddTestCase (new EssaSicTest, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
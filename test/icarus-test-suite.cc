@@ -20,16 +20,41 @@
 
 // Include a header file from your module to test.
 #include "ns3/circular-orbit.h"
+#include "model/orbit/circular-orbit-impl.h"
+#include "model/orbit/ground-geometry.h"
+#include "model/orbit/isl-geometry.h"
+#include "model/orbit/search/distancesolver.h"
 #include "model/orbit/satpos/planet.h"
+#include "model/spatial/footprint-grid.h"
+#include "model/ndn-block-header.hpp"
+#include "model/ndn-l3-protocol.hpp"
 
 // An essential include is test.h
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/contact-plan.h"
+#include "ns3/double.h"
+#include "ns3/downlink-scheduler-drr.h"
+#include "ns3/downlink-scheduler-round-robin.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/uinteger.h"
 #include "ns3/geographic-positions.h"
+#include "ns3/ground-sat-channel.h"
+#include "ns3/ground-sat-success-distance.h"
+#include "ns3/ground-sta-net-device.h"
+#include "ns3/ground-node-sat-tracker.h"
+#include "ns3/handover-scheduler.h"
 #include "ns3/icarus-helper.h"
 #include "ns3/mobility-model.h"
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+#include "ns3/ndnSIM/NFD/daemon/face/generic-link-service.hpp"
 #include "ns3/object-factory.h"
 #include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/sat2ground-net-device.h"
+#include "ns3/sat2ground-transport.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
 
 #include "ns3/node.h"
@@ -38,8 +63,14 @@
 #include <boost/units/systems/si/plane_angle.hpp>
 #include <boost/units/systems/angle/degrees.hpp>
 #include <boost/units/systems/si/prefixes.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <ios>
 #include <sstream>
+#include <tuple>
+#include <dirent.h>
+#include <unistd.h>
 
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
@@ -140,38 +171,1745 @@ private:
   Ptr<CircularOrbitMobilityModel> mmodel;
 };
 
+class EarthFixedPositionTest : public TestCase
+{
+  using length = boost::units::quantity<boost::units::si::length>;
+  using plane_angle = boost::units::quantity<boost::units::si::plane_angle>;
+
+public:
+  EarthFixedPositionTest (length altitude, plane_angle inclination, plane_angle ascending_node,
+                          plane_angle phase)
+      : TestCase ("Check the Earth fixed position against the geographic conversion")
+  {
+    ObjectFactory circularOrbit;
+
+    circularOrbit.SetTypeId ("ns3::icarus::CircularOrbitMobilityModel");
+    sat = circularOrbit.Create<CircularOrbitMobilityModel> ();
+    sat->LaunchSat (inclination, ascending_node, altitude, phase);
+  }
+  virtual ~EarthFixedPositionTest () = default;
+
+private:
+  Ptr<CircularOrbitMobilityModel> sat;
+
+  virtual void
+  DoRun (void)
+  {
+    using namespace boost::units;
+    using ::icarus::satpos::planet::constants::Earth;
+
+    for (const auto t : {0.0, 1.0, 60.5, 3600.0, 9384.0, 86400.0, 268896.0, 604800.0})
+      {
+        quantity<si::length> x, y, z;
+        std::tie (x, y, z) =
+            sat->getOrbit ().getCartesianPositionRightAscensionDeclination (t * si::seconds);
+        const Vector raw (x.value (), y.value (), z.value ());
+
+        // The conversion as it was done through geographic coordinates
+        const auto radius{raw.GetLength ()};
+        const auto latitude{si::radian * asin (raw.z / radius)};
+        const auto prime_meridian_ascension{si::second * t * Earth.getRotationRate ()};
+        const auto sat_ascension{si::radian * atan2 (raw.y, raw.x)};
+        const Vector expected = GeographicPositions::GeographicToCartesianCoordinates (
+            quantity<degree::plane_angle> (latitude).value (),
+            quantity<degree::plane_angle> (sat_ascension - prime_meridian_ascension).value (),
+            radius - Earth.getRadius ().value (), GeographicPositions::SPHERE);
+
+        const Vector position = CircularOrbitMobilityModel::toEarthFixed (raw, Seconds (t));
+
+        NS_TEST_ASSERT_MSG_EQ_TOL (position.x, expected.x, 1e-2, "X coordinate differs at " << t);
+        NS_TEST_ASSERT_MSG_EQ_TOL (position.y, expected.y, 1e-2, "Y coordinate differs at " << t);
+        NS_TEST_ASSERT_MSG_EQ_TOL (position.z, expected.z, 1e-2, "Z coordinate differs at " << t);
+      }
+  }
+};
+
+class PassesTest : public TestCase
+{
+  using length = boost::units::quantity<boost::units::si::length>;
+  using plane_angle = boost::units::quantity<boost::units::si::plane_angle>;
+
+public:
+  PassesTest (length altitude, plane_angle inclination, plane_angle latitude,
+              plane_angle longitude)
+      : TestCase ("Check the contact intervals against the next crossing search"),
+        sat (inclination, 0 * boost::units::si::radians,
+             altitude + ::icarus::satpos::planet::constants::Earth.getRadius (),
+             0 * boost::units::si::radians),
+        latitude (latitude),
+        longitude (longitude)
+  {
+  }
+  virtual ~PassesTest () = default;
+
+private:
+  const CircularOrbitMobilityModelImpl sat;
+  const plane_angle latitude, longitude;
+
+  virtual void
+  DoRun (void)
+  {
+    using namespace boost::units;
+    using ::icarus::satpos::planet::constants::Earth;
+
+    const auto radius = Earth.getRadius ();
+    const auto distance =
+        sat.getGroundDistanceAtElevation (quantity<si::plane_angle> (25 * degree::degrees), radius);
+    const auto passes = orbit::findPasses (0 * si::seconds, 86400 * si::seconds, sat, distance,
+                                           latitude, longitude, radius);
+
+    NS_TEST_ASSERT_MSG_GT (passes.size (), 0u, "There should be some passes in a day");
+    for (const auto &pass : passes)
+      {
+        NS_TEST_ASSERT_MSG_LT (pass.first.value (), pass.second.value (), "Passes must not be empty");
+
+        const auto aos = orbit::findNextCross (pass.first - 1 * si::seconds, sat, distance,
+                                               latitude, longitude, radius);
+        const auto los = orbit::findNextCross (pass.first + 1 * si::seconds, sat, distance,
+                                               latitude, longitude, radius);
+        NS_TEST_ASSERT_MSG_EQ (bool (aos && los), true, "Pass edges must be crossings");
+        NS_TEST_ASSERT_MSG_EQ_TOL (aos->value (), pass.first.value (), 1e-3, "AOS mismatch");
+        NS_TEST_ASSERT_MSG_EQ_TOL (los->value (), pass.second.value (), 1e-3, "LOS mismatch");
+      }
+  }
+};
+
+class ContactPlanTest : public TestCase
+{
+public:
+  ContactPlanTest () : TestCase ("Check the contact plan lookups, threads and cache")
+  {
+  }
+  virtual ~ContactPlanTest () = default;
+
+private:
+  typedef std::vector<std::pair<Time, Time>> Contacts;
+
+  // Every contact of a pair, walked through the public lookups
+  static Contacts
+  GetContacts (Ptr<const ContactPlan> plan, Ptr<Node> ground, std::size_t plane,
+               std::size_t index)
+  {
+    Contacts contacts;
+    Time t = Seconds (0);
+    if (const auto los = plan->GetLos (ground, plane, index, t))
+      {
+        contacts.emplace_back (t, *los);
+        t = *los;
+      }
+    while (plan->Covers (t))
+      {
+        const auto aos = plan->GetNextAos (ground, plane, index, t);
+        if (!aos || !plan->Covers (*aos))
+          {
+            break;
+          }
+        const auto los = plan->GetLos (ground, plane, index, *aos);
+        if (!los)
+          {
+            break;
+          }
+        contacts.emplace_back (*aos, *los);
+        t = *los;
+      }
+
+    return contacts;
+  }
+
+  static Ptr<ContactPlan>
+  MakePlan (Ptr<const Constellation> constellation, const NodeContainer &ground,
+            const std::string &cacheDirectory, double minElevation, std::uint32_t threads)
+  {
+    const auto plan = CreateObject<ContactPlan> ();
+    plan->SetAttribute ("Horizon", TimeValue (Hours (6)));
+    plan->SetAttribute ("MinElevation", DoubleValue (minElevation));
+    plan->SetAttribute ("CacheDirectory", StringValue (cacheDirectory));
+    plan->SetAttribute ("Threads", UintegerValue (threads));
+    plan->Compute (constellation, ground);
+
+    return plan;
+  }
+
+  static void
+  RemoveDirectory (const std::string &path)
+  {
+    if (const auto dir = opendir (path.c_str ()))
+      {
+        while (const auto entry = readdir (dir))
+          {
+            const std::string name = entry->d_name;
+            if (name != "." && name != "..")
+              {
+                std::remove ((path + "/" + name).c_str ());
+              }
+          }
+        closedir (dir);
+      }
+    rmdir (path.c_str ());
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    using namespace boost::units;
+    using namespace boost::units::si;
+
+    IcarusHelper icarusHelper;
+    ConstellationHelper constellationHelper (quantity<length> (550 * kilo * meters),
+                                             quantity<plane_angle> (53 * degree::degree), 4, 5,
+                                             1);
+    NodeContainer satellites;
+    satellites.Create (4 * 5);
+    icarusHelper.Install (satellites, constellationHelper);
+    const auto constellation = constellationHelper.GetConstellation ();
+
+    NodeContainer ground;
+    ground.Create (3);
+    const double sites[][2] = {{42.17, -8.68}, {-33.9, 18.4}, {0.0, 100.0}};
+    for (auto i = 0u; i < ground.GetN (); i++)
+      {
+        const auto mobility = CreateObject<ConstantPositionMobilityModel> ();
+        mobility->SetPosition (GeographicPositions::GeographicToCartesianCoordinates (
+            sites[i][0], sites[i][1], 0, GeographicPositions::WGS84));
+        ground.Get (i)->AggregateObject (mobility);
+      }
+
+    const auto single = MakePlan (constellation, ground, "", 25.0, 1);
+    const auto threaded = MakePlan (constellation, ground, "", 25.0, 4);
+    NS_TEST_ASSERT_MSG_GT (single->GetNContacts (), 0u, "There should be some contacts");
+    NS_TEST_ASSERT_MSG_EQ (threaded->GetNContacts (), single->GetNContacts (),
+                           "Threads must not change the number of contacts");
+
+    // The plan solves the passes on a spherical Earth, so allow for a small elevation error
+    const auto minElevation = quantity<plane_angle> (25 * degree::degrees).value ();
+    const auto tolerance = quantity<plane_angle> (1 * degree::degrees).value ();
+    const auto margin = Seconds (10);
+    for (auto i = 0u; i < ground.GetN (); i++)
+      {
+        const auto node = ground.Get (i);
+        const auto groundPosition = node->GetObject<MobilityModel> ()->GetPosition ();
+        for (std::size_t plane = 0; plane < 4; plane++)
+          {
+            for (std::size_t index = 0; index < 5; index++)
+              {
+                const auto contacts = GetContacts (single, node, plane, index);
+                NS_TEST_ASSERT_MSG_EQ ((GetContacts (threaded, node, plane, index) == contacts),
+                                       true, "Threads must not change the contacts");
+
+                const auto orbit = constellation->GetSatellite (plane, index)
+                                       ->GetNode ()
+                                       ->GetObject<CircularOrbitMobilityModel> ();
+                const auto elevation = [&orbit, &groundPosition] (Time t) {
+                  return CircularOrbitMobilityModel::getSatElevation (orbit->getPositionAt (t),
+                                                                      groundPosition)
+                      .value ();
+                };
+                for (const auto &contact : contacts)
+                  {
+                    const auto middle =
+                        Seconds ((contact.first.GetSeconds () + contact.second.GetSeconds ()) / 2);
+                    NS_TEST_ASSERT_MSG_EQ (single->IsVisible (node, plane, index, middle), true,
+                                           "The satellite must be visible within a contact");
+                    NS_TEST_ASSERT_MSG_GT (elevation (middle), minElevation - tolerance,
+                                           "The satellite must be high within a contact");
+                    if (contact.first > margin)
+                      {
+                        NS_TEST_ASSERT_MSG_LT (elevation (contact.first - margin),
+                                               minElevation + tolerance,
+                                               "Wrong acquisition of signal");
+                      }
+                    if (single->Covers (contact.second + margin))
+                      {
+                        NS_TEST_ASSERT_MSG_EQ (
+                            single->IsVisible (node, plane, index, contact.second + Seconds (1)),
+                            false, "The satellite must not be visible after a contact");
+                        NS_TEST_ASSERT_MSG_LT (elevation (contact.second + margin),
+                                               minElevation + tolerance, "Wrong loss of signal");
+                      }
+                  }
+              }
+          }
+      }
+
+    // A contact cut by the end of the horizon is visible, but its end is not a loss of signal
+    Ptr<Node> cutNode;
+    std::size_t cutPlane = 0, cutIndex = 0;
+    Contacts cutContacts;
+    for (auto i = 0u; i < ground.GetN () && cutContacts.empty (); i++)
+      {
+        for (std::size_t plane = 0; plane < 4 && cutContacts.empty (); plane++)
+          {
+            for (std::size_t index = 0; index < 5 && cutContacts.empty (); index++)
+              {
+                cutContacts = GetContacts (single, ground.Get (i), plane, index);
+                cutNode = ground.Get (i);
+                cutPlane = plane;
+                cutIndex = index;
+              }
+          }
+      }
+    NS_TEST_ASSERT_MSG_EQ (cutContacts.empty (), false, "There should be a complete contact");
+    // Cut it in the middle and look it up halfway to the cut
+    const auto aos = cutContacts.front ().first.GetSeconds ();
+    const auto duration = cutContacts.front ().second.GetSeconds () - aos;
+    const auto cut = CreateObject<ContactPlan> ();
+    cut->SetAttribute ("Horizon", TimeValue (Seconds (aos + duration / 2)));
+    cut->Compute (constellation, ground);
+    const auto t = Seconds (aos + duration / 4);
+    NS_TEST_EXPECT_MSG_EQ (cut->IsVisible (cutNode, cutPlane, cutIndex, t), true,
+                           "The satellite must be visible until the end of the horizon");
+    NS_TEST_EXPECT_MSG_EQ (cut->GetLos (cutNode, cutPlane, cutIndex, t).has_value (), false,
+                           "The end of the horizon must not be reported as a loss of signal");
+
+    // The cache is written by the first run, read by the next ones and ignored on any change
+    char directory[] = "/tmp/icarus-contact-plan-XXXXXX";
+    const bool created = mkdtemp (directory) != nullptr;
+    NS_TEST_ASSERT_MSG_EQ (created, true, "Cannot create a temporary directory");
+
+    const auto stored = MakePlan (constellation, ground, directory, 25.0, 0);
+    NS_TEST_EXPECT_MSG_EQ (stored->IsCached (), false, "The first plan must be computed");
+    const auto loaded = MakePlan (constellation, ground, directory, 25.0, 0);
+    NS_TEST_EXPECT_MSG_EQ (loaded->IsCached (), true, "The second plan must be read");
+    NS_TEST_EXPECT_MSG_EQ (loaded->GetNContacts (), single->GetNContacts (),
+                           "The cached plan must have every contact");
+    for (std::size_t plane = 0; plane < 4; plane++)
+      {
+        for (std::size_t index = 0; index < 5; index++)
+          {
+            NS_TEST_EXPECT_MSG_EQ ((GetContacts (loaded, ground.Get (0), plane, index) ==
+                                    GetContacts (single, ground.Get (0), plane, index)),
+                                   true, "The cached plan must have the same contacts");
+          }
+      }
+
+    NS_TEST_EXPECT_MSG_EQ (MakePlan (constellation, ground, directory, 30.0, 0)->IsCached (),
+                           false, "A different elevation must not use the cached plan");
+
+    NodeContainer otherGround;
+    otherGround.Add (ground.Get (0));
+    otherGround.Add (ground.Get (1));
+    NS_TEST_EXPECT_MSG_EQ (MakePlan (constellation, otherGround, directory, 25.0, 0)->IsCached (),
+                           false, "Different ground stations must not use the cached plan");
+
+    ConstellationHelper otherHelper (quantity<length> (600 * kilo * meters),
+                                     quantity<plane_angle> (53 * degree::degree), 4, 5, 1);
+    NodeContainer otherSatellites;
+    otherSatellites.Create (4 * 5);
+    icarusHelper.Install (otherSatellites, otherHelper);
+    NS_TEST_EXPECT_MSG_EQ (
+        MakePlan (otherHelper.GetConstellation (), ground, directory, 25.0, 0)->IsCached (),
+        false, "A different constellation must not use the cached plan");
+
+    RemoveDirectory (directory);
+    Simulator::Destroy ();
+  }
+};
+
+class HandoverSchedulerTest : public TestCase
+{
+public:
+  HandoverSchedulerTest () : TestCase ("Check the handover calendar of the ground stations")
+  {
+  }
+  virtual ~HandoverSchedulerTest () = default;
+
+private:
+  // Records its updates and follows a fixed list of next update times. It hands over to a new
+  // satellite in every update, or keeps the default one.
+  class Tracker : public GroundNodeSatTracker
+  {
+  public:
+    Tracker (std::vector<Time> next, bool handover)
+        : m_next (std::move (next)), m_handover (handover)
+    {
+    }
+
+    boost::optional<Time>
+    Track () override
+    {
+      m_updates.push_back (Simulator::Now ());
+      SetRemoteAddress (m_handover ? SatAddress (0, 0, m_updates.size ()).ConvertTo ()
+                                   : SatAddress (0, 0, 0).ConvertTo ());
+
+      if (m_updates.size () > m_next.size ())
+        {
+          return {};
+        }
+      return m_next[m_updates.size () - 1];
+    }
+
+    std::vector<Time> m_next;
+    bool m_handover;
+    std::vector<Time> m_updates;
+  };
+
+  std::vector<std::tuple<Time, uint32_t, uint32_t>> m_handovers;
+
+  void
+  Handover (Ptr<Node> ground, const Address &, const Address &)
+  {
+    m_handovers.emplace_back (Simulator::Now (), ground->GetId (), Simulator::GetContext ());
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    const auto scheduler = CreateObject<HandoverScheduler> ();
+    scheduler->TraceConnectWithoutContext (
+        "Handover", MakeCallback (&HandoverSchedulerTest::Handover, this));
+
+    NodeContainer nodes;
+    nodes.Create (4);
+    const std::vector<std::vector<Time>> next{{Seconds (3)}, {}, {}, {}};
+    const std::vector<bool> handover{true, false, true, true};
+    std::vector<Ptr<Tracker>> trackers;
+    for (auto i = 0u; i < nodes.GetN (); i++)
+      {
+        nodes.Get (i)->AddDevice (CreateObject<GroundStaNetDevice> ());
+        trackers.push_back (CreateObject<Tracker> (next[i], handover[i]));
+        nodes.Get (i)->AggregateObject (trackers.back ());
+      }
+
+    // Two updates at the same time, one moved to a later time and one cancelled
+    scheduler->Schedule (PeekPointer (trackers[0]), Seconds (1));
+    scheduler->Schedule (PeekPointer (trackers[1]), Seconds (1));
+    scheduler->Schedule (PeekPointer (trackers[2]), Seconds (2));
+    scheduler->Schedule (PeekPointer (trackers[3]), Seconds (2.5));
+    scheduler->Schedule (PeekPointer (trackers[2]), Seconds (4));
+    scheduler->Cancel (PeekPointer (trackers[3]));
+    NS_TEST_ASSERT_MSG_EQ (scheduler->GetNPending (), 3u, "Wrong number of pending updates");
+
+    // Leave the initialization of the nodes out of the count of events
+    Simulator::Stop (Seconds (0.5));
+    Simulator::Run ();
+    const auto initEvents = Simulator::GetEventCount ();
+    Simulator::Run ();
+    const auto events = Simulator::GetEventCount () - initEvents;
+
+    const std::vector<std::vector<Time>> expected{
+        {Seconds (1), Seconds (3)}, {Seconds (1)}, {Seconds (4)}, {}};
+    for (auto i = 0u; i < nodes.GetN (); i++)
+      {
+        NS_TEST_EXPECT_MSG_EQ ((trackers[i]->m_updates == expected[i]), true,
+                               "Wrong updates of tracker " << i);
+      }
+    NS_TEST_EXPECT_MSG_EQ (scheduler->GetNPending (), 0u, "No update should be left");
+
+    // The second station keeps its satellite
+    const std::vector<std::tuple<Time, uint32_t, uint32_t>> handovers{
+        {Seconds (1), nodes.Get (0)->GetId (), nodes.Get (0)->GetId ()},
+        {Seconds (3), nodes.Get (0)->GetId (), nodes.Get (0)->GetId ()},
+        {Seconds (4), nodes.Get (2)->GetId (), nodes.Get (2)->GetId ()}};
+    NS_TEST_EXPECT_MSG_EQ ((m_handovers == handovers), true,
+                           "Handovers must be traced in the context of their node");
+
+    // A single event for every instant with due updates, and one more for every handover
+    NS_TEST_EXPECT_MSG_EQ (events, 3 + handovers.size (),
+                           "Updates without a handover must not need events of their own");
+
+    Simulator::Destroy ();
+  }
+};
+
+// Ground stations fed by a single plane of satellites through a GroundSatChannel
+class DownlinkTest : public TestCase
+{
+protected:
+  explicit DownlinkTest (const std::string &name) : TestCase (name)
+  {
+  }
+
+  struct Reception
+  {
+    Time time;
+    std::size_t station;
+    std::size_t satellite;
+    uint32_t context;
+    uint64_t packet;
+  };
+
+  Ptr<GroundSatChannel> m_channel;
+  std::vector<Ptr<Sat2GroundNetDevice>> m_satellites;
+  std::vector<Ptr<GroundStaNetDevice>> m_stations;
+  std::vector<Reception> m_receptions;
+
+  // Every station only receives, so none of them transmits in the uplink
+  void
+  Install (IcarusHelper &icarusHelper, std::size_t nSatellites, std::size_t nStations)
+  {
+    using namespace boost::units;
+    using namespace boost::units::si;
+
+    icarusHelper.SetTrackerModel ("ns3::icarus::GroundNodeSatTrackerPeriodic", "TrackingInterval",
+                                  TimeValue (Seconds (0)));
+    ConstellationHelper constellationHelper (quantity<length> (550 * kilo * meters),
+                                             quantity<plane_angle> (53 * degree::degree), 1,
+                                             nSatellites, 0);
+    NodeContainer nodes;
+    nodes.Create (nSatellites);
+    for (auto i = 0u; i < nStations; i++)
+      {
+        const auto node = CreateObject<Node> ();
+        const auto mobility = CreateObject<ConstantPositionMobilityModel> ();
+        mobility->SetPosition (GeographicPositions::GeographicToCartesianCoordinates (
+            40.0 - 10.0 * i, -8.0 + 20.0 * i, 0, GeographicPositions::WGS84));
+        node->AggregateObject (mobility);
+        nodes.Add (node);
+      }
+    icarusHelper.Install (nodes, constellationHelper);
+
+    const auto constellation = constellationHelper.GetConstellation ();
+    for (auto i = 0u; i < nSatellites; i++)
+      {
+        m_satellites.push_back (constellation->GetSatellite (0, i));
+      }
+    for (auto i = nSatellites; i < nodes.GetN (); i++)
+      {
+        m_stations.push_back (DynamicCast<GroundStaNetDevice> (nodes.Get (i)->GetDevice (0)));
+        m_stations.back ()->SetReceiveCallback (MakeCallback (&DownlinkTest::Receive, this));
+      }
+    m_channel = DynamicCast<GroundSatChannel> (m_stations.front ()->GetChannel ());
+    // Deliver regardless of the elevation of the satellites
+    m_channel->SetAttribute ("TxSuccess", PointerValue ());
+  }
+
+  SatAddress
+  GetSatAddress (std::size_t satellite) const
+  {
+    return SatAddress::ConvertFrom (m_satellites[satellite]->GetAddress ());
+  }
+
+  static DataRate
+  GetDataRate ()
+  {
+    return DataRate ("10Mbps");
+  }
+
+  static uint32_t
+  GetPacketSize ()
+  {
+    return 1000;
+  }
+
+  // Returns the uid of the transmitted packet
+  uint64_t
+  Transmit (std::size_t satellite)
+  {
+    const auto packet = Create<Packet> (GetPacketSize ());
+    m_channel->Transmit2Ground (packet, GetDataRate (), m_satellites[satellite], 0, 30.0);
+
+    return packet->GetUid ();
+  }
+
+  bool
+  Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t, const Address &src)
+  {
+    const auto station = std::find (m_stations.cbegin (), m_stations.cend (), device);
+    std::size_t satellite = 0;
+    while (satellite < m_satellites.size () && m_satellites[satellite]->GetAddress () != src)
+      {
+        satellite++;
+      }
+    m_receptions.push_back ({Simulator::Now (), std::size_t (station - m_stations.cbegin ()),
+                             satellite, Simulator::GetContext (), packet->GetUid ()});
+
+    return true;
+  }
+};
+
+class DownlinkTrackingTest : public DownlinkTest
+{
+public:
+  DownlinkTrackingTest (bool trackingFilter)
+      : DownlinkTest ("Check the downlink receivers across handovers and promiscuous stations"),
+        m_trackingFilter (trackingFilter)
+  {
+  }
+  virtual ~DownlinkTrackingTest () = default;
+
+private:
+  const bool m_trackingFilter;
+
+  void
+  Track (std::size_t station, std::size_t satellite)
+  {
+    m_stations[station]->SetRemoteAddress (GetSatAddress (satellite));
+  }
+
+  void
+  SetPromiscuous (std::size_t station, bool promiscuous)
+  {
+    m_stations[station]->SetAttribute ("PromiscuousDownlink", BooleanValue (promiscuous));
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    IcarusHelper icarusHelper;
+    icarusHelper.SetChannelAttribute ("TrackingFilter", BooleanValue (m_trackingFilter));
+    Install (icarusHelper, 3, 3);
+
+    // Set after attaching the stations, so the channel has to follow the changes
+    m_stations[0]->SetAttribute ("RemoteAddress", SatAddressValue (GetSatAddress (0)));
+    Track (1, 1);
+    Track (2, 2);
+    SetPromiscuous (2, true);
+
+    Simulator::Schedule (Seconds (1), &DownlinkTrackingTest::Transmit, this, 0);
+    Simulator::Schedule (Seconds (1), &DownlinkTrackingTest::Transmit, this, 1);
+    Simulator::Schedule (Seconds (2), &DownlinkTrackingTest::Track, this, 0, 1);
+    Simulator::Schedule (Seconds (3), &DownlinkTrackingTest::Transmit, this, 0);
+    Simulator::Schedule (Seconds (3), &DownlinkTrackingTest::Transmit, this, 1);
+    Simulator::Schedule (Seconds (4), &DownlinkTrackingTest::SetPromiscuous, this, 2, false);
+    Simulator::Schedule (Seconds (5), &DownlinkTrackingTest::Transmit, this, 0);
+    Simulator::Schedule (Seconds (5), &DownlinkTrackingTest::Transmit, this, 2);
+    // The filter picks the receivers when the frame is sent, before this station switches
+    Simulator::Schedule (Seconds (6), &DownlinkTrackingTest::Transmit, this, 2);
+    Simulator::Schedule (Seconds (6) + MicroSeconds (1), &DownlinkTrackingTest::Track, this, 1, 2);
+    Simulator::Run ();
+
+    // (second of the transmission, station, satellite)
+    std::vector<std::tuple<int, std::size_t, std::size_t>> expected{
+        {1, 0, 0}, {1, 1, 1}, {1, 2, 0}, {1, 2, 1}, {3, 0, 1},
+        {3, 1, 1}, {3, 2, 0}, {3, 2, 1}, {5, 2, 2}, {6, 2, 2}};
+    if (!m_trackingFilter)
+      {
+        expected.emplace (expected.cend () - 1, 6, 1, 2);
+      }
+    std::vector<std::tuple<int, std::size_t, std::size_t>> received;
+    for (const auto &reception : m_receptions)
+      {
+        received.emplace_back (static_cast<int> (reception.time.GetSeconds ()), reception.station,
+                               reception.satellite);
+      }
+    std::sort (received.begin (), received.end ());
+    NS_TEST_EXPECT_MSG_EQ ((received == expected), true, "Wrong downlink receivers");
+
+    Simulator::Destroy ();
+  }
+};
+
+class DownlinkDeliveryTest : public DownlinkTest
+{
+public:
+  DownlinkDeliveryTest (bool batched, Time quantum)
+      : DownlinkTest ("Check the timing and context of pooled and batched downlink deliveries"),
+        m_batched (batched),
+        m_quantum (quantum)
+  {
+  }
+  virtual ~DownlinkDeliveryTest () = default;
+
+private:
+  const bool m_batched;
+  const Time m_quantum;
+  std::vector<Reception> m_expected;
+
+  // Transmit from the first satellite and work out when and where every station receives it
+  void
+  TransmitAndPredict ()
+  {
+    const auto satPosition =
+        m_satellites[0]->GetNode ()->GetObject<MobilityModel> ()->GetPosition ();
+    std::vector<Time> delays;
+    for (const auto &station : m_stations)
+      {
+        const auto position = station->GetNode ()->GetObject<MobilityModel> ()->GetPosition ();
+        auto delay = Seconds (CalculateDistance (position, satPosition) / 299792458.0);
+        const auto quantum = m_quantum.GetTimeStep ();
+        if (m_batched && quantum > 0)
+          {
+            delay = TimeStep ((delay.GetTimeStep () + quantum / 2) / quantum * quantum);
+          }
+        delays.push_back (delay);
+      }
+
+    const auto uid = Transmit (0);
+    const auto txTime = GetDataRate ().CalculateBytesTxTime (GetPacketSize ());
+    for (auto i = 0u; i < m_stations.size (); i++)
+      {
+        // Batches run in the context of their first station
+        auto first = i;
+        if (m_batched)
+          {
+            first = std::find (delays.cbegin (), delays.cend (), delays[i]) - delays.cbegin ();
+          }
+        m_expected.push_back ({Simulator::Now () + delays[i] + txTime, i, 0,
+                               m_stations[first]->GetNode ()->GetId (), uid});
+      }
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    IcarusHelper icarusHelper;
+    icarusHelper.SetChannelAttribute ("BatchedDelivery", BooleanValue (m_batched));
+    icarusHelper.SetChannelAttribute ("DelayQuantum", TimeValue (m_quantum));
+    Install (icarusHelper, 1, 5);
+    for (const auto &station : m_stations)
+      {
+        station->SetRemoteAddress (GetSatAddress (0));
+      }
+
+    // Later transmissions reuse the delivery events of the former ones
+    for (auto t = 1; t <= 3; t++)
+      {
+        Simulator::Schedule (Seconds (t), &DownlinkDeliveryTest::TransmitAndPredict, this);
+      }
+    Simulator::Run ();
+
+    const auto order = [] (const Reception &a, const Reception &b) {
+      return std::tie (a.time, a.station) < std::tie (b.time, b.station);
+    };
+    std::sort (m_receptions.begin (), m_receptions.end (), order);
+    std::sort (m_expected.begin (), m_expected.end (), order);
+    NS_TEST_ASSERT_MSG_EQ (m_receptions.size (), m_expected.size (), "Wrong number of receptions");
+    for (auto i = 0u; i < m_expected.size (); i++)
+      {
+        const auto &reception = m_receptions[i];
+        const auto &expected = m_expected[i];
+        NS_TEST_EXPECT_MSG_EQ (reception.time, expected.time, "Wrong reception time");
+        NS_TEST_EXPECT_MSG_EQ (reception.station, expected.station, "Wrong station");
+        NS_TEST_EXPECT_MSG_EQ (reception.packet, expected.packet, "Wrong packet");
+        NS_TEST_EXPECT_MSG_EQ (reception.context, expected.context, "Wrong context");
+      }
+
+    Simulator::Destroy ();
+  }
+};
+
+class DownlinkDisposeTest : public DownlinkTest
+{
+public:
+  DownlinkDisposeTest ()
+      : DownlinkTest ("Check the downlink deliveries scheduled before disposing of the channel")
+  {
+  }
+  virtual ~DownlinkDisposeTest () = default;
+
+private:
+  virtual void
+  DoRun (void)
+  {
+    IcarusHelper icarusHelper;
+    icarusHelper.SetChannelAttribute ("BatchedDelivery", BooleanValue (true));
+    Install (icarusHelper, 1, 3);
+    for (const auto &station : m_stations)
+      {
+        station->SetRemoteAddress (GetSatAddress (0));
+      }
+
+    // Stop while the frame propagates, which takes some milliseconds
+    Simulator::Schedule (Seconds (1), &DownlinkDisposeTest::Transmit, this, 0);
+    Simulator::Stop (Seconds (1) + MicroSeconds (10));
+    Simulator::Run ();
+    NS_TEST_ASSERT_MSG_EQ (m_receptions.size (), 0u, "Nothing should be received yet");
+
+    m_channel->Dispose ();
+    Simulator::Run ();
+    NS_TEST_EXPECT_MSG_EQ (m_receptions.size (), m_stations.size (),
+                           "Pending deliveries must survive the channel");
+
+    Simulator::Destroy ();
+  }
+};
+
+class DownlinkCutThroughTest : public DownlinkTest
+{
+public:
+  DownlinkCutThroughTest ()
+      : DownlinkTest ("Check that cut-through downlink receptions match the regular ones")
+  {
+  }
+  virtual ~DownlinkCutThroughTest () = default;
+
+private:
+  // (station, whether it is PhyRxEnd, index of the transmission)
+  using Trace = std::tuple<std::size_t, bool, std::size_t>;
+  // (time, station, index of the transmission)
+  using Delivery = std::tuple<Time, std::size_t, std::size_t>;
+
+  std::vector<uint64_t> m_sent;
+  std::vector<Trace> m_traces;
+
+  std::size_t
+  GetIndex (uint64_t uid) const
+  {
+    return std::find (m_sent.cbegin (), m_sent.cend (), uid) - m_sent.cbegin ();
+  }
+
+  void
+  PhyRxBegin (std::string station, Ptr<const Packet> packet)
+  {
+    m_traces.emplace_back (std::stoul (station), false, GetIndex (packet->GetUid ()));
+  }
+
+  void
+  PhyRxEnd (std::string station, Ptr<const Packet> packet)
+  {
+    m_traces.emplace_back (std::stoul (station), true, GetIndex (packet->GetUid ()));
+  }
+
+  void
+  Track (std::size_t station, std::size_t satellite)
+  {
+    m_stations[station]->SetRemoteAddress (GetSatAddress (satellite));
+  }
+
+  void
+  Send ()
+  {
+    m_sent.push_back (Transmit (0));
+  }
+
+  // Send from the first satellite. Halfway through the receptions, the first station stops
+  // tracking it and the last one starts.
+  void
+  SendAndSwitch ()
+  {
+    const auto satPosition =
+        m_satellites[0]->GetNode ()->GetObject<MobilityModel> ()->GetPosition ();
+    const auto half =
+        Seconds (GetDataRate ().CalculateBytesTxTime (GetPacketSize ()).GetSeconds () / 2);
+    Send ();
+    // (station, satellite it tracks next)
+    const std::pair<std::size_t, std::size_t> changes[] = {{0, 1}, {2, 0}};
+    for (const auto &change : changes)
+      {
+        const auto position =
+            m_stations[change.first]->GetNode ()->GetObject<MobilityModel> ()->GetPosition ();
+        const auto delay = Seconds (CalculateDistance (position, satPosition) / 299792458.0);
+        Simulator::Schedule (delay + half, &DownlinkCutThroughTest::Track, this, change.first,
+                             change.second);
+      }
+  }
+
+  // Returns the number of events run
+  uint64_t
+  Run (bool cutThrough, std::vector<Trace> &traces, std::vector<Delivery> &deliveries)
+  {
+    IcarusHelper icarusHelper;
+    icarusHelper.SetChannelAttribute ("CutThrough", BooleanValue (cutThrough));
+    Install (icarusHelper, 2, 3);
+    Track (0, 0);
+    Track (1, 0);
+    Track (2, 1);
+    for (auto i = 0u; i < m_stations.size (); i++)
+      {
+        m_stations[i]->TraceConnect ("PhyRxBegin", std::to_string (i),
+                                     MakeCallback (&DownlinkCutThroughTest::PhyRxBegin, this));
+        m_stations[i]->TraceConnect ("PhyRxEnd", std::to_string (i),
+                                     MakeCallback (&DownlinkCutThroughTest::PhyRxEnd, this));
+      }
+
+    Simulator::Schedule (Seconds (1), &DownlinkCutThroughTest::Send, this);
+    Simulator::Schedule (Seconds (2), &DownlinkCutThroughTest::SendAndSwitch, this);
+    Simulator::Schedule (Seconds (3), &DownlinkCutThroughTest::Send, this);
+    Simulator::Stop (Seconds (4));
+    Simulator::Run ();
+    const auto events = Simulator::GetEventCount ();
+    Simulator::Destroy ();
+
+    // The frames of a station never overlap, so its traces must come in the same order in both
+    // modes, even if those of different stations interleave differently
+    traces.swap (m_traces);
+    std::stable_sort (traces.begin (), traces.end (), [] (const Trace &a, const Trace &b) {
+      return std::get<0> (a) < std::get<0> (b);
+    });
+    for (const auto &reception : m_receptions)
+      {
+        deliveries.emplace_back (reception.time, reception.station, GetIndex (reception.packet));
+      }
+    std::sort (deliveries.begin (), deliveries.end ());
+
+    m_channel = nullptr;
+    m_satellites.clear ();
+    m_stations.clear ();
+    m_receptions.clear ();
+    m_sent.clear ();
+
+    return events;
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    std::vector<Trace> regularTraces, cutThroughTraces;
+    std::vector<Delivery> regular, cutThrough;
+    const auto regularEvents = Run (false, regularTraces, regular);
+    const auto cutThroughEvents = Run (true, cutThroughTraces, cutThrough);
+
+    // (transmission, station). Whether a station listens is decided when the reception starts.
+    const std::vector<std::pair<std::size_t, std::size_t>> expected{{0, 0}, {0, 1}, {1, 0},
+                                                                    {1, 1}, {2, 1}, {2, 2}};
+    std::vector<std::pair<std::size_t, std::size_t>> received;
+    for (const auto &delivery : cutThrough)
+      {
+        received.emplace_back (std::get<2> (delivery), std::get<1> (delivery));
+      }
+    std::sort (received.begin (), received.end ());
+    NS_TEST_EXPECT_MSG_EQ ((received == expected), true, "Wrong cut-through receivers");
+
+    NS_TEST_EXPECT_MSG_EQ ((cutThrough == regular), true, "Frames must be received at their end");
+    NS_TEST_EXPECT_MSG_EQ ((cutThroughTraces == regularTraces), true,
+                           "PhyRxBegin and PhyRxEnd must fire in the same order");
+    // A single event per reception, instead of one at its start and another one at its end
+    NS_TEST_EXPECT_MSG_EQ (regularEvents - cutThroughEvents, regular.size (),
+                           "Cut-through must save one event per reception");
+  }
+};
+
+class LinkStateCacheTest : public DownlinkTest
+{
+public:
+  LinkStateCacheTest ()
+      : DownlinkTest ("Check that the link state cache does not change the receptions")
+  {
+  }
+  virtual ~LinkStateCacheTest () = default;
+
+private:
+  // (time, station, satellite) of every uplink reception
+  std::vector<std::tuple<Time, std::size_t, std::size_t>> m_uplink;
+  std::size_t m_drops;
+
+  bool
+  ReceiveUplink (Ptr<NetDevice> device, Ptr<const Packet>, uint16_t, const Address &src)
+  {
+    const auto satellite = std::find (m_satellites.cbegin (), m_satellites.cend (), device);
+    std::size_t station = 0;
+    while (station < m_stations.size () && m_stations[station]->GetAddress () != src)
+      {
+        station++;
+      }
+    m_uplink.emplace_back (Simulator::Now (), station,
+                           std::size_t (satellite - m_satellites.cbegin ()));
+
+    return true;
+  }
+
+  void
+  Drop (Ptr<const Packet>)
+  {
+    m_drops++;
+  }
+
+  // Every station sends a frame to the first satellite, which receives them all at once
+  void
+  TransmitUplink ()
+  {
+    for (const auto &station : m_stations)
+      {
+        m_channel->Transmit2Sat (Create<Packet> (GetPacketSize ()), GetDataRate (), station,
+                                 GetSatAddress (0), 0, 10.0);
+      }
+  }
+
+  // Returns the downlink receptions as (time, station, satellite)
+  std::vector<std::tuple<Time, std::size_t, std::size_t>>
+  Run (bool linkStateCache)
+  {
+    IcarusHelper icarusHelper;
+    icarusHelper.SetChannelAttribute ("LinkStateCache", BooleanValue (linkStateCache));
+    // Captures depend on the received power of every frame
+    icarusHelper.SetMacModel ("ns3::icarus::AlohaMacModel", "SirThreshold", DoubleValue (3.0));
+    Install (icarusHelper, 3, 3);
+
+    // Within reach of some satellites only, but at least of the closest one to every station
+    const auto success = CreateObject<GroundSatSuccessDistance> ();
+    success->SetAttribute ("MaxDistance", DoubleValue (10000e3));
+    m_channel->SetAttribute ("TxSuccess", PointerValue (success));
+    m_channel->TraceConnectWithoutContext ("PhyTxDrop",
+                                           MakeCallback (&LinkStateCacheTest::Drop, this));
+    for (const auto &station : m_stations)
+      {
+        station->SetAttribute ("PromiscuousDownlink", BooleanValue (true));
+      }
+    for (const auto &satellite : m_satellites)
+      {
+        satellite->SetReceiveCallback (MakeCallback (&LinkStateCacheTest::ReceiveUplink, this));
+      }
+    m_uplink.clear ();
+    m_drops = 0;
+
+    // Several transmissions over the same links at the same time, with different powers
+    for (const auto t : {Seconds (1), Seconds (2)})
+      {
+        Simulator::Schedule (t, &LinkStateCacheTest::Transmit, this, 0);
+        Simulator::Schedule (t, &LinkStateCacheTest::Transmit, this, 0);
+        Simulator::Schedule (t, &LinkStateCacheTest::Transmit, this, 1);
+        Simulator::Schedule (t, &LinkStateCacheTest::Transmit, this, 2);
+        Simulator::Schedule (t, &LinkStateCacheTest::TransmitUplink, this);
+      }
+    Simulator::Run ();
+    Simulator::Destroy ();
+
+    std::vector<std::tuple<Time, std::size_t, std::size_t>> downlink;
+    for (const auto &reception : m_receptions)
+      {
+        downlink.emplace_back (reception.time, reception.station, reception.satellite);
+      }
+    std::sort (downlink.begin (), downlink.end ());
+    std::sort (m_uplink.begin (), m_uplink.end ());
+
+    m_channel = nullptr;
+    m_satellites.clear ();
+    m_stations.clear ();
+    m_receptions.clear ();
+
+    return downlink;
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    const auto downlink = Run (false);
+    const auto uplink = m_uplink;
+    const auto drops = m_drops;
+
+    const auto cachedDownlink = Run (true);
+
+    NS_TEST_ASSERT_MSG_EQ (downlink.empty (), false, "The closest satellites must be in reach");
+    NS_TEST_EXPECT_MSG_EQ ((cachedDownlink == downlink), true,
+                           "The cache must not change the downlink receptions");
+    NS_TEST_EXPECT_MSG_EQ ((m_uplink == uplink), true,
+                           "The cache must not change the uplink receptions");
+    NS_TEST_EXPECT_MSG_EQ (m_drops, drops, "The cache must not change the dropped frames");
+  }
+};
+
+class DownlinkNdnSchedulerTest : public DownlinkTest
+{
+public:
+  DownlinkNdnSchedulerTest ()
+      : DownlinkTest ("Check that the NDN downlink queues the Data of every ground station apart")
+  {
+  }
+  virtual ~DownlinkNdnSchedulerTest () = default;
+
+private:
+  std::shared_ptr<::nfd::face::Face> m_face;
+  // Size of every frame sent by the satellite, in order
+  std::vector<uint32_t> m_sent;
+
+  static constexpr std::size_t N_PACKETS = 4;
+
+  static ::ndn::Name
+  GetName (std::size_t station, std::size_t packet)
+  {
+    return ::ndn::Name ("/station").appendNumber (station).appendNumber (packet);
+  }
+
+  void
+  PhyTxBegin (Ptr<const Packet> packet)
+  {
+    m_sent.push_back (packet->GetSize ());
+  }
+
+  void
+  SendInterests (std::size_t station)
+  {
+    for (std::size_t i = 0; i < N_PACKETS; i++)
+      {
+        ::ndn::Interest interest (GetName (station, i));
+        interest.setCanBePrefix (false);
+        const auto packet = Create<Packet> ();
+        packet->AddHeader (ns3::ndn::BlockHeader (interest.wireEncode ()));
+        m_stations[station]->Send (packet, Address (), ns3::ndn::L3Protocol::ETHERNET_FRAME_TYPE);
+      }
+  }
+
+  // All the Data of the first station and then all of the second one. The size of the Data tells
+  // the stations apart.
+  void
+  SendData ()
+  {
+    for (std::size_t station = 0; station < m_stations.size (); station++)
+      {
+        for (std::size_t i = 0; i < N_PACKETS; i++)
+          {
+            ::ndn::Data data (GetName (station, i));
+            data.setContent (std::make_shared<::ndn::Buffer> (100 * (station + 1)));
+            ::ndn::Signature signature;
+            signature.setInfo (
+                ::ndn::SignatureInfo (static_cast<::ndn::tlv::SignatureTypeValue> (255)));
+            signature.setValue (
+                ::ndn::makeNonNegativeIntegerBlock (::ndn::tlv::SignatureValue, 0));
+            data.setSignature (signature);
+            m_face->getTransport ()->send (data.wireEncode ());
+          }
+      }
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    IcarusHelper icarusHelper;
+    Install (icarusHelper, 1, 2);
+    const auto satellite = m_satellites[0];
+    satellite->SetAttribute ("Scheduler",
+                             StringValue ("ns3::icarus::RoundRobinDownlinkScheduler"));
+    satellite->TraceConnectWithoutContext (
+        "PhyTxBegin", MakeCallback (&DownlinkNdnSchedulerTest::PhyTxBegin, this));
+    for (const auto &station : m_stations)
+      {
+        station->SetRemoteAddress (GetSatAddress (0));
+      }
+    m_face = std::make_shared<::nfd::face::Face> (
+        std::make_unique<::nfd::face::GenericLinkService> (),
+        std::make_unique<ns3::ndn::icarus::Sat2GroundTransport> (
+            satellite->GetNode (), satellite, "netdev://[00:00:00:00:00:01]",
+            "netdev://[ff:ff:ff:ff:ff:ff]"));
+
+    Simulator::Schedule (Seconds (1), &DownlinkNdnSchedulerTest::SendInterests, this, 0);
+    Simulator::Schedule (Seconds (1), &DownlinkNdnSchedulerTest::SendInterests, this, 1);
+    Simulator::Schedule (Seconds (2), &DownlinkNdnSchedulerTest::SendData, this);
+    Simulator::Stop (Seconds (3));
+    Simulator::Run ();
+    Simulator::Destroy ();
+    m_face.reset ();
+
+    NS_TEST_ASSERT_MSG_EQ (m_sent.size (), 2 * N_PACKETS, "Every Data must be sent");
+    // The first Data goes out at once. Then the scheduler alternates between the stations until
+    // the first one runs out.
+    for (std::size_t i = 1; i < 2 * N_PACKETS - 2; i++)
+      {
+        NS_TEST_EXPECT_MSG_NE (m_sent[i], m_sent[i + 1],
+                               "The Data of both stations must be interleaved at " << i);
+      }
+  }
+};
+
+class ClosestSatelliteTest : public TestCase
+{
+public:
+  ClosestSatelliteTest (Time indexMaxAge, Constellation::QueryMode mode)
+      : TestCase ("Check the closest satellite queries against a full scan"),
+        m_indexMaxAge (indexMaxAge),
+        m_mode (mode)
+  {
+  }
+  virtual ~ClosestSatelliteTest () = default;
+
+private:
+  const Time m_indexMaxAge;
+  const Constellation::QueryMode m_mode;
+  Ptr<Constellation> m_constellation;
+
+  void
+  Check ()
+  {
+    using boost::units::quantity;
+    using boost::units::si::plane_angle;
+    namespace degree = boost::units::degree;
+
+    const auto &positions = m_constellation->GetPositions ();
+
+    for (const auto latitude : {-70.0, -20.0, 0.0, 35.0, 80.0})
+      {
+        for (const auto longitude : {-150.0, -45.0, 10.0, 100.0})
+          {
+            const auto ground =
+                GeographicPositions::GeographicToCartesianCoordinates (latitude, longitude, 0,
+                                                                       GeographicPositions::WGS84);
+
+            std::vector<std::pair<double, std::size_t>> distances;
+            for (std::size_t slot = 0; slot < positions.size (); slot++)
+              {
+                distances.emplace_back (CalculateDistance (positions[slot], ground), slot);
+              }
+            std::sort (distances.begin (), distances.end ());
+
+            NS_TEST_EXPECT_MSG_EQ (m_constellation->GetClosest (ground),
+                                   m_constellation->Get (distances.front ().second),
+                                   "Wrong closest satellite at " << Simulator::Now ());
+
+            const quantity<plane_angle> minElevation (25 * degree::degrees);
+            std::vector<std::size_t> expected;
+            for (std::size_t slot = 0; slot < positions.size (); slot++)
+              {
+                if (CircularOrbitMobilityModel::getSatElevation (positions[slot], ground) >
+                    minElevation)
+                  {
+                    expected.push_back (slot);
+                  }
+              }
+            const auto visible = m_constellation->GetVisible (ground, minElevation);
+            NS_TEST_EXPECT_MSG_EQ (visible.size (), expected.size (),
+                                   "Wrong number of visible satellites");
+            for (std::size_t i = 0; i < std::min (visible.size (), expected.size ()); i++)
+              {
+                NS_TEST_EXPECT_MSG_EQ (visible[i].plane * m_constellation->GetPlaneSize () +
+                                           visible[i].index,
+                                       expected[i], "Wrong visible satellite");
+              }
+
+            const auto closest = m_constellation->GetKClosest (ground, 4);
+            NS_TEST_EXPECT_MSG_EQ (closest.size (), 4u, "Wrong number of satellites");
+            for (std::size_t i = 0; i < closest.size (); i++)
+              {
+                NS_TEST_EXPECT_MSG_EQ (closest[i], m_constellation->Get (distances[i].second),
+                                       "Wrong " << i << "-th closest satellite at "
+                                                << Simulator::Now ());
+              }
+          }
+      }
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    using namespace boost::units;
+    using namespace boost::units::si;
+
+    IcarusHelper icarusHelper;
+    ConstellationHelper constellationHelper (quantity<length> (550 * kilo * meters),
+                                             quantity<plane_angle> (53 * degree::degree), 12, 20,
+                                             1);
+
+    NodeContainer nodes;
+    nodes.Create (12 * 20);
+    icarusHelper.Install (nodes, constellationHelper);
+    m_constellation = constellationHelper.GetConstellation ();
+    m_constellation->SetIndexMaxAge (m_indexMaxAge);
+    m_constellation->SetQueryMode (m_mode);
+
+    for (const auto t : {0.0, 0.25, 0.9, 1.2, 7.5, 60.0, 61.0, 3000.0})
+      {
+        Simulator::Schedule (Seconds (t), &ClosestSatelliteTest::Check, this);
+      }
+
+    Simulator::Run ();
+    Simulator::Destroy ();
+    m_constellation = nullptr;
+  }
+};
+
+class FootprintGridTest : public TestCase
+{
+public:
+  explicit FootprintGridTest (double cellSize)
+      : TestCase ("Check the footprint grid queries against a full scan"), m_cellSize (cellSize)
+  {
+  }
+  virtual ~FootprintGridTest () = default;
+
+private:
+  const double m_cellSize;
+
+  static Vector
+  getPosition (double latitude, double longitude, double length)
+  {
+    return Vector (length * std::cos (latitude) * std::cos (longitude),
+                   length * std::cos (latitude) * std::sin (longitude),
+                   length * std::sin (latitude));
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    const auto degree = M_PI / 180;
+    const auto radius = ::icarus::satpos::planet::constants::Earth.getRadius ().value ();
+
+    // Stations every 3º, and at slightly different heights, including both poles
+    std::vector<Vector> stations;
+    for (auto latitude = -90; latitude <= 90; latitude += 3)
+      {
+        for (auto longitude = -180; longitude < 180; longitude += 3)
+          {
+            const auto height = 10.0 * (stations.size () % 7);
+            stations.push_back (
+                getPosition (latitude * degree, longitude * degree, radius + height));
+          }
+      }
+
+    FootprintGrid grid (m_cellSize);
+    grid.build (stations);
+    NS_TEST_ASSERT_MSG_EQ (grid.size (), stations.size (), "Every station must be indexed");
+
+    // Around the antimeridian, near and over the poles and with caps of every size
+    const double queries[][3] = {{0, 0, 20},    {10, 179, 15},  {-35, -178, 30}, {85, 40, 10},
+                                 {-88, 0, 5},   {90, 0, 25},    {60, 90, 40},    {0, 100, 95},
+                                 {20, -60, 0.5}, {-45, 170, 180}};
+    for (const auto &query : queries)
+      {
+        const auto direction = getPosition (query[0] * degree, query[1] * degree, 1.0);
+        const auto angle = query[2] * degree;
+
+        std::vector<std::size_t> result;
+        grid.withinAngle (direction, angle, result);
+
+        std::vector<std::size_t> expected;
+        for (std::size_t i = 0; i < stations.size (); i++)
+          {
+            const auto &station = stations[i];
+            if ((station.x * direction.x + station.y * direction.y + station.z * direction.z) /
+                    station.GetLength () >=
+                std::cos (angle))
+              {
+                expected.push_back (i);
+              }
+          }
+
+        NS_TEST_ASSERT_MSG_EQ (result.size (), expected.size (),
+                               "Wrong number of stations around (" << query[0] << ", " << query[1]
+                                                                   << ")");
+        NS_TEST_ASSERT_MSG_EQ (std::equal (result.cbegin (), result.cend (), expected.cbegin ()),
+                               true, "Wrong stations around (" << query[0] << ", " << query[1]
+                                                               << ")");
+      }
+  }
+};
+
+class IslGeometryTest : public TestCase
+{
+public:
+  IslGeometryTest (double inclination, double ascendingNode, double phase)
+      : TestCase ("Check the closed form ISL distance and its crossings against the orbits"),
+        m_inclination (inclination),
+        m_ascendingNode (ascendingNode),
+        m_phase (phase)
+  {
+  }
+  virtual ~IslGeometryTest () = default;
+
+private:
+  const double m_inclination, m_ascendingNode, m_phase;
+
+  static double
+  getDistance (const CircularOrbitMobilityModelImpl &first,
+               const CircularOrbitMobilityModelImpl &second, double t)
+  {
+    using boost::units::si::seconds;
+
+    const auto a = first.getCartesianPositionRightAscensionDeclination (t * seconds);
+    const auto b = second.getCartesianPositionRightAscensionDeclination (t * seconds);
+
+    return CalculateDistance (Vector (std::get<0> (a).value (), std::get<1> (a).value (),
+                                      std::get<2> (a).value ()),
+                              Vector (std::get<0> (b).value (), std::get<1> (b).value (),
+                                      std::get<2> (b).value ()));
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    using boost::units::si::meters;
+    using boost::units::si::radians;
+
+    const auto degree = M_PI / 180;
+    const auto radius = ::icarus::satpos::planet::constants::Earth.getRadius ().value () + 550e3;
+    const CircularOrbitMobilityModelImpl first (53 * degree * radians, 0 * radians,
+                                                radius * meters, 0 * radians);
+    const CircularOrbitMobilityModelImpl second (m_inclination * degree * radians,
+                                                 m_ascendingNode * degree * radians,
+                                                 radius * meters, m_phase * degree * radians);
+
+    const auto geometry = IslGeometry::create (first, second);
+    NS_TEST_ASSERT_MSG_EQ (geometry.has_value (), true, "Orbits in the same shell");
+
+    const auto period = first.getOrbitalPeriod ().value ();
+    auto shortest = 2 * radius, longest = 0.0;
+    for (auto t = 0.0; t < period; t += period / 50)
+      {
+        const auto distance = getDistance (first, second, t);
+        NS_TEST_ASSERT_MSG_EQ_TOL (geometry->getDistance (t), distance, 1e-3,
+                                   "Wrong distance at " << t << " s");
+        shortest = std::min (shortest, distance);
+        longest = std::max (longest, distance);
+      }
+
+    if (longest - shortest < 1)
+      {
+        // Satellites of the same plane stay at a constant distance
+        NS_TEST_ASSERT_MSG_EQ (geometry->getNextCrossing (0, shortest + 1).has_value (), false,
+                               "A constant distance never crosses any value");
+        return;
+      }
+
+    // The link state at one second steps must only change across the predicted crossings
+    const auto threshold = (shortest + longest) / 2;
+    auto next = geometry->getNextCrossing (0, threshold);
+    bool inRange = getDistance (first, second, 0) <= threshold;
+    for (auto t = 1.0; t < period; t += 1.0)
+      {
+        if ((getDistance (first, second, t) <= threshold) != inRange)
+          {
+            NS_TEST_ASSERT_MSG_EQ (next.has_value (), true,
+                                   "Missing crossing before " << t << " s");
+            NS_TEST_ASSERT_MSG_EQ ((*next > t - 1 && *next <= t), true,
+                                   "Crossing at " << *next << " s instead of before " << t << " s");
+            inRange = !inRange;
+            next = geometry->getNextCrossing (*next + 1e-6, threshold);
+          }
+      }
+  }
+};
+
+class GroundGeometryTest : public TestCase
+{
+public:
+  GroundGeometryTest (double inclination, double ascendingNode, double phase, double latitude,
+                      double longitude)
+      : TestCase ("Check the closed form ground distance and overtakings against the orbits"),
+        m_inclination (inclination),
+        m_ascendingNode (ascendingNode),
+        m_phase (phase),
+        m_latitude (latitude),
+        m_longitude (longitude)
+  {
+  }
+  virtual ~GroundGeometryTest () = default;
+
+private:
+  const double m_inclination, m_ascendingNode, m_phase, m_latitude, m_longitude;
+
+  static Vector
+  getPosition (const CircularOrbitMobilityModelImpl &orbit, double t)
+  {
+    using boost::units::si::seconds;
+
+    const auto raw = orbit.getCartesianPositionRightAscensionDeclination (t * seconds);
+
+    return CircularOrbitMobilityModel::toEarthFixed (
+        Vector (std::get<0> (raw).value (), std::get<1> (raw).value (), std::get<2> (raw).value ()),
+        Seconds (t));
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    using boost::units::si::meters;
+    using boost::units::si::radians;
+
+    const auto degree = M_PI / 180;
+    const auto radius = ::icarus::satpos::planet::constants::Earth.getRadius ().value () + 550e3;
+    const CircularOrbitMobilityModelImpl first (53 * degree * radians, 0 * radians,
+                                                radius * meters, 0 * radians);
+    const CircularOrbitMobilityModelImpl second (m_inclination * degree * radians,
+                                                 m_ascendingNode * degree * radians,
+                                                 radius * meters, m_phase * degree * radians);
+    const Vector ground (6371e3 * std::cos (m_latitude * degree) * std::cos (m_longitude * degree),
+                         6371e3 * std::cos (m_latitude * degree) * std::sin (m_longitude * degree),
+                         6371e3 * std::sin (m_latitude * degree));
+
+    const auto fixedRadius = getPosition (first, 0).GetLength ();
+    const GroundGeometry near (first, fixedRadius, ground);
+    const GroundGeometry far (second, fixedRadius, ground);
+
+    const auto period = first.getOrbitalPeriod ().value ();
+    for (auto t = 0.0; t < period; t += period / 50)
+      {
+        const auto distance = CalculateDistance (getPosition (first, t), ground);
+        NS_TEST_ASSERT_MSG_EQ_TOL (std::sqrt (near.getSquaredDistance (t)), distance, 1e-3,
+                                   "Wrong distance at " << t << " s");
+      }
+
+    // Brute force the overtakings with a fine scan over one period
+    const auto step = 0.05;
+    const auto closer = [&] (double t) {
+      return CalculateDistance (getPosition (first, t), ground) <=
+             CalculateDistance (getPosition (second, t), ground);
+    };
+    auto start = 0.0;
+    while (start < period && !closer (start))
+      {
+        start += step;
+      }
+    NS_TEST_ASSERT_MSG_EQ ((start < period), true, "The first satellite is never the closest");
+
+    auto crossing = start;
+    while (crossing < start + period && closer (crossing))
+      {
+        crossing += step;
+      }
+    NS_TEST_ASSERT_MSG_EQ ((crossing < start + period), true, "The second one is never closer");
+
+    const auto next = near.getNextOvertaking (far, start, start + period, 1e-6);
+    NS_TEST_ASSERT_MSG_EQ (next.has_value (), true, "Missing overtaking before " << crossing);
+    NS_TEST_ASSERT_MSG_EQ ((*next > crossing - step - 1e-3 && *next <= crossing + 1e-3), true,
+                           "Overtaking at " << *next << " s instead of before " << crossing
+                                            << " s");
+
+    // Nothing is found before it
+    const auto early = near.getNextOvertaking (far, start, crossing - step - 1e-3, 1e-6);
+    NS_TEST_ASSERT_MSG_EQ (early.has_value (), false, "Overtaking found too early");
+  }
+};
+
+class Sat2SatLinkPredictionTest : public TestCase
+{
+public:
+  Sat2SatLinkPredictionTest ()
+      : TestCase ("Check the predicted ISL state and its notifications against the distances")
+  {
+  }
+  virtual ~Sat2SatLinkPredictionTest () = default;
+
+private:
+  struct Sample
+  {
+    Time time;
+    bool predicted;
+    bool inRange;
+  };
+
+  Ptr<SatNetDevice> m_devices[2];
+  Ptr<Sat2SatSuccessModel> m_successModel;
+  std::vector<std::pair<Time, bool>> m_changes[2];
+  std::vector<Sample> m_samples;
+
+  void
+  RecordChange (std::size_t device)
+  {
+    m_changes[device].emplace_back (Simulator::Now (), m_devices[device]->IsLinkUp ());
+  }
+  void
+  FirstLinkChange ()
+  {
+    RecordChange (0);
+  }
+  void
+  SecondLinkChange ()
+  {
+    RecordChange (1);
+  }
+
+  // Compare the predicted state with the one of the success model for the Earth fixed positions
+  void
+  Check ()
+  {
+    m_samples.push_back ({Simulator::Now (), m_devices[0]->IsLinkUp (),
+                          m_successModel->TramsmitSuccess (m_devices[0]->GetNode (),
+                                                           m_devices[1]->GetNode (), nullptr)});
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    using namespace boost::units;
+    using namespace boost::units::si;
+    using boost::units::si::kilo_type;
+
+    IcarusHelper icarusHelper;
+    ISLHelper islHelper;
+    // Two planes with one satellite each, half an orbit apart, so that they get in range only
+    // around the crossings of the orbits
+    ConstellationHelper constellationHelper (quantity<length> (550 * kilo * meters),
+                                             quantity<plane_angle> (53 * degree::degree), 2, 1, 1);
+
+    NodeContainer nodes;
+    nodes.Create (2);
+    icarusHelper.Install (nodes, constellationHelper);
+    islHelper.SetChannelAttribute ("PredictLinkState", BooleanValue (true));
+    const auto devices = islHelper.Install (nodes.Get (0), nodes.Get (1));
+    for (std::size_t i = 0; i < 2; i++)
+      {
+        m_devices[i] = DynamicCast<SatNetDevice> (devices.Get (i));
+      }
+    m_devices[0]->AddLinkChangeCallback (
+        MakeCallback (&Sat2SatLinkPredictionTest::FirstLinkChange, this));
+    m_devices[1]->AddLinkChangeCallback (
+        MakeCallback (&Sat2SatLinkPredictionTest::SecondLinkChange, this));
+
+    PointerValue successModel;
+    m_devices[0]->GetChannel ()->GetAttribute ("TxSuccess", successModel);
+    m_successModel = successModel.Get<Sat2SatSuccessModel> ();
+
+    // A little more than an orbital period
+    const auto end = Seconds (6000);
+    for (auto t = Seconds (0); t < end; t += Seconds (1))
+      {
+        Simulator::Schedule (t, &Sat2SatLinkPredictionTest::Check, this);
+      }
+    Simulator::Stop (end);
+    Simulator::Run ();
+    Simulator::Destroy ();
+
+    NS_TEST_ASSERT_MSG_EQ ((m_changes[0] == m_changes[1]), true,
+                           "Both devices must be notified of the same changes");
+    NS_TEST_ASSERT_MSG_EQ ((m_changes[0].size () >= 4), true, "The link must go up and down");
+    for (std::size_t i = 0; i < m_changes[0].size (); i++)
+      {
+        // The link starts up, so the first change takes it down
+        NS_TEST_ASSERT_MSG_EQ (m_changes[0][i].second, (i % 2 == 1),
+                               "Change " << i << " at " << m_changes[0][i].first
+                                         << " does not toggle the link");
+      }
+
+    // Away from the changes, the predicted state must agree with the distance between the
+    // satellites. An error in the Earth fixed scale would move the changes by several seconds.
+    for (const auto &sample : m_samples)
+      {
+        const auto nearChange = std::any_of (
+            m_changes[0].begin (), m_changes[0].end (), [&sample] (const std::pair<Time, bool> &c) {
+              return Abs (c.first - sample.time) <= Seconds (1);
+            });
+        if (!nearChange)
+          {
+            NS_TEST_ASSERT_MSG_EQ (sample.predicted, sample.inRange,
+                                   "Wrong link state at " << sample.time);
+          }
+      }
+
+    m_devices[0] = m_devices[1] = nullptr;
+    m_successModel = nullptr;
+  }
+};
+
+class IslCutThroughTest : public TestCase
+{
+public:
+  IslCutThroughTest (bool useFabric)
+      : TestCase ("Check that cut-through ISL receptions match the regular ones"),
+        m_useFabric (useFabric)
+  {
+  }
+  virtual ~IslCutThroughTest () = default;
+
+private:
+  // (whether it is PhyRxEnd, index of the transmission)
+  using Trace = std::pair<bool, std::size_t>;
+  // (time, index of the transmission)
+  using Delivery = std::pair<Time, std::size_t>;
+
+  const bool m_useFabric;
+  std::vector<uint64_t> m_sent;
+  std::vector<Trace> m_traces;
+  std::vector<Delivery> m_deliveries;
+
+  std::size_t
+  GetIndex (uint64_t uid) const
+  {
+    return std::find (m_sent.cbegin (), m_sent.cend (), uid) - m_sent.cbegin ();
+  }
+
+  void
+  PhyRxBegin (Ptr<const Packet> packet)
+  {
+    m_traces.emplace_back (false, GetIndex (packet->GetUid ()));
+  }
+
+  void
+  PhyRxEnd (Ptr<const Packet> packet)
+  {
+    m_traces.emplace_back (true, GetIndex (packet->GetUid ()));
+  }
+
+  bool
+  Receive (Ptr<NetDevice>, Ptr<const Packet> packet, uint16_t, const Address &)
+  {
+    m_deliveries.emplace_back (Simulator::Now (), GetIndex (packet->GetUid ()));
+
+    return true;
+  }
+
+  void
+  Send (Ptr<SatNetDevice> device, uint32_t size)
+  {
+    const auto packet = Create<Packet> (size);
+    m_sent.push_back (packet->GetUid ());
+    device->Send (packet, device->GetBroadcast (), 0);
+  }
+
+  // Returns the number of events run
+  uint64_t
+  Run (bool cutThrough, std::vector<Trace> &traces, std::vector<Delivery> &deliveries)
+  {
+    using namespace boost::units;
+    using namespace boost::units::si;
+    using boost::units::si::kilo_type;
+
+    IcarusHelper icarusHelper;
+    ISLHelper islHelper;
+    // Neighbours in a plane of ten satellites are always within range
+    ConstellationHelper constellationHelper (quantity<length> (550 * kilo * meters),
+                                             quantity<plane_angle> (53 * degree::degree), 1, 10,
+                                             0);
+
+    NodeContainer nodes;
+    nodes.Create (10);
+    icarusHelper.Install (nodes, constellationHelper);
+    islHelper.SetUseFabric (m_useFabric);
+    const auto devices = islHelper.Install (nodes, constellationHelper);
+    const auto src = DynamicCast<SatNetDevice> (devices.Get (0));
+    const auto dst = DynamicCast<SatNetDevice> (devices.Get (1));
+    src->GetChannel ()->SetAttribute ("CutThrough", BooleanValue (cutThrough));
+    dst->TraceConnectWithoutContext ("PhyRxBegin",
+                                     MakeCallback (&IslCutThroughTest::PhyRxBegin, this));
+    dst->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&IslCutThroughTest::PhyRxEnd, this));
+    dst->SetReceiveCallback (MakeCallback (&IslCutThroughTest::Receive, this));
+
+    // Frames sent back to back would start to be received at the very end of the previous one,
+    // so leave some time between them for PhyRxBegin and PhyRxEnd to keep their order
+    Simulator::Schedule (Seconds (1), &IslCutThroughTest::Send, this, src, 1500);
+    Simulator::Schedule (Seconds (1.001), &IslCutThroughTest::Send, this, src, 500);
+    Simulator::Schedule (Seconds (1.002), &IslCutThroughTest::Send, this, src, 1000);
+    Simulator::Stop (Seconds (2));
+    Simulator::Run ();
+    const auto events = Simulator::GetEventCount ();
+    Simulator::Destroy ();
+
+    traces.swap (m_traces);
+    deliveries.swap (m_deliveries);
+    m_sent.clear ();
+
+    return events;
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    std::vector<Trace> regularTraces, cutThroughTraces;
+    std::vector<Delivery> regular, cutThrough;
+    const auto regularEvents = Run (false, regularTraces, regular);
+    const auto cutThroughEvents = Run (true, cutThroughTraces, cutThrough);
+
+    NS_TEST_ASSERT_MSG_EQ (regular.size (), 3u, "Every frame must be received");
+    NS_TEST_EXPECT_MSG_EQ ((cutThrough == regular), true, "Frames must be received at their end");
+    NS_TEST_EXPECT_MSG_EQ ((cutThroughTraces == regularTraces), true,
+                           "PhyRxBegin and PhyRxEnd must fire in the same order");
+    // A single event per hop, instead of one at the start of the reception and another one at
+    // its end
+    NS_TEST_EXPECT_MSG_EQ (regularEvents - cutThroughEvents, regular.size (),
+                           "Cut-through must save one event per reception");
+  }
+};
+
 class ISLGridTestCase1 : public TestCase
 {
 public:
   ISLGridTestCase1 (std::size_t n_planes, std::size_t n_satellites_per_plane,
-                    std::size_t expected_links);
+                    std::size_t expected_links, bool use_fabric = false);
   virtual ~ISLGridTestCase1 () override = default;
 
 private:
   const std::size_t m_NPlanes;
   const std::size_t m_NSatellitesPerPlane;
   const std::size_t m_NExpectedLinks;
+  const bool m_UseFabric;
 
   virtual void DoRun (void) override;
 };
 
 namespace {
 std::string
-GetTestName (std::size_t planes, std::size_t plane_size) noexcept
+GetTestName (std::size_t planes, std::size_t plane_size, bool fabric) noexcept
 {
   std::ostringstream name ("Check ISL grid link formation: ");
-  name << planes << "×" << plane_size;
+  name << planes << "×" << plane_size << (fabric ? " (fabric)" : "");
 
   return name.str ();
 }
 } // namespace
 
 ISLGridTestCase1::ISLGridTestCase1 (std::size_t n_planes, std::size_t n_satellites_per_plane,
-                                    std::size_t expected_links)
-    : TestCase (GetTestName (n_planes, n_satellites_per_plane)),
+                                    std::size_t expected_links, bool use_fabric)
+    : TestCase (GetTestName (n_planes, n_satellites_per_plane, use_fabric)),
       m_NPlanes (n_planes),
       m_NSatellitesPerPlane (n_satellites_per_plane),
-      m_NExpectedLinks (expected_links)
+      m_NExpectedLinks (expected_links),
+      m_UseFabric (use_fabric)
 {
 }
 
@@ -192,6 +1930,7 @@ ISLGridTestCase1::DoRun (void)
   NodeContainer nodes;
   nodes.Create (m_NPlanes * m_NSatellitesPerPlane);
   icarusHelper.Install (nodes, constellationHelper);
+  islHelper.SetUseFabric (m_UseFabric);
   islHelper.Install (nodes, constellationHelper);
   const auto &constellation = constellationHelper.GetConstellation ();
 
@@ -202,6 +1941,17 @@ ISLGridTestCase1::DoRun (void)
           const auto sat = constellation->GetSatellite (plane, index);
           const auto nlinks = sat->GetNode ()->GetNDevices ();
           NS_TEST_ASSERT_MSG_EQ (nlinks, m_NExpectedLinks, "Number of links is wrong!");
+
+          // Device 0 is the one towards the ground
+          for (std::size_t i = 1; i < nlinks; i++)
+            {
+              const auto device = DynamicCast<SatNetDevice> (sat->GetNode ()->GetDevice (i));
+              NS_TEST_ASSERT_MSG_EQ (device->IsLinkUp (), true, "Links must be up");
+              NS_TEST_ASSERT_MSG_EQ (device->GetRemoteDevice ()->GetRemoteDevice (), device,
+                                     "Links must be symmetric");
+              NS_TEST_ASSERT_MSG_NE (device->GetRemoteDevice ()->GetNode (), sat->GetNode (),
+                                     "Satellites cannot be linked to themselves");
+            }
         }
     }
 
@@ -210,6 +1960,61 @@ ISLGridTestCase1::DoRun (void)
   ns3::Simulator::Run ();
 }
 
+class DownlinkSchedulerTest : public TestCase
+{
+public:
+  DownlinkSchedulerTest () : TestCase ("Check the order of the downlink schedulers")
+  {
+  }
+  virtual ~DownlinkSchedulerTest () = default;
+
+private:
+  // Fill a queue per entry of sizes, and return the queue of every packet in the order served
+  static std::vector<std::size_t>
+  Serve (const Ptr<DownlinkScheduler> &scheduler,
+         const std::vector<std::vector<uint32_t>> &sizes)
+  {
+    std::vector<Ptr<Queue<Packet>>> queues;
+    std::size_t nPackets = 0;
+    for (const auto &queueSizes : sizes)
+      {
+        queues.push_back (CreateObject<DropTailQueue<Packet>> ());
+        for (const auto size : queueSizes)
+          {
+            queues.back ()->Enqueue (Create<Packet> (size));
+            nPackets++;
+          }
+      }
+
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < nPackets; i++)
+      {
+        order.push_back (scheduler->Select (queues));
+        queues[order.back ()]->Dequeue ();
+      }
+
+    return order;
+  }
+
+  virtual void
+  DoRun (void)
+  {
+    const auto roundRobin =
+        Serve (CreateObject<RoundRobinDownlinkScheduler> (), {{100, 100, 100}, {100}, {100, 100}});
+    const std::vector<std::size_t> expectedRoundRobin{0, 1, 2, 0, 2, 0};
+    NS_TEST_ASSERT_MSG_EQ ((roundRobin == expectedRoundRobin), true,
+                           "Round robin must take one packet of every queue in turn");
+
+    // Half sized packets get served twice as often
+    const auto drr = CreateObject<DrrDownlinkScheduler> ();
+    drr->SetAttribute ("Quantum", UintegerValue (1000));
+    const auto deficit = Serve (drr, {{1000, 1000, 1000}, {500, 500, 500, 500}});
+    const std::vector<std::size_t> expectedDeficit{0, 1, 1, 0, 1, 1, 0};
+    NS_TEST_ASSERT_MSG_EQ ((deficit == expectedDeficit), true,
+                           "Deficit round robin must share the bytes evenly");
+  }
+};
+
 class FindNextPassTest : public TestCase
 {
   using length = boost::units::quantity<boost::units::si::length>;
@@ -283,6 +2088,7 @@ IcarusTestSuite::IcarusTestSuite () : TestSuite ("icarus", UNIT)
                TestCase::QUICK);
 
   AddTestCase (new CircularOrbitTestCase1, TestCase::QUICK);
+  AddTestCase (new DownlinkSchedulerTest, TestCase::QUICK);
   AddTestCase (new CircularOrbitElevationTest (quantity<length> (400 * kilo * meter),
                                                quantity<plane_angle> (10 * degrees),
                                                1439415 * meter),
@@ -303,6 +2109,57 @@ IcarusTestSuite::IcarusTestSuite () : TestSuite ("icarus", UNIT)
                                                quantity<plane_angle> (90 * degrees),
                                                400000 * meter),
                TestCase::QUICK);
+  AddTestCase (new EarthFixedPositionTest (quantity<length> (250 * kilo * meter),
+                                           quantity<plane_angle> (60 * degrees),
+                                           0 * boost::units::si::radians,
+                                           0 * boost::units::si::radians),
+               TestCase::QUICK);
+  AddTestCase (new EarthFixedPositionTest (quantity<length> (550 * kilo * meter),
+                                           quantity<plane_angle> (53 * degrees),
+                                           quantity<plane_angle> (135 * degrees),
+                                           quantity<plane_angle> (20 * degrees)),
+               TestCase::QUICK);
+  AddTestCase (new EarthFixedPositionTest (quantity<length> (1200 * kilo * meter),
+                                           quantity<plane_angle> (98 * degrees),
+                                           quantity<plane_angle> (300 * degrees),
+                                           quantity<plane_angle> (250 * degrees)),
+               TestCase::QUICK);
+  AddTestCase (new PassesTest (quantity<length> (400 * kilo * meter),
+                               quantity<plane_angle> (45 * degrees),
+                               quantity<plane_angle> (30 * degrees),
+                               quantity<plane_angle> (0 * degrees)),
+               TestCase::QUICK);
+  AddTestCase (new PassesTest (quantity<length> (800 * kilo * meter),
+                               quantity<plane_angle> (98 * degrees),
+                               quantity<plane_angle> (-60 * degrees),
+                               quantity<plane_angle> (120 * degrees)),
+               TestCase::QUICK);
+  AddTestCase (new ContactPlanTest, TestCase::QUICK);
+  AddTestCase (new HandoverSchedulerTest, TestCase::QUICK);
+  AddTestCase (new DownlinkTrackingTest (false), TestCase::QUICK);
+  AddTestCase (new DownlinkTrackingTest (true), TestCase::QUICK);
+  AddTestCase (new DownlinkDeliveryTest (false, MicroSeconds (1)), TestCase::QUICK);
+  AddTestCase (new DownlinkDeliveryTest (true, Seconds (0)), TestCase::QUICK);
+  AddTestCase (new DownlinkDeliveryTest (true, MilliSeconds (1)), TestCase::QUICK);
+  AddTestCase (new DownlinkDeliveryTest (true, MilliSeconds (100)), TestCase::QUICK);
+  AddTestCase (new DownlinkDisposeTest, TestCase::QUICK);
+  AddTestCase (new DownlinkCutThroughTest, TestCase::QUICK);
+  AddTestCase (new LinkStateCacheTest, TestCase::QUICK);
+  AddTestCase (new DownlinkNdnSchedulerTest, TestCase::QUICK);
+  AddTestCase (new ClosestSatelliteTest (Seconds (0), Constellation::INDEX), TestCase::QUICK);
+  AddTestCase (new ClosestSatelliteTest (Seconds (100), Constellation::INDEX), TestCase::QUICK);
+  AddTestCase (new ClosestSatelliteTest (Seconds (1), Constellation::WALKER), TestCase::QUICK);
+  AddTestCase (new FootprintGridTest (0.035), TestCase::QUICK);
+  AddTestCase (new FootprintGridTest (0.3), TestCase::QUICK);
+  AddTestCase (new IslGeometryTest (53, 0, 30), TestCase::QUICK);
+  AddTestCase (new IslGeometryTest (53, 20, 10), TestCase::QUICK);
+  AddTestCase (new IslGeometryTest (87, 120, 200), TestCase::QUICK);
+  AddTestCase (new GroundGeometryTest (53, 0, 20, 40, 10), TestCase::QUICK);
+  AddTestCase (new GroundGeometryTest (53, 30, 10, 20, -30), TestCase::QUICK);
+  AddTestCase (new GroundGeometryTest (87, 120, 200, -60, 100), TestCase::QUICK);
+  AddTestCase (new Sat2SatLinkPredictionTest, TestCase::QUICK);
+  AddTestCase (new IslCutThroughTest (false), TestCase::QUICK);
+  AddTestCase (new IslCutThroughTest (true), TestCase::QUICK);
   AddTestCase (new ISLGridTestCase1 (6, 20, 5), TestCase::QUICK);
   AddTestCase (new ISLGridTestCase1 (1, 1, 1), TestCase::QUICK);
   AddTestCase (new ISLGridTestCase1 (1, 2, 2), TestCase::QUICK);
@@ -310,6 +2167,9 @@ IcarusTestSuite::IcarusTestSuite () : TestSuite ("icarus", UNIT)
   AddTestCase (new ISLGridTestCase1 (2, 2, 3), TestCase::QUICK);
   AddTestCase (new ISLGridTestCase1 (3, 2, 4), TestCase::QUICK);
   AddTestCase (new ISLGridTestCase1 (2, 3, 4), TestCase::QUICK);
+  AddTestCase (new ISLGridTestCase1 (6, 20, 5, true), TestCase::QUICK);
+  AddTestCase (new ISLGridTestCase1 (2, 2, 3, true), TestCase::QUICK);
+  AddTestCase (new ISLGridTestCase1 (3, 2, 4, true), TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite